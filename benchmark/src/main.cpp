@@ -0,0 +1,1237 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <SemanticAnalyzer.h>
+#include "Lexer.h"
+#include "Scanner.h"
+#include "Parser.h"
+#include "Interpreter.h"
+#include "Optimizer.h"
+#include "Vm/BytecodeCompiler.h"
+#include "Vm/VirtualMachine.h"
+#include "FunctionRegistry.h"
+#include "FunctionLoader.h"
+
+// Number of heap allocations and allocated bytes of the whole process, see the global operator new below
+static size_t allocations = 0;
+static size_t allocatedBytes = 0;
+
+void* operator new(size_t size)
+{
+	allocations++;
+	allocatedBytes += size;
+
+	if (void* pointer = std::malloc(size == 0 ? 1 : size))
+	{
+		return pointer;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	std::free(pointer);
+}
+
+// Measured values of all benchmarks, written as JSON with --json=<file> to compare releases
+struct Result
+{
+	std::string benchmark;
+	std::string metric;
+	double value;
+	std::string unit;
+};
+
+static std::vector<Result> results;
+
+static void Record(const std::string& benchmark, const std::string& metric, double value, const char* unit)
+{
+	results.push_back({ benchmark, metric, value, unit });
+}
+
+static double Milliseconds(std::chrono::high_resolution_clock::time_point start, std::chrono::high_resolution_clock::time_point end)
+{
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Walks the whole ast and counts the visited nodes. Children are plain pointers into
+// the arena of the parse result, so descending must not touch the heap at all.
+class TraversalCounter : public Visitor
+{
+private:
+	size_t nodes = 0;
+
+	void Descend(Node* child)
+	{
+		child->Accept(*this);
+	}
+
+	void Descend(const NodeList<Node*>& children)
+	{
+		for (Node* child : children)
+		{
+			Descend(child);
+		}
+	}
+public:
+	explicit TraversalCounter(const Ref<Node>& astRoot)
+		: Visitor(astRoot)
+	{
+
+	}
+
+	size_t GetNodes() const
+	{
+		return nodes;
+	}
+
+	void Count()
+	{
+		this->astRoot->Accept(*this);
+	}
+
+	void Visit(MainNode& n) override { nodes++; Descend(n.GetGlobalVariables()); Descend(n.GetGlobalFunctions()); }
+	void Visit(VariableDeclarationAssignNode& n) override { nodes++; Descend(n.GetExpression()); }
+	void Visit(VariableArrayDeclarationAssignNode& n) override { nodes++; Descend(n.GetValues()); }
+	void Visit(FunctionNode& n) override { nodes++; Descend(n.GetBlock()); }
+	void Visit(FunctionCallNode& n) override { nodes++; Descend(n.GetParameters()); }
+	void Visit(ForEachNode& n) override { nodes++; Descend(n.GetExpression()); Descend(n.GetBlock()); }
+	void Visit(ForINode& n) override { nodes++; Descend(n.GetBlock()); }
+	void Visit(BlockNode& n) override { nodes++; Descend(n.GetStatements()); }
+	void Visit(BinaryNode& n) override { nodes++; Descend(n.GetLeft()); Descend(n.GetRight()); }
+	void Visit(BooleanNode& n) override { nodes++; Descend(n.GetLeft()); Descend(n.GetRight()); }
+	void Visit(WhileNode& n) override { nodes++; Descend(n.GetExpression()); Descend(n.GetBlock()); }
+	void Visit(DoWhileNode& n) override { nodes++; Descend(n.GetBlock()); Descend(n.GetExpression()); }
+	void Visit(ReturnNode& n) override { nodes++; Descend(n.GetExpression()); }
+	void Visit(StringNode& n) override { nodes++; Descend(n.GetExpressions()); }
+	void Visit(IntNode&) override { nodes++; }
+	void Visit(FloatNode&) override { nodes++; }
+	void Visit(LongNode&) override { nodes++; }
+	void Visit(DoubleNode&) override { nodes++; }
+	void Visit(BoolNode&) override { nodes++; }
+	void Visit(VariableUsageNode&) override { nodes++; }
+	void Visit(VariableAssignNode& n) override { nodes++; Descend(n.GetExpression()); }
+	void Visit(VariableArrayUsageNode&) override { nodes++; }
+	void Visit(VariableArrayAssignNode& n) override { nodes++; Descend(n.GetExpression()); }
+	void Visit(VariableIncrementDecrementNode&) override { nodes++; }
+	void Visit(VariableCompoundAssignNode& n) override { nodes++; Descend(n.GetExpression()); }
+
+	void Visit(IfNode& n) override
+	{
+		nodes++;
+		Descend(n.GetExpression());
+		Descend(n.GetTrueBlock());
+
+		for (const auto& [expression, block] : n.GetElseIfBlocks())
+		{
+			Descend(expression);
+			Descend(block);
+		}
+
+		if (n.GetElseBlock() != nullptr)
+		{
+			Descend(n.GetElseBlock());
+		}
+	}
+};
+
+// Interprets like the tree walker and counts the allocations of every node type without the ones
+// of its children. These are the allocations of its own Visit and of dispatching to its children.
+class DispatchCounter : public Interpreter
+{
+public:
+	enum NodeType
+	{
+		Main,
+		VariableDeclarationAssign,
+		VariableArrayDeclarationAssign,
+		Function,
+		FunctionCall,
+		ForEach,
+		ForI,
+		Block,
+		Binary,
+		Boolean,
+		If,
+		While,
+		DoWhile,
+		Return,
+		String,
+		Int,
+		Float,
+		Long,
+		Double,
+		Bool,
+		VariableUsage,
+		VariableAssign,
+		VariableArrayUsage,
+		VariableArrayAssign,
+		VariableIncrementDecrement,
+		VariableCompoundAssign,
+		NodeTypes
+	};
+
+	static constexpr const char* Names[NodeTypes] = {
+		"MainNode", "VariableDeclarationAssignNode", "VariableArrayDeclarationAssignNode", "FunctionNode",
+		"FunctionCallNode", "ForEachNode", "ForINode", "BlockNode",
+		"BinaryNode", "BooleanNode", "IfNode", "WhileNode",
+		"DoWhileNode", "ReturnNode", "StringNode", "IntNode",
+		"FloatNode", "LongNode", "DoubleNode", "BoolNode",
+		"VariableUsageNode", "VariableAssignNode", "VariableArrayUsageNode", "VariableArrayAssignNode",
+		"VariableIncrementDecrementNode", "VariableCompoundAssignNode"
+	};
+private:
+	size_t allocated[NodeTypes] = { };
+	std::vector<NodeType> visiting;
+	size_t segmentStart = 0;
+
+	// The allocations since the last node was entered or left belong to the node visited at that time
+	template <typename T>
+	void Measure(NodeType type, T& n)
+	{
+		if (!this->visiting.empty())
+		{
+			this->allocated[this->visiting.back()] += allocations - this->segmentStart;
+		}
+
+		this->visiting.push_back(type);
+		this->segmentStart = allocations;
+
+		Interpreter::Visit(n);
+
+		this->allocated[this->visiting.back()] += allocations - this->segmentStart;
+		this->visiting.pop_back();
+		this->segmentStart = allocations;
+	}
+public:
+	DispatchCounter(const std::vector<std::string>& args, const Ref<Node>& astRoot)
+		: Interpreter(args, astRoot)
+	{
+		// Growing the stack of visited nodes would be counted as well
+		this->visiting.reserve(1 << 16);
+	}
+
+	static bool CreatesValues(NodeType type)
+	{
+		return type == VariableArrayDeclarationAssign || type == String || type == Function || type == FunctionCall;
+	}
+
+	size_t GetAllocated(NodeType type) const
+	{
+		return this->allocated[type];
+	}
+
+	void Visit(MainNode& n) override { Measure(Main, n); }
+	void Visit(VariableDeclarationAssignNode& n) override { Measure(VariableDeclarationAssign, n); }
+	void Visit(VariableArrayDeclarationAssignNode& n) override { Measure(VariableArrayDeclarationAssign, n); }
+	void Visit(FunctionNode& n) override { Measure(Function, n); }
+	void Visit(FunctionCallNode& n) override { Measure(FunctionCall, n); }
+	void Visit(ForEachNode& n) override { Measure(ForEach, n); }
+	void Visit(ForINode& n) override { Measure(ForI, n); }
+	void Visit(BlockNode& n) override { Measure(Block, n); }
+	void Visit(BinaryNode& n) override { Measure(Binary, n); }
+	void Visit(BooleanNode& n) override { Measure(Boolean, n); }
+	void Visit(IfNode& n) override { Measure(If, n); }
+	void Visit(WhileNode& n) override { Measure(While, n); }
+	void Visit(DoWhileNode& n) override { Measure(DoWhile, n); }
+	void Visit(ReturnNode& n) override { Measure(Return, n); }
+	void Visit(StringNode& n) override { Measure(String, n); }
+	void Visit(IntNode& n) override { Measure(Int, n); }
+	void Visit(FloatNode& n) override { Measure(Float, n); }
+	void Visit(LongNode& n) override { Measure(Long, n); }
+	void Visit(DoubleNode& n) override { Measure(Double, n); }
+	void Visit(BoolNode& n) override { Measure(Bool, n); }
+	void Visit(VariableUsageNode& n) override { Measure(VariableUsage, n); }
+	void Visit(VariableAssignNode& n) override { Measure(VariableAssign, n); }
+	void Visit(VariableArrayUsageNode& n) override { Measure(VariableArrayUsage, n); }
+	void Visit(VariableArrayAssignNode& n) override { Measure(VariableArrayAssign, n); }
+	void Visit(VariableIncrementDecrementNode& n) override { Measure(VariableIncrementDecrement, n); }
+	void Visit(VariableCompoundAssignNode& n) override { Measure(VariableCompoundAssign, n); }
+};
+
+// Parses and analyzes (and optionally optimizes) the source and returns how long the interpretation
+// took in milliseconds. With the virtual machine, the compilation to bytecode is not measured either.
+static double Interpret(const std::string& source, bool virtualMachine = false, bool optimize = false, bool jit = false)
+{
+	std::vector<std::string> args = { "Bench.ion" };
+
+	Lexer lexer(source, "Bench.ion");
+	Parser parser(lexer);
+
+	Ref<Node> astRoot = parser.Parse();
+
+	Ref<SemanticAnalyzer> semanticAnalyzer = std::make_shared<SemanticAnalyzer>(astRoot);
+	semanticAnalyzer->Analyze();
+
+	if (optimize)
+	{
+		Optimizer optimizer(astRoot, parser.GetArena());
+		optimizer.Optimize();
+	}
+
+	if (virtualMachine)
+	{
+		Ref<BytecodeCompiler> compiler = std::make_shared<BytecodeCompiler>(astRoot);
+		VirtualMachine vm(args, compiler->Compile());
+		vm.SetJit(jit);
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		vm.Run();
+
+		auto end = std::chrono::high_resolution_clock::now();
+
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	Ref<Interpreter> interpreter = std::make_shared<Interpreter>(args, astRoot);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	interpreter->Interpret();
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Fills every element of an int array with its own assignment statement. Each write
+// should take constant time, so the time per write has to stay flat when the array grows.
+static void ArrayFill()
+{
+	printf("Array fill\n");
+
+	double firstTimePerWrite = 0.0;
+
+	for (int size = 1000; size <= 32000; size *= 2)
+	{
+		std::string source = "func Main()\n{\n    var array = Range(" + std::to_string(size) + ")\n";
+		for (int i = 0; i < size; i++)
+		{
+			source.append("    array[").append(std::to_string(i)).append("] = ").append(std::to_string(size - i)).append("\n");
+		}
+		source.append("}\n");
+
+		double time = Interpret(source);
+		double timePerWrite = time * 1000000.0 / size;
+
+		if (firstTimePerWrite == 0.0)
+		{
+			firstTimePerWrite = timePerWrite;
+		}
+
+		printf("  %6i writes: %9.3fms (%7.1fns/write, %.2fx of smallest)\n", size, time, timePerWrite, timePerWrite / firstTimePerWrite);
+		Record("array fill", std::to_string(size) + " writes", timePerWrite, "ns/write");
+	}
+}
+
+// Reads a file with 100k lines and passes the lines through a few helper functions. The
+// arrays are shared instead of copied, so the calls should cost next to nothing compared to the read.
+static void FileLinesPassThrough()
+{
+	printf("File lines pass through\n");
+
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "iona_bench_lines.txt";
+	{
+		std::ofstream file(path);
+		for (int i = 0; i < 100000; i++)
+		{
+			file << "line number " << i << " of the benchmark file\n";
+		}
+	}
+
+	std::string read = "func Main()\n{\n    var lines = FileReadLines(\"" + path.generic_string() + "\")\n}\n";
+
+	std::string passThrough = "func Main()\n{\n    var lines = FileReadLines(\"" + path.generic_string() + "\")\n"
+		"    var count = 0\n"
+		"    for i in 0..1000\n"
+		"        count += Outer(lines)\n"
+		"}\n"
+		"func Outer(lines)\n{\n    return Middle(lines)\n}\n"
+		"func Middle(lines)\n{\n    return Inner(lines)\n}\n"
+		"func Inner(lines)\n{\n    var copy = lines\n    return Size(copy)\n}\n";
+
+	// Warm up the file cache
+	Interpret(read);
+
+	double readTime = Interpret(read);
+	double passThroughTime = Interpret(passThrough);
+
+	printf("  read only:           %9.3fms\n", readTime);
+	printf("  read + 3000 calls:   %9.3fms (%.1fus/call)\n", passThroughTime, (passThroughTime - readTime) * 1000.0 / 3000);
+	Record("file lines pass through", "read", readTime, "ms");
+	Record("file lines pass through", "call", (passThroughTime - readTime) * 1000.0 / 3000, "us/call");
+
+	std::filesystem::remove(path);
+}
+
+// Generates a program with roughly 25 lines per repetition, which contains every node type
+static std::string GenerateProgram(int repetitions)
+{
+	std::string source = "var total = 0\n"
+		"func Main()\n{\n";
+	for (int i = 0; i < repetitions; i++)
+	{
+		// Every repetition gets its own scope, so the variable names can be reused
+		source.append(
+			"    if true\n    {\n"
+			"        var a = 1 + 2 * 3\n"
+			"        var b = [1, 2, 3]\n"
+			"        b[0] = a - 1\n"
+			"        a = b[1] / 2\n"
+			"        a++\n"
+			"        a += Size(b)\n"
+			"        var f = 1.5\n"
+			"        var t = true\n"
+			"        var s = \"value {a}\"\n"
+			"        if a < 2\n            a = 1\n        else if a > 3\n            a = 2\n        else\n            a = 3\n"
+			"        while a < 0\n            a++\n"
+			"        do\n        {\n            a--\n        } while a < 0\n"
+			"        for x in b\n            total += x\n"
+			"        for i in 0..2\n            total += Add(i)\n"
+			"    }\n");
+	}
+	source.append("}\n"
+		"func Add(value)\n{\n    return value + 1\n}\n");
+
+	return source;
+}
+
+// Parses, walks and interprets a generated program with 50k lines. Neither the walk nor the
+// dispatch of the interpreter to the children of a node may allocate, fails if they did.
+static void Traversal()
+{
+	printf("Traversal (50k lines)\n");
+
+	std::string source = GenerateProgram(2000);
+
+	size_t allocationsBefore = allocations;
+	size_t bytesBefore = allocatedBytes;
+	auto start = std::chrono::high_resolution_clock::now();
+
+	Lexer lexer(source, "Bench.ion");
+	Parser parser(lexer);
+
+	Ref<Node> astRoot = parser.Parse();
+
+	auto end = std::chrono::high_resolution_clock::now();
+	double parseTime = std::chrono::duration<double, std::milli>(end - start).count();
+	size_t parseAllocations = allocations - allocationsBefore;
+	size_t parseBytes = allocatedBytes - bytesBefore;
+
+	SemanticAnalyzer semanticAnalyzer(astRoot);
+	semanticAnalyzer.Analyze();
+
+	TraversalCounter counter(astRoot);
+
+	allocationsBefore = allocations;
+	start = std::chrono::high_resolution_clock::now();
+
+	counter.Count();
+
+	end = std::chrono::high_resolution_clock::now();
+	double traversalTime = Milliseconds(start, end);
+	size_t traversalAllocations = allocations - allocationsBefore;
+
+	printf("  parse:     %9.3fms, %zu nodes, %zu allocations, %.1f bytes/node\n", parseTime, counter.GetNodes(),
+		parseAllocations, (double) parseBytes / counter.GetNodes());
+	printf("  traversal: %9.3fms, %zu allocations\n", traversalTime, traversalAllocations);
+
+	DispatchCounter interpreter({ "Bench.ion" }, astRoot);
+
+	start = std::chrono::high_resolution_clock::now();
+
+	interpreter.Interpret();
+
+	end = std::chrono::high_resolution_clock::now();
+	double interpretTime = Milliseconds(start, end);
+	printf("  interpret: %9.3fms\n", interpretTime);
+
+	// Arrays, strings and calls create values or call frames, all other nodes only dispatch to their children
+	for (int type = 0; type < DispatchCounter::NodeTypes; type++)
+	{
+		if (!DispatchCounter::CreatesValues((DispatchCounter::NodeType) type)
+			&& interpreter.GetAllocated((DispatchCounter::NodeType) type) > 0)
+		{
+			Exit("Bench.ion", 0, "Interpreting %s allocated %zu times, the dispatch to its children must not allocate",
+				DispatchCounter::Names[type], interpreter.GetAllocated((DispatchCounter::NodeType) type));
+		}
+	}
+
+	Record("traversal", "parse", parseTime, "ms");
+	Record("traversal", "parse allocations", (double) parseAllocations, "allocations");
+	Record("traversal", "ast size", (double) parseBytes / counter.GetNodes(), "bytes/node");
+	Record("traversal", "traversal", traversalTime, "ms");
+	Record("traversal", "traversal allocations", (double) traversalAllocations, "allocations");
+	Record("traversal", "interpret", interpretTime, "ms");
+
+	if (traversalAllocations > 0)
+	{
+		Exit("Bench.ion", 0, "Walking the ast allocated %zu times, the children must be plain pointers", traversalAllocations);
+	}
+}
+
+// Runs the same hot loops with the tree walking interpreter and the virtual machine
+static void Engines()
+{
+	printf("Engines (tree walker vs. virtual machine)\n");
+
+	std::string numericLoop =
+		"func Main()\n{\n    var s = 0\n    var f = 0.0\n    for i in 0..1000000\n    {\n"
+		"        s += i * 2 - 1\n        f += 0.5\n        if s > 100000\n            s = 0\n    }\n}\n";
+	std::string recursion =
+		"func Main()\n{\n    var r = Fib(24)\n}\n"
+		"func Fib(n)\n{\n    var r = n\n    if n > 1\n    {\n        var a = n - 1\n        var b = n - 2\n"
+		"        r = Fib(a) + Fib(b)\n    }\n    return r\n}\n";
+
+	for (const auto& [name, source] : { std::make_pair("numeric loop", numericLoop), std::make_pair("recursion", recursion) })
+	{
+		double treeTime = Interpret(source);
+		double vmTime = Interpret(source, true);
+
+		printf("  %-14s tree %9.3fms, vm %9.3fms (%.1fx)\n", name, treeTime, vmTime, treeTime / vmTime);
+		Record(std::string("engines/") + name, "tree", treeTime, "ms");
+		Record(std::string("engines/") + name, "vm", vmTime, "ms");
+	}
+}
+
+// Loop with constant expressions, a pure internal function call and a branch which is never taken
+static void ConstantFolding()
+{
+	printf("Constant folding (-O0 vs. -O1)\n");
+
+	std::string source =
+		"func Main()\n{\n    var s = 0\n    for i in 0..200000\n    {\n"
+		"        s = 60 * 60 * 24 + Size(\"constant\")\n        var name = \"io\" + \"na\"\n"
+		"        if false\n            s = 0\n    }\n}\n";
+
+	for (bool virtualMachine : { false, true })
+	{
+		double unoptimizedTime = Interpret(source, virtualMachine);
+		double optimizedTime = Interpret(source, virtualMachine, true);
+
+		printf("  %-4s -O0 %9.3fms, -O1 %9.3fms (%.1fx)\n", virtualMachine ? "vm" : "tree",
+			unoptimizedTime, optimizedTime, unoptimizedTime / optimizedTime);
+		Record(std::string("constant folding/") + (virtualMachine ? "vm" : "tree"), "-O0", unoptimizedTime, "ms");
+		Record(std::string("constant folding/") + (virtualMachine ? "vm" : "tree"), "-O1", optimizedTime, "ms");
+	}
+}
+
+// Calls internal functions with arguments of known types, which are bound to their
+// function entry and skip the parameter type checks while executing
+static void InternalCalls()
+{
+	printf("Internal calls\n");
+
+	const int iterations = 200000;
+	std::string source =
+		"func Main()\n{\n    var s = 0\n    var text = \"iona\"\n    for i in 0..200000\n    {\n"
+		"        s = Min(i, 3) + Size(text)\n        var found = Contains(text, \"on\")\n    }\n}\n";
+
+	for (bool virtualMachine : { false, true })
+	{
+		double time = Interpret(source, virtualMachine);
+
+		printf("  %-4s %9.3fms, %.1fns per call\n", virtualMachine ? "vm" : "tree", time, time * 1e6 / (iterations * 3));
+		Record("internal calls", virtualMachine ? "vm" : "tree", time * 1e6 / (iterations * 3), "ns/call");
+	}
+}
+
+// Searches a large array for values near its start. A return leaves the loop right away,
+// so the time has to be far below the one of a scan which only remembers the result.
+static void EarlyReturn()
+{
+	printf("Early return\n");
+
+	std::string search =
+		"func Find(array, value)\n{\n    for x in array\n    {\n        if x == value\n            return true\n    }\n    return false\n}\n";
+	std::string scan =
+		"func Find(array, value)\n{\n    var found = false\n    for x in array\n    {\n        if x == value\n            found = true\n    }\n"
+		"    return found\n}\n";
+	std::string main =
+		"func Main()\n{\n    var array = Range(200000)\n    for i in 0..50\n    {\n        var found = Find(array, i)\n    }\n}\n";
+
+	double scanTime = Interpret(scan + main);
+	double searchTime = Interpret(search + main);
+
+	printf("  full scan %9.3fms, early return %9.3fms (%.1fx)\n", scanTime, searchTime, scanTime / searchTime);
+	Record("early return", "full scan", scanTime, "ms");
+	Record("early return", "early return", searchTime, "ms");
+}
+
+// Sums numbers with a recursive function, once with its result returned directly and
+// once stored in a variable first. Only the first one is a tail call and reuses the frame.
+static void TailCalls()
+{
+	printf("Tail calls\n");
+
+	std::string sum =
+		"func Sum(n, acc)\n{\n    if n == 0\n        return acc\n    var m = n - 1\n    var a = acc + n\n";
+	std::string tailCall = sum + "    return Sum(m, a)\n}\n";
+	std::string call = sum + "    var r = Sum(m, a)\n    return r\n}\n";
+	std::string main = "func Main()\n{\n    for i in 0..100\n    {\n        var s = Sum(2000, 0)\n    }\n}\n";
+
+	for (bool virtualMachine : { false, true })
+	{
+		double callTime = Interpret(call + main, virtualMachine);
+		double tailCallTime = Interpret(tailCall + main, virtualMachine);
+
+		printf("  %-4s call %9.3fms, tail call %9.3fms (%.1fx)\n", virtualMachine ? "vm" : "tree",
+			callTime, tailCallTime, callTime / tailCallTime);
+		Record(std::string("tail calls/") + (virtualMachine ? "vm" : "tree"), "call", callTime, "ms");
+		Record(std::string("tail calls/") + (virtualMachine ? "vm" : "tree"), "tail call", tailCallTime, "ms");
+	}
+
+	// The arguments of a tail call call other functions, which have to return normally before the tail call runs.
+	// Both engines write their result into a file, it has to be the same.
+	std::filesystem::path resultPath = std::filesystem::temp_directory_path() / "iona_bench_tail_calls.txt";
+	std::string nested =
+		"func Next(x)\n{\n    var y = x + 1\n    return y\n}\n"
+		"func Count(n, acc)\n{\n    if n == 0\n        return acc\n    var m = n - 1\n    return Count(m, Next(acc))\n}\n"
+		"func Main()\n{\n    var total = 0\n    for i in 0..100\n    {\n        total = Count(2000, total)\n    }\n"
+		"    FileWrite(\"" + resultPath.generic_string() + "\", ToString(total))\n}\n";
+
+	std::vector<std::string> nestedResults;
+	for (bool virtualMachine : { false, true })
+	{
+		double nestedTime = Interpret(nested, virtualMachine);
+
+		std::ifstream result(resultPath);
+		nestedResults.emplace_back((std::istreambuf_iterator<char>(result)), std::istreambuf_iterator<char>());
+
+		printf("  %-4s nested tail call %9.3fms (result %s)\n", virtualMachine ? "vm" : "tree", nestedTime, nestedResults.back().c_str());
+		Record(std::string("tail calls/") + (virtualMachine ? "vm" : "tree"), "nested tail call", nestedTime, "ms");
+	}
+	std::filesystem::remove(resultPath);
+
+	if (nestedResults[0] != nestedResults[1] || nestedResults[0] != "200000")
+	{
+		throw std::runtime_error("Nested tail calls have different results in the tree walker and the virtual machine");
+	}
+}
+
+// Recursion which is not a tail call. The tree walker recurses natively and stops at its call depth
+// limit, the virtual machine keeps its frames on the heap and goes far deeper at a lower cost per call.
+static void DeepRecursion()
+{
+	printf("Deep recursion\n");
+
+	auto source = [](int depth, int repeats)
+	{
+		return "func Down(n)\n{\n    var r = 0\n    if n > 0\n    {\n        var m = n - 1\n        r = Down(m) + 1\n    }\n    return r\n}\n"
+			"func Main()\n{\n    for i in 0.." + std::to_string(repeats) + "\n    {\n        var d = Down(" + std::to_string(depth) + ")\n    }\n}\n";
+	};
+
+	double treeTime = Interpret(source(2000, 50));
+	double vmTime = Interpret(source(2000, 50), true);
+	double deepTime = Interpret(source(500000, 1), true);
+
+	printf("  depth   2000: tree %9.3fms (%.1fns/call), vm %9.3fms (%.1fns/call)\n",
+		treeTime, treeTime * 1e6 / 100000, vmTime, vmTime * 1e6 / 100000);
+	printf("  depth 500000: vm   %9.3fms (%.1fns/call)\n", deepTime, deepTime * 1e6 / 500000);
+	Record("deep recursion", "tree depth 2000", treeTime * 1e6 / 100000, "ns/call");
+	Record("deep recursion", "vm depth 2000", vmTime * 1e6 / 100000, "ns/call");
+	Record("deep recursion", "vm depth 500000", deepTime * 1e6 / 500000, "ns/call");
+}
+
+// Arithmetic on values returned by a function, whose types the semantic analyzer can not prove.
+// The operand types stay the same, so the inline caches of the nodes hit after the first iteration.
+static void InlineCaches()
+{
+	printf("Inline caches\n");
+
+	std::string source =
+		"func Id(x)\n{\n    return x\n}\n"
+		"func Main()\n{\n    var a = Id(3)\n    var f = Id(0.5)\n    var s = Id(0)\n    var t = Id(0.0)\n    for i in 0..1000000\n    {\n"
+		"        s = a * 2 - a\n        t = f * f + f\n        var up = s < a\n    }\n}\n";
+
+	double time = Interpret(source);
+
+	printf("  tree %9.3fms, %.1fns per operation\n", time, time * 1e6 / (1000000 * 5));
+	Record("inline caches", "tree", time * 1e6 / (1000000 * 5), "ns/operation");
+}
+
+// Int and float arithmetic, comparisons and array elements in a hot loop of the virtual machine,
+// once interpreted and once compiled to machine code by the jit (if the platform supports it)
+static void JitLoops()
+{
+	printf("Jit\n");
+
+	std::string source =
+		"func Main()\n{\n    var s = 0\n    var f = 0.0\n    var a = [0, 0]\n    var fa = [1.0]\n    for i in 0..1000000\n    {\n"
+		"        s += i * 3 - 7\n        f += 0.5\n        if f > 100.0\n            f = f - 99.5\n"
+		"        a[0] = a[0] + s\n        fa[0] = fa[0] * 1.0000001\n    }\n}\n";
+
+	double interpretedTime = Interpret(source, true, true);
+	double compiledTime = Interpret(source, true, true, true);
+
+	printf("  vm %9.3fms, jit %9.3fms (%.1fx)%s\n", interpretedTime, compiledTime, interpretedTime / compiledTime,
+		Jit::IsSupported() ? "" : ", not supported on this platform");
+	Record("jit", "vm", interpretedTime, "ms");
+	Record("jit", "jit", compiledTime, "ms");
+}
+
+// Runs every workload of the corpus with both engines and measures each phase on its own.
+// ARGS[1] of the workloads is the path of a scratch file they may write to.
+static void Corpus(const std::filesystem::path& directory)
+{
+	printf("Corpus (%s)\n", directory.generic_string().c_str());
+
+	std::vector<std::filesystem::path> files;
+	for (const auto& entry : std::filesystem::directory_iterator(directory))
+	{
+		if (entry.path().extension() == ".ion")
+		{
+			files.push_back(entry.path());
+		}
+	}
+	std::sort(files.begin(), files.end());
+
+	std::filesystem::path scratch = std::filesystem::temp_directory_path() / "iona_bench_corpus.txt";
+
+	for (const auto& file : files)
+	{
+		std::ifstream in(file, std::ios::binary);
+		std::string source((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		std::string name = file.stem().string();
+		std::vector<std::string> args = { file.filename().string(), scratch.generic_string() };
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		Lexer tokenizer(source, "Bench.ion");
+		while (tokenizer.NextToken().GetTokenType() != TokenType::None)
+		{
+		}
+
+		auto end = std::chrono::high_resolution_clock::now();
+		double lexTime = Milliseconds(start, end);
+
+		// Parsing includes lexing, the parser pulls its tokens from the lexer
+		start = std::chrono::high_resolution_clock::now();
+
+		Lexer lexer(source, "Bench.ion");
+		Parser parser(lexer);
+		Ref<Node> astRoot = parser.Parse();
+
+		end = std::chrono::high_resolution_clock::now();
+		double parseTime = Milliseconds(start, end);
+
+		start = std::chrono::high_resolution_clock::now();
+
+		SemanticAnalyzer semanticAnalyzer(astRoot);
+		semanticAnalyzer.Analyze();
+		Optimizer optimizer(astRoot, parser.GetArena());
+		optimizer.Optimize();
+
+		end = std::chrono::high_resolution_clock::now();
+		double analyzeTime = Milliseconds(start, end);
+
+		start = std::chrono::high_resolution_clock::now();
+
+		Ref<BytecodeCompiler> compiler = std::make_shared<BytecodeCompiler>(astRoot);
+		Ref<BytecodeProgram> program = compiler->Compile();
+
+		end = std::chrono::high_resolution_clock::now();
+		double compileTime = Milliseconds(start, end);
+
+		start = std::chrono::high_resolution_clock::now();
+
+		Ref<Interpreter> interpreter = std::make_shared<Interpreter>(args, astRoot);
+		interpreter->Interpret();
+
+		end = std::chrono::high_resolution_clock::now();
+		double treeTime = Milliseconds(start, end);
+
+		start = std::chrono::high_resolution_clock::now();
+
+		VirtualMachine vm(args, program);
+		vm.SetJit(true);
+		vm.Run();
+
+		end = std::chrono::high_resolution_clock::now();
+		double vmTime = Milliseconds(start, end);
+
+		printf("  %-20s lex %7.3fms, parse %7.3fms, analyze %7.3fms, compile %7.3fms, tree %9.3fms, vm %9.3fms\n",
+			name.c_str(), lexTime, parseTime, analyzeTime, compileTime, treeTime, vmTime);
+
+		Record("corpus/" + name, "lex", lexTime, "ms");
+		Record("corpus/" + name, "parse", parseTime, "ms");
+		Record("corpus/" + name, "analyze", analyzeTime, "ms");
+		Record("corpus/" + name, "compile", compileTime, "ms");
+		Record("corpus/" + name, "tree", treeTime, "ms");
+		Record("corpus/" + name, "vm", vmTime, "ms");
+	}
+
+	std::filesystem::remove(scratch);
+}
+
+// Lexes, parses and analyzes a generated program with 100k lines, the throughput is
+// independent of the size, so it can be compared between machines of the same kind
+static void FrontEnd()
+{
+	printf("Front end (100k lines)\n");
+
+	std::string source = GenerateProgram(4000);
+	double megabytes = source.size() / (1024.0 * 1024.0);
+	double lines = (double) std::count(source.begin(), source.end(), '\n');
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	Lexer tokenizer(source, "Bench.ion");
+	size_t tokens = 0;
+	while (tokenizer.NextToken().GetTokenType() != TokenType::None)
+	{
+		tokens++;
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	double lexTime = Milliseconds(start, end);
+
+	start = std::chrono::high_resolution_clock::now();
+
+	Lexer lexer(source, "Bench.ion");
+	Parser parser(lexer);
+	Ref<Node> astRoot = parser.Parse();
+
+	end = std::chrono::high_resolution_clock::now();
+	double parseTime = Milliseconds(start, end);
+
+	start = std::chrono::high_resolution_clock::now();
+
+	SemanticAnalyzer semanticAnalyzer(astRoot);
+	semanticAnalyzer.Analyze();
+
+	end = std::chrono::high_resolution_clock::now();
+	double analyzeTime = Milliseconds(start, end);
+
+	printf("  lex     %9.3fms (%7.2f MB/s, %9.0f lines/s, %zu tokens)\n", lexTime, megabytes * 1000.0 / lexTime, lines * 1000.0 / lexTime, tokens);
+	printf("  parse   %9.3fms (%7.2f MB/s, %9.0f lines/s)\n", parseTime, megabytes * 1000.0 / parseTime, lines * 1000.0 / parseTime);
+	printf("  analyze %9.3fms (%9.0f lines/s)\n", analyzeTime, lines * 1000.0 / analyzeTime);
+
+	Record("front end", "lex", megabytes * 1000.0 / lexTime, "MB/s");
+	Record("front end", "parse", megabytes * 1000.0 / parseTime, "MB/s");
+	Record("front end", "lex lines", lines * 1000.0 / lexTime, "lines/s");
+	Record("front end", "parse lines", lines * 1000.0 / parseTime, "lines/s");
+	Record("front end", "analyze lines", lines * 1000.0 / analyzeTime, "lines/s");
+}
+
+// Lexes generated sources of about 8MB each, once with every scanner implementation the cpu supports
+static void LexerScanning()
+{
+	printf("Lexer (scanner %s)\n", Scanner::GetImplementation());
+
+	// Long string literals with interpolations, like the ones of generated scripts
+	std::string strings;
+	for (int i = 0; strings.size() < 8 * 1024 * 1024; i++)
+	{
+		strings.append("WriteLine(\"" + std::string(200, 'x') + " row {row" + std::to_string(i) + "} of the report " + std::string(80, 'y') + "\")\n");
+	}
+
+	// Data tables of numeric literals
+	std::string numbers = "var table = [\n";
+	for (int i = 0; numbers.size() < 8 * 1024 * 1024; i++)
+	{
+		numbers.append("    " + std::to_string(i * 7919) + ", " + std::to_string(i) + ".25, " + std::to_string(-i) + ", 1234567890,\n");
+	}
+	numbers.append("    0\n]\n");
+
+	// Indented code with comments and long names
+	std::string code;
+	for (int i = 0; code.size() < 8 * 1024 * 1024; i++)
+	{
+		code.append("        // Updates the running total of the current report with the value\n"
+			"        var running_total_of_the_report = running_total_of_the_report + current_value_of_the_row\n\n");
+	}
+
+	std::string selected = Scanner::GetImplementation();
+	for (const auto& implementation : Scanner::GetImplementations())
+	{
+		Scanner::SetImplementation(implementation);
+
+		for (const auto& [name, source] : { std::make_pair("strings", &strings), std::make_pair("numbers", &numbers), std::make_pair("code", &code) })
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+
+			Lexer lexer(*source, "Bench.ion");
+			size_t tokens = 0;
+			while (lexer.NextToken().GetTokenType() != TokenType::None)
+			{
+				tokens++;
+			}
+
+			auto end = std::chrono::high_resolution_clock::now();
+			double throughput = source->size() / (1024.0 * 1024.0) * 1000.0 / Milliseconds(start, end);
+
+			printf("  %-6s %-7s %8.2f MB/s (%zu tokens)\n", implementation.c_str(), name, throughput, tokens);
+			Record(std::string("lexer/") + name, implementation, throughput, "MB/s");
+		}
+	}
+
+	Scanner::SetImplementation(selected);
+}
+
+// Runs a generated program with 1000 functions (about 22k lines) of which Main calls three, once parsing and
+// analyzing every function before the start and once loading the bodies lazily on their first call
+static void LazyFunctions()
+{
+	printf("Lazy functions (22k lines, 3 of 1000 functions called)\n");
+
+	// Names can not contain digits, the number of a function is written with letters
+	auto name = [](int number)
+	{
+		std::string name = "Helper";
+		for (char digit : std::to_string(number))
+		{
+			name.push_back((char) ('a' + (digit - '0')));
+		}
+
+		return name;
+	};
+
+	const int functions = 1000;
+	std::string source = "var total = 0\n"
+		"func Main()\n{\n"
+		"    var r = " + name(0) + "(1)\n"
+		"    r = " + name(functions / 2) + "(r)\n"
+		"    r = " + name(functions - 1) + "(r)\n"
+		"}\n"
+		"func Add(value)\n{\n    return value + 1\n}\n";
+	for (int i = 0; i < functions; i++)
+	{
+		source.append("func " + name(i) + "(value)\n{\n"
+			"    var a = value + 2 * 3\n"
+			"    var b = [1, 2, 3]\n"
+			"    b[0] = a - 1\n"
+			"    a = b[1] / 2\n"
+			"    a++\n"
+			"    a += Size(b)\n"
+			"    var f = 1.5\n"
+			"    var s = \"value {a} of {value}\"\n"
+			"    if a < 2\n        a = 1\n    else\n        a = 3\n"
+			"    while a < 0\n        a++\n"
+			"    for x in b\n        total += x\n"
+			"    for i in 0..2\n        total += Add(i)\n"
+			"    return a\n"
+			"}\n");
+	}
+
+	std::vector<std::string> args = { "Bench.ion" };
+	for (bool lazy : { false, true })
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		Lexer lexer(source, "Bench.ion");
+		Parser parser(lexer);
+		parser.SetLazyFunctions(lazy);
+		Ref<Node> astRoot = parser.Parse();
+
+		Ref<SemanticAnalyzer> semanticAnalyzer = std::make_shared<SemanticAnalyzer>(astRoot);
+		semanticAnalyzer->Analyze();
+
+		Optimizer optimizer(astRoot, parser.GetArena());
+		optimizer.Optimize();
+
+		Ref<Interpreter> interpreter = std::make_shared<Interpreter>(args, astRoot);
+		Ref<FunctionLoader> functionLoader = std::make_shared<FunctionLoader>(astRoot, parser.GetArena(), semanticAnalyzer, true);
+		interpreter->SetFunctionLoader(functionLoader);
+		interpreter->Interpret();
+
+		auto end = std::chrono::high_resolution_clock::now();
+		double time = Milliseconds(start, end);
+
+		printf("  %-5s %9.3fms (%zu bodies loaded lazily)\n", lazy ? "lazy" : "eager", time, functionLoader->GetLoadedFunctions());
+		Record("lazy functions", lazy ? "lazy" : "eager", time, "ms");
+	}
+}
+
+// Call of an internal function with fixed arguments. Prepare runs before every call without
+// being measured (eg. to remove the target of a copy), otherwise the whole loop is measured.
+struct BuiltinCall
+{
+	const char* name;
+	std::vector<Value> arguments;
+	int iterations;
+	std::function<void()> prepare = nullptr;
+};
+
+// Calls every internal function directly through its registry entry, without an engine in between.
+// WriteLine is left out, it formats like ToString and would only add the time of the terminal.
+static void Builtins()
+{
+	printf("Built-in functions\n");
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "iona_bench_files";
+	std::filesystem::create_directories(directory);
+
+	std::vector<Value> lines;
+	for (int i = 0; i < 1000; i++)
+	{
+		lines.emplace_back("line number " + std::to_string(i) + " of the benchmark file");
+	}
+	std::string text;
+	for (const auto& line : lines)
+	{
+		text.append(line.GetString()).append("\n");
+	}
+
+	std::string file = (directory / "lines.txt").generic_string();
+	std::string copy = (directory / "copy.txt").generic_string();
+	std::string scratch = (directory / "scratch.txt").generic_string();
+	std::ofstream(file) << text;
+	for (int i = 0; i < 20; i++)
+	{
+		std::ofstream(directory / ("file" + std::to_string(i) + ".ion")) << i;
+	}
+
+	Value array(std::vector<int32_t>(1000, 7));
+	Value stringArray(TokenType::StringArray, std::vector<Value>(lines.begin(), lines.begin() + 10));
+	Value sentence("  The quick brown fox jumps over the lazy dog  ");
+
+	std::vector<BuiltinCall> calls = {
+		{ "ReadLine", { }, 100000 },
+		{ "ReadInt", { }, 100000 },
+		{ "ReadFloat", { }, 100000 },
+		{ "ToUpperCase", { sentence }, 100000 },
+		{ "ToLowerCase", { sentence }, 100000 },
+		{ "StartsWith", { sentence, Value("  The") }, 100000 },
+		{ "EndsWith", { sentence, Value("dog  ") }, 100000 },
+		{ "Contains", { sentence, Value("lazy") }, 100000 },
+		{ "Split", { sentence, Value(" ") }, 100000 },
+		{ "Trim", { sentence }, 100000 },
+		{ "Size", { array }, 100000 },
+		{ "Empty", { sentence }, 100000 },
+		{ "Random", { Value(0), Value(100) }, 100000 },
+		{ "Range", { Value(1000) }, 10000 },
+		{ "Reverse", { array }, 10000 },
+		{ "ToString", { stringArray }, 10000 },
+		{ "Min", { Value(3), Value(7) }, 100000 },
+		{ "Max", { Value(3.5f), Value(7.5f) }, 100000 },
+		{ "FileExists", { Value(file) }, 1000 },
+		{ "FileRead", { Value(file) }, 1000 },
+		{ "FileWrite", { Value(scratch), Value(text) }, 1000 },
+		{ "FileCopy", { Value(file), Value(copy) }, 1000, [&copy]() { std::filesystem::remove(copy); } },
+		{ "FileReadLines", { Value(file) }, 1000 },
+		{ "FileWriteLines", { Value(scratch), Value(TokenType::StringArray, lines), Value(false) }, 1000 },
+		{ "FileList", { Value(directory.generic_string()), Value(".*\\.ion") }, 1000 }
+	};
+
+	// The read functions get their input from a string instead of the terminal
+	std::istringstream input;
+	std::streambuf* terminal = std::cin.rdbuf(input.rdbuf());
+
+	for (auto& call : calls)
+	{
+		const FunctionEntry* entry = FunctionRegistry::Internal().Find(call.name);
+		if (entry == nullptr || !FunctionRegistry::Accepts(*entry, call.arguments))
+		{
+			std::cin.rdbuf(terminal);
+			Exit("Bench.ion", 0, "Internal function '%s' does not accept the arguments of its benchmark", call.name);
+		}
+
+		std::string inputLines;
+		for (int i = 0; i < call.iterations; i++)
+		{
+			inputLines.append("42\n");
+		}
+		input.str(inputLines);
+		input.clear();
+
+		std::vector<Value> in;
+		Value out;
+		double time = 0.0;
+
+		if (call.prepare)
+		{
+			for (int i = 0; i < call.iterations; i++)
+			{
+				call.prepare();
+				in = call.arguments;
+
+				auto start = std::chrono::high_resolution_clock::now();
+
+				entry->function(in, out);
+
+				auto end = std::chrono::high_resolution_clock::now();
+				time += Milliseconds(start, end);
+			}
+		}
+		else
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+
+			for (int i = 0; i < call.iterations; i++)
+			{
+				in = call.arguments;
+				entry->function(in, out);
+			}
+
+			auto end = std::chrono::high_resolution_clock::now();
+			time = Milliseconds(start, end);
+		}
+
+		double timePerCall = time * 1e6 / call.iterations;
+
+		printf("  %-15s %11.1fns/call\n", call.name, timePerCall);
+		Record("builtins", call.name, timePerCall, "ns/call");
+	}
+
+	std::cin.rdbuf(terminal);
+	std::filesystem::remove_all(directory);
+}
+
+static std::string JsonString(const std::string& value)
+{
+	std::string result = "\"";
+	for (char c : value)
+	{
+		if (c == '"' || c == '\\')
+		{
+			result.push_back('\\');
+			result.push_back(c);
+		}
+		else if ((unsigned char) c < 0x20)
+		{
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+			result.append(escaped);
+		}
+		else
+		{
+			result.push_back(c);
+		}
+	}
+
+	return result.append("\"");
+}
+
+// Debug builds are far slower, results of different build types should not be compared
+static bool WriteJson(const std::string& fileName)
+{
+	std::ofstream out(fileName);
+
+#ifdef NDEBUG
+	out << "{\n  \"debug\": false,\n";
+#else
+	out << "{\n  \"debug\": true,\n";
+#endif
+	out << "  \"jit\": " << (Jit::IsSupported() ? "true" : "false") << ",\n";
+	out << "  \"results\": [\n";
+
+	out.precision(10);
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result& result = results[i];
+
+		out << "    { \"benchmark\": " << JsonString(result.benchmark) << ", \"metric\": " << JsonString(result.metric) << ", \"value\": ";
+		if (std::isfinite(result.value))
+		{
+			out << result.value;
+		}
+		else
+		{
+			out << "null";
+		}
+		out << ", \"unit\": " << JsonString(result.unit) << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+
+	out << "  ]\n}\n";
+	out.close();
+
+	return !out.fail();
+}
+
+int main(int argc, char const* argv[])
+{
+	// Options, eg. 'bench --filter=corpus --json=results.json'
+	std::string json;
+	std::string filter;
+	std::filesystem::path corpus = IONA_BENCH_CORPUS;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+
+		if (Helper::StartsWith(option, "--json="))
+		{
+			json = option.substr(7);
+		}
+		else if (Helper::StartsWith(option, "--filter="))
+		{
+			filter = option.substr(9);
+		}
+		else if (Helper::StartsWith(option, "--corpus="))
+		{
+			corpus = option.substr(9);
+		}
+		else
+		{
+			std::cout << "Unknown option '" << option << "', supported are '--json=<file>', '--filter=<name>' and '--corpus=<directory>'" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::vector<std::pair<const char*, std::function<void()>>> benchmarks = {
+		{ "corpus", [&corpus]() { Corpus(corpus); } },
+		{ "front end", FrontEnd },
+		{ "lexer", LexerScanning },
+		{ "lazy functions", LazyFunctions },
+		{ "builtins", Builtins },
+		{ "array fill", ArrayFill },
+		{ "file lines pass through", FileLinesPassThrough },
+		{ "engines", Engines },
+		{ "constant folding", ConstantFolding },
+		{ "internal calls", InternalCalls },
+		{ "early return", EarlyReturn },
+		{ "tail calls", TailCalls },
+		{ "deep recursion", DeepRecursion },
+		{ "inline caches", InlineCaches },
+		{ "jit", JitLoops },
+		{ "traversal", Traversal }
+	};
+
+	try
+	{
+		for (const auto& [name, run] : benchmarks)
+		{
+			if (std::string(name).find(filter) != std::string::npos)
+			{
+				run();
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		fprintf(stderr, "%s\n", e.what());
+
+		return EXIT_FAILURE;
+	}
+
+	if (!json.empty() && !WriteJson(json))
+	{
+		fprintf(stderr, "Results could not be written to '%s'\n", json.c_str());
+
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef CPP_EMITTER_H
+#define CPP_EMITTER_H
+
+#include <functional>
+#include <map>
+#include <set>
+#include <ostream>
+#include <sstream>
+#include "Visitor.h"
+#include "Core.h"
+#include "Interpreter.h"
+
+// C++ code of an expression. Ints, floats, bools and strings whose type is known before execution
+// are native (int, float, bool and std::string), every other expression is a Value.
+struct CppExpression
+{
+	std::string code;
+	// Known type of the expression or None, arrays are values with a known type
+	TokenType type = TokenType::None;
+	// Literals can be evaluated at any time, calls and increments need to keep their order
+	bool constant = false;
+	bool sideEffects = false;
+};
+
+// Translates a semantically analyzed program into a C++ program. The result needs the runtime,
+// which has to be written before it (see WriteRuntime). Errors are reported like in the interpreter.
+class CppEmitter : public Visitor
+{
+private:
+	struct CppVariable
+	{
+		std::string name;
+		TokenType type;
+	};
+
+	std::string fileName;
+	// Variable of the program arguments, it is filled in main
+	std::string argsName;
+	std::string mainName;
+	// Deep recursion fails like in the tree walking interpreter, the native stack is not larger
+	int maxCallDepth = Interpreter::DefaultMaxCallDepth;
+
+	std::ostringstream declarations;
+	// Functions with an array of arguments for tail calls, only for the called ones
+	std::ostringstream adapters;
+	std::set<const FunctionNode*> adapted;
+	std::ostringstream functions;
+	std::ostringstream initialization;
+	std::ostringstream* out = nullptr;
+	int depth = 0;
+	int uniqueId = 0;
+
+	std::vector<std::map<std::string, CppVariable>> scopes;
+	std::map<const FunctionNode*, std::string> functionNames;
+
+	// Function which is translated and whether it calls itself as a tail call
+	const FunctionNode* currentFunction = nullptr;
+	bool selfTailCall = false;
+
+	CppExpression expression;
+
+	void Line(const std::string& text);
+	void Statement(Node* node);
+	void Block(Node* node);
+	CppExpression Expression(Node* node);
+
+	std::string UniqueName(const std::string& prefix, const std::string& name);
+	const CppVariable& DeclareVariable(const std::string& name, TokenType type);
+	const CppVariable& ResolveVariable(const std::string& name);
+
+	std::string Condition(const CppExpression& condition, int line, const char* expression);
+	// Evaluates the left expression before the right one if one of them has side effects the other one could see
+	CppExpression Ordered(const CppExpression& left, const CppExpression& right, TokenType type,
+		const std::function<std::string(const std::string&, const std::string&)>& combine);
+	CppExpression InternalCall(FunctionCallNode& n, std::vector<CppExpression> arguments);
+	// Name of the function of a tail call, which takes the arguments as an array
+	std::string TailCallAdapter(const FunctionNode& function);
+public:
+	CppEmitter(const Ref<Node>& astRoot, std::string fileName);
+	~CppEmitter() = default;
+
+	// Writes the runtime of the translated programs, which is embedded into ionac
+	static void WriteRuntime(std::ostream& stream);
+	void SetMaxCallDepth(int maxCallDepth)
+	{
+		this->maxCallDepth = maxCallDepth;
+	}
+	void Emit(std::ostream& stream);
+
+	static bool IsNative(TokenType type);
+	static std::string NativeType(TokenType type);
+	static std::string Quote(const std::string& value);
+	static std::string FloatLiteral(float value);
+	static std::string IntLiteral(int value);
+	static std::string DoubleLiteral(double value);
+	static std::string LongLiteral(int64_t value);
+	static CppExpression Boxed(const CppExpression& expression);
+
+	void Visit(MainNode& n) override;
+	void Visit(VariableDeclarationAssignNode& n) override;
+	void Visit(VariableArrayDeclarationAssignNode& n) override;
+	void Visit(FunctionNode& n) override;
+	void Visit(FunctionCallNode& n) override;
+	void Visit(ForEachNode& n) override;
+	void Visit(ForINode& n) override;
+	void Visit(BlockNode& n) override;
+	void Visit(BinaryNode& n) override;
+	void Visit(BooleanNode& n) override;
+	void Visit(IfNode& n) override;
+	void Visit(WhileNode& n) override;
+	void Visit(DoWhileNode& n) override;
+	void Visit(ReturnNode& n) override;
+	void Visit(StringNode& n) override;
+	void Visit(IntNode& n) override;
+	void Visit(FloatNode& n) override;
+	void Visit(LongNode& n) override;
+	void Visit(DoubleNode& n) override;
+	void Visit(BoolNode& n) override;
+	void Visit(VariableUsageNode& n) override;
+	void Visit(VariableAssignNode& n) override;
+	void Visit(VariableArrayUsageNode& n) override;
+	void Visit(VariableArrayAssignNode& n) override;
+	void Visit(VariableIncrementDecrementNode& n) override;
+	void Visit(VariableCompoundAssignNode& n) override;
+};
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+// Start of the runtime which ionac embeds into every program it translates. The runtime is this file,
+// the values and internal functions of the interpreter and Runtime.h, see the CMakeLists.txt of ionac.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename ...Args>
+static void Exit(std::string fileName, int line, const std::string& error, Args ...args)
+{
+	std::string prefix(std::move(fileName));
+	prefix.append("(line ").append(std::to_string(line)).append("): ").append(error);
+
+	const char* finalError = prefix.c_str();
+
+	size_t size = std::snprintf(nullptr, 0, finalError, args...) + 1;
+	std::vector<char> buffer(size);
+	std::snprintf(&buffer[0], size, finalError, args...);
+
+	throw std::runtime_error(&buffer[0]);
+}
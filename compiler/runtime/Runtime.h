@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+// Operations of translated programs on values whose types are not known before execution.
+// They check and report errors exactly like the interpreter does.
+namespace Iona::Runtime
+{
+	using InternalFunction = void (*)(std::vector<Value>& in, Value& out);
+
+	using Function = Value (*)(std::vector<Value>& arguments);
+
+	// Source file of the program, errors are reported with it
+	static std::string fileName;
+
+	// Calls of the functions of the program, tail calls are not counted like in the interpreter
+	static int callDepth = 0;
+	static int maxCallDepth = 0;
+
+	// Tail call to another function, which the caller of the returning function executes
+	static Function tailCall = nullptr;
+	static std::vector<Value> tailCallArguments;
+
+	struct CallFrame
+	{
+		CallFrame()
+		{
+			callDepth++;
+		}
+
+		~CallFrame()
+		{
+			callDepth--;
+		}
+	};
+
+	template <typename ...Args>
+	[[noreturn]] static void Fail(int line, const std::string& error, Args ...args)
+	{
+		Exit(fileName, line, error, args...);
+		std::abort();
+	}
+
+	template <typename T>
+	T As(const Value& value);
+
+	template <>
+	inline int As<int>(const Value& value)
+	{
+		return value.GetInt();
+	}
+
+	template <>
+	inline float As<float>(const Value& value)
+	{
+		return value.GetFloat();
+	}
+
+	template <>
+	inline int64_t As<int64_t>(const Value& value)
+	{
+		return value.GetLong();
+	}
+
+	template <>
+	inline double As<double>(const Value& value)
+	{
+		return value.GetDouble();
+	}
+
+	template <>
+	inline bool As<bool>(const Value& value)
+	{
+		return value.GetBool();
+	}
+
+	template <>
+	inline std::string As<std::string>(const Value& value)
+	{
+		return value.GetString();
+	}
+
+	template <typename T>
+	TokenType TypeOf();
+
+	template <>
+	inline TokenType TypeOf<int>()
+	{
+		return TokenType::Int;
+	}
+
+	template <>
+	inline TokenType TypeOf<float>()
+	{
+		return TokenType::Float;
+	}
+
+	template <>
+	inline TokenType TypeOf<int64_t>()
+	{
+		return TokenType::Long;
+	}
+
+	template <>
+	inline TokenType TypeOf<double>()
+	{
+		return TokenType::Double;
+	}
+
+	template <>
+	inline TokenType TypeOf<bool>()
+	{
+		return TokenType::Bool;
+	}
+
+	template <>
+	inline TokenType TypeOf<std::string>()
+	{
+		return TokenType::String;
+	}
+
+	static void CheckCallDepth(int line, const char* name)
+	{
+		if (callDepth >= maxCallDepth)
+		{
+			Fail(line, "Maximum call depth of %i exceeded by a call of function '%s'", maxCallDepth, name);
+		}
+	}
+
+	// Executes the tail calls of a returned function one after another, so they do not grow the stack
+	static Value Trampoline(Value result)
+	{
+		while (tailCall != nullptr)
+		{
+			Function function = tailCall;
+			std::vector<Value> arguments = std::move(tailCallArguments);
+			tailCall = nullptr;
+
+			result = function(arguments);
+		}
+
+		return result;
+	}
+
+	static Value Declare(Value value, int line, const char* name)
+	{
+		if (!IsVariableType(value.GetType()))
+		{
+			Fail(line, "Type '%s' of variable '%s' is not a valid variable type", Helper::ToString(value.GetType()).c_str(), name);
+		}
+
+		return value;
+	}
+
+	static void Assign(Value& variable, Value value, int line, const char* name)
+	{
+		if (value.GetType() != variable.GetType())
+		{
+			Fail(line, "New value of variable '%s' needs to be of type '%s', but is '%s'",
+				name, Helper::ToString(variable.GetType()).c_str(), Helper::ToString(value.GetType()).c_str());
+		}
+
+		variable = std::move(value);
+	}
+
+	// Checks a value for a variable whose type is known
+	template <typename T>
+	T AssignAs(const Value& value, int line, const char* name)
+	{
+		if (value.GetType() != TypeOf<T>())
+		{
+			Fail(line, "New value of variable '%s' needs to be of type '%s', but is '%s'",
+				name, Helper::ToString(TypeOf<T>()).c_str(), Helper::ToString(value.GetType()).c_str());
+		}
+
+		return As<T>(value);
+	}
+
+	static Value Arithmetic(TokenType operant, const Value& left, const Value& right, int line)
+	{
+		if (left.GetType() == TokenType::String && right.GetType() == TokenType::String)
+		{
+			if (operant != TokenType::Plus)
+			{
+				Fail(line, "Invalid arithmetic string operator '%s'", Helper::ToString(operant).c_str());
+			}
+
+			return Value(left.GetString() + right.GetString());
+		}
+
+		// Mixed types do not have a result
+		return left.Arithmetic(operant, right);
+	}
+
+	static void CompoundAssign(Value& variable, TokenType operation, const Value& value, int line, const char* name)
+	{
+		if (value.GetType() != variable.GetType())
+		{
+			Fail(line, "New value of variable '%s' needs to be of type '%s', but is '%s'",
+				name, Helper::ToString(variable.GetType()).c_str(), Helper::ToString(value.GetType()).c_str());
+		}
+
+		if (!IsNumberType(variable.GetType()))
+		{
+			Fail(line, "Variable increment assignments are only supported with int, float, long and double type, but got %s",
+				Helper::ToString(variable.GetType()).c_str());
+		}
+
+		variable = Arithmetic(operation, variable, value, line);
+	}
+
+	static Value Increment(Value& variable, int value, int line)
+	{
+		if (variable.GetType() == TokenType::Int)
+		{
+			variable = Value(WrappingPlus<int>()(variable.GetInt(), value));
+		}
+		else if (variable.GetType() == TokenType::Float)
+		{
+			variable = Value(variable.GetFloat() + (float) value);
+		}
+		else if (variable.GetType() == TokenType::Long)
+		{
+			variable = Value(WrappingPlus<int64_t>()(variable.GetLong(), value));
+		}
+		else if (variable.GetType() == TokenType::Double)
+		{
+			variable = Value(variable.GetDouble() + value);
+		}
+		else
+		{
+			Fail(line, "Variable increments are only supported with int, float, long and double type, but got %s", Helper::ToString(variable.GetType()).c_str());
+		}
+
+		return variable;
+	}
+
+	static bool Condition(const Value& value, int line, const char* expression)
+	{
+		if (value.GetType() != TokenType::Bool)
+		{
+			Fail(line, "Expression from %s needs to be a boolean result", expression);
+		}
+
+		return value.GetBool();
+	}
+
+	static void CheckIndex(const Value& array, unsigned int index, int line)
+	{
+		if (index >= array.GetArraySize())
+		{
+			Fail(line, "Array index %i is higher than the max array index of %i", index, array.GetArraySize() - 1);
+		}
+	}
+
+	static Value Element(const Value& array, unsigned int index, int line)
+	{
+		CheckIndex(array, index, line);
+
+		return array.GetArrayElement(index);
+	}
+
+	template <typename T>
+	const auto& ElementsOf(const Value& array)
+	{
+		if constexpr (std::is_same_v<T, int>)
+		{
+			return array.GetIntArray();
+		}
+		else if constexpr (std::is_same_v<T, float>)
+		{
+			return array.GetFloatArray();
+		}
+		else if constexpr (std::is_same_v<T, bool>)
+		{
+			return array.GetBoolArray();
+		}
+		else
+		{
+			return array.GetStringArray();
+		}
+	}
+
+	// Element of an array whose type is known, the size is read without checking the type
+	template <typename T>
+	T ElementAs(const Value& array, unsigned int index, int line)
+	{
+		const auto& values = ElementsOf<T>(array);
+		if (index >= values.size())
+		{
+			Fail(line, "Array index %i is higher than the max array index of %i", index, (int) values.size() - 1);
+		}
+
+		if constexpr (std::is_same_v<T, std::string>)
+		{
+			return values[index].GetString();
+		}
+		else
+		{
+			return values[index];
+		}
+	}
+
+	// Writes an element of the type of an array whose type is known
+	template <typename T>
+	void SetElementAs(Value& array, unsigned int index, T value, int line)
+	{
+		const auto& values = ElementsOf<T>(array);
+		if (index >= values.size())
+		{
+			Fail(line, "Array index %i is higher than the max array index of %i", index, (int) values.size() - 1);
+		}
+
+		array.SetArrayElement(index, Value(value));
+	}
+
+	static void SetElement(Value& array, unsigned int index, const Value& value, int line, const char* name)
+	{
+		if (value.GetType() != GetArrayElementType(array.GetType()))
+		{
+			Fail(line, "New value of array variable '%s' needs to be of type '%s', but is '%s'",
+				name, Helper::ToString(array.GetType()).c_str(), Helper::ToString(value.GetType()).c_str());
+		}
+
+		CheckIndex(array, index, line);
+
+		array.SetArrayElement(index, value);
+	}
+
+	static Value NewArray(TokenType arrayType, std::vector<Value> values, int line, const char* name)
+	{
+		TokenType elementType = GetArrayElementType(arrayType);
+		for (const auto& value : values)
+		{
+			if (value.GetType() != elementType)
+			{
+				Fail(line, "Values of array variable '%s' need to be of type '%s', but one is '%s'",
+					name, Helper::ToString(elementType).c_str(), Helper::ToString(value.GetType()).c_str());
+			}
+		}
+
+		return Value(arrayType, std::move(values));
+	}
+
+	static Value Iterable(Value array, int line)
+	{
+		if (!IsVariableArrayType(array.GetType()))
+		{
+			Fail(line, "For loop can only loop over arrays, but in type is '%s'", Helper::ToString(array.GetType()).c_str());
+		}
+
+		return array;
+	}
+
+	static Value Call(InternalFunction function, std::vector<Value> in)
+	{
+		Value out;
+		function(in, out);
+
+		return out;
+	}
+
+	// Calls an internal function whose parameter types were not proven, with the allowed types of each
+	// parameter as a bit mask of token types like in the function registry of the interpreter
+	static Value CheckedCall(InternalFunction function, int line, const char* name, std::vector<uint64_t> parameterTypes, std::vector<Value> in)
+	{
+		if (in.size() != parameterTypes.size())
+		{
+			Fail(line, "Function call parameter count (%zu) is not matching expected parameter count (%zu) of function '%s'",
+				in.size(), parameterTypes.size(), name);
+		}
+
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			if ((parameterTypes[i] & ((uint64_t) 1 << in[i].GetType())) == 0)
+			{
+				Fail(line, "Parameter %zu of function '%s' needs to be of type %s, but is '%s'",
+					i + 1, name, Helper::TypesToString(parameterTypes[i]).c_str(), Helper::ToString(in[i].GetType()).c_str());
+			}
+		}
+
+		return Call(function, std::move(in));
+	}
+
+	// WriteLine of a value whose type is known, it does not need the arguments of an internal function
+	static Value WriteLine(const std::string& value)
+	{
+		std::printf("%s\n", value.c_str());
+
+		return Value();
+	}
+
+	// Parts of an interpolated string, they are evaluated in order like all initializer lists
+	static std::string Concat(std::initializer_list<std::string> parts)
+	{
+		std::string result;
+		for (const auto& part : parts)
+		{
+			result.append(part);
+		}
+
+		return result;
+	}
+
+	static std::string ToString(int value)
+	{
+		return std::to_string(value);
+	}
+
+	static std::string ToString(float value)
+	{
+		return ToStringInternal(Value(value));
+	}
+
+	static std::string ToString(int64_t value)
+	{
+		return std::to_string(value);
+	}
+
+	static std::string ToString(double value)
+	{
+		return ToStringInternal(Value(value));
+	}
+
+	static std::string ToString(bool value)
+	{
+		return value ? "true" : "false";
+	}
+
+	static const std::string& ToString(const std::string& value)
+	{
+		return value;
+	}
+
+	static std::string ToString(const Value& value)
+	{
+		return ToStringInternal(value);
+	}
+}
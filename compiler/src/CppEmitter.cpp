@@ -0,0 +1,1256 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "CppEmitter.h"
+#include <cmath>
+#include "FunctionRegistry.h"
+#include "Standard.h"
+
+// Generated at configure time from the runtime sources, see the CMakeLists.txt
+#include "RuntimeSource.inc"
+
+namespace
+{
+	struct InternalFunction
+	{
+		const char* name;
+		// Type of the result if the arguments were accepted, None if it depends on them
+		TokenType result;
+	};
+
+	const std::map<std::string, InternalFunction> internalFunctions = {
+		{ "WriteLine", { "Iona::Console::WriteLine", TokenType::None } },
+		{ "ReadLine", { "Iona::Console::ReadLine", TokenType::String } },
+		{ "ReadInt", { "Iona::Console::ReadInt", TokenType::Int } },
+		{ "ReadFloat", { "Iona::Console::ReadFloat", TokenType::Float } },
+		{ "ToUpperCase", { "Iona::String::ToUpperCase", TokenType::String } },
+		{ "ToLowerCase", { "Iona::String::ToLowerCase", TokenType::String } },
+		{ "StartsWith", { "Iona::String::StartsWith", TokenType::Bool } },
+		{ "EndsWith", { "Iona::String::EndsWith", TokenType::Bool } },
+		{ "Contains", { "Iona::String::Contains", TokenType::Bool } },
+		{ "Split", { "Iona::String::Split", TokenType::StringArray } },
+		{ "Trim", { "Iona::String::Trim", TokenType::String } },
+		{ "Size", { "Iona::Core::Size", TokenType::Int } },
+		{ "Empty", { "Iona::Core::Empty", TokenType::Bool } },
+		{ "Random", { "Iona::Core::Random", TokenType::Int } },
+		{ "Range", { "Iona::Core::Range", TokenType::IntArray } },
+		{ "Reverse", { "Iona::Core::Reverse", TokenType::None } },
+		{ "ToString", { "Iona::Core::ToString", TokenType::String } },
+		{ "Min", { "Iona::Math::Min", TokenType::None } },
+		{ "Max", { "Iona::Math::Max", TokenType::None } },
+		{ "FileExists", { "Iona::File::FileExists", TokenType::Bool } },
+		{ "FileRead", { "Iona::File::FileRead", TokenType::String } },
+		{ "FileWrite", { "Iona::File::FileWrite", TokenType::Bool } },
+		{ "FileCopy", { "Iona::File::FileCopy", TokenType::Bool } },
+		{ "FileReadLines", { "Iona::File::FileReadLines", TokenType::StringArray } },
+		{ "FileWriteLines", { "Iona::File::FileWriteLines", TokenType::Bool } },
+		{ "FileList", { "Iona::File::FileList", TokenType::StringArray } }
+	};
+
+	const char* ArithmeticOperator(TokenType operant)
+	{
+		switch (operant)
+		{
+			case TokenType::Plus:
+				return "+";
+			case TokenType::Minus:
+				return "-";
+			case TokenType::Multiply:
+				return "*";
+			default:
+				return "/";
+		}
+	}
+
+	// Ints and longs wrap around like in the interpreter, whatever flags the translated program is built with
+	const char* WrappingOperation(TokenType operant)
+	{
+		switch (operant)
+		{
+			case TokenType::Plus:
+				return "WrappingPlus";
+			case TokenType::Minus:
+				return "WrappingMinus";
+			case TokenType::Multiply:
+				return "WrappingMultiplies";
+			default:
+				return nullptr;
+		}
+	}
+
+	const char* ComparisonOperator(TokenType operant)
+	{
+		switch (operant)
+		{
+			case TokenType::Equals:
+				return "==";
+			case TokenType::NotEquals:
+				return "!=";
+			case TokenType::LessThan:
+				return "<";
+			case TokenType::GreaterThan:
+				return ">";
+			case TokenType::LessEqualThan:
+				return "<=";
+			default:
+				return ">=";
+		}
+	}
+
+	std::string TokenTypeName(TokenType type)
+	{
+		return "TokenType::" + Helper::ToString(type);
+	}
+
+	// Value of a native expression, like the getters of Value
+	std::string Unboxed(const std::string& code, TokenType type)
+	{
+		switch (type)
+		{
+			case TokenType::Int:
+				return code + ".GetInt()";
+			case TokenType::Float:
+				return code + ".GetFloat()";
+			case TokenType::Long:
+				return code + ".GetLong()";
+			case TokenType::Double:
+				return code + ".GetDouble()";
+			case TokenType::Bool:
+				return code + ".GetBool()";
+			case TokenType::String:
+				return code + ".GetString()";
+			default:
+				return code;
+		}
+	}
+}
+
+CppEmitter::CppEmitter(const Ref<Node>& astRoot, std::string fileName)
+	: Visitor(astRoot), fileName(std::move(fileName))
+{
+}
+
+void CppEmitter::WriteRuntime(std::ostream& stream)
+{
+	for (const char* source : RuntimeSource)
+	{
+		stream << source;
+	}
+}
+
+void CppEmitter::Emit(std::ostream& stream)
+{
+	this->astRoot->Accept(*this);
+
+	stream << "\n// Translated by ionac from " << this->fileName << "\n\n";
+	stream << this->declarations.str() << "\n";
+	stream << this->adapters.str();
+	stream << this->functions.str();
+
+	stream << "int main(int argc, char const* argv[])\n{\n";
+	stream << "\tIona::Runtime::fileName = " << Quote(this->fileName) << ";\n";
+	stream << "\tIona::Runtime::maxCallDepth = " << this->maxCallDepth << ";\n\n";
+	stream << "\ttry\n\t{\n";
+	stream << "\t\tstd::vector<Value> args;\n";
+	stream << "\t\targs.reserve(argc);\n";
+	stream << "\t\tfor (int i = 0; i < argc; i++)\n\t\t{\n\t\t\targs.emplace_back(argv[i]);\n\t\t}\n";
+	stream << "\t\t" << this->argsName << " = Value(TokenType::StringArray, std::move(args));\n\n";
+	stream << this->initialization.str();
+	stream << "\n\t\tIona::Runtime::Trampoline(" << this->mainName << "());\n";
+	stream << "\t}\n";
+	stream << "\tcatch (const std::exception& e)\n\t{\n";
+	stream << "\t\tstd::fflush(stdout);\n";
+	stream << "\t\tstd::fprintf(stderr, \"%s\\n\", e.what());\n\n";
+	stream << "\t\treturn EXIT_FAILURE;\n";
+	stream << "\t}\n\n";
+	stream << "\treturn EXIT_SUCCESS;\n}\n";
+}
+
+bool CppEmitter::IsNative(TokenType type)
+{
+	return IsNumberType(type) || type == TokenType::Bool || type == TokenType::String;
+}
+
+std::string CppEmitter::NativeType(TokenType type)
+{
+	switch (type)
+	{
+		case TokenType::Int:
+			return "int";
+		case TokenType::Float:
+			return "float";
+		case TokenType::Long:
+			return "int64_t";
+		case TokenType::Double:
+			return "double";
+		case TokenType::Bool:
+			return "bool";
+		case TokenType::String:
+			return "std::string";
+		default:
+			return "Value";
+	}
+}
+
+std::string CppEmitter::Quote(const std::string& value)
+{
+	std::string quoted = "\"";
+
+	for (unsigned char c : value)
+	{
+		switch (c)
+		{
+			case '"':
+				quoted.append("\\\"");
+				break;
+			case '\\':
+				quoted.append("\\\\");
+				break;
+			case '\n':
+				quoted.append("\\n");
+				break;
+			case '\t':
+				quoted.append("\\t");
+				break;
+			case '\r':
+				quoted.append("\\r");
+				break;
+			default:
+				// Octal escapes always have three digits, so a following digit is not part of them
+				if (c < 0x20 || c == 0x7F)
+				{
+					char escaped[8];
+					std::snprintf(escaped, sizeof(escaped), "\\%03o", c);
+					quoted.append(escaped);
+				}
+				else
+				{
+					quoted.push_back((char) c);
+				}
+				break;
+		}
+	}
+
+	return quoted.append("\"");
+}
+
+std::string CppEmitter::FloatLiteral(float value)
+{
+	if (std::isnan(value))
+	{
+		// The sign of a nan is printed, 0.0 / 0.0 folded by the optimizer is a negative one
+		return std::signbit(value) ? "(-std::numeric_limits<float>::quiet_NaN())" : "std::numeric_limits<float>::quiet_NaN()";
+	}
+
+	if (std::isinf(value))
+	{
+		return value < 0 ? "(-std::numeric_limits<float>::infinity())" : "std::numeric_limits<float>::infinity()";
+	}
+
+	// Nine significant digits are enough to get the same float back
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+
+	std::string literal(buffer);
+	if (literal.find_first_of(".e") == std::string::npos)
+	{
+		literal.append(".0");
+	}
+	literal.append("f");
+
+	return std::signbit(value) ? "(" + literal + ")" : literal;
+}
+
+std::string CppEmitter::IntLiteral(int value)
+{
+	if (value == std::numeric_limits<int>::min())
+	{
+		return "(-2147483647 - 1)";
+	}
+
+	return value < 0 ? "(" + std::to_string(value) + ")" : std::to_string(value);
+}
+
+std::string CppEmitter::DoubleLiteral(double value)
+{
+	if (std::isnan(value))
+	{
+		return std::signbit(value) ? "(-std::numeric_limits<double>::quiet_NaN())" : "std::numeric_limits<double>::quiet_NaN()";
+	}
+
+	if (std::isinf(value))
+	{
+		return value < 0 ? "(-std::numeric_limits<double>::infinity())" : "std::numeric_limits<double>::infinity()";
+	}
+
+	// Seventeen significant digits are enough to get the same double back
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+
+	std::string literal(buffer);
+	if (literal.find_first_of(".e") == std::string::npos)
+	{
+		literal.append(".0");
+	}
+
+	return std::signbit(value) ? "(" + literal + ")" : literal;
+}
+
+std::string CppEmitter::LongLiteral(int64_t value)
+{
+	if (value == std::numeric_limits<int64_t>::min())
+	{
+		return "(-INT64_C(9223372036854775807) - 1)";
+	}
+
+	return value < 0 ? "(-INT64_C(" + std::to_string(-value) + "))" : "INT64_C(" + std::to_string(value) + ")";
+}
+
+CppExpression CppEmitter::Boxed(const CppExpression& expression)
+{
+	CppExpression boxed = expression;
+	if (IsNative(expression.type))
+	{
+		boxed.code = "Value(" + expression.code + ")";
+		boxed.type = TokenType::None;
+	}
+
+	return boxed;
+}
+
+void CppEmitter::Line(const std::string& text)
+{
+	*this->out << std::string(this->depth, '\t') << text << '\n';
+}
+
+void CppEmitter::Statement(Node* node)
+{
+	this->expression = CppExpression();
+
+	node->Accept(*this);
+
+	// Calls and increments are expressions, their result is not used
+	if (!this->expression.code.empty())
+	{
+		Line(this->expression.code + ";");
+		this->expression = CppExpression();
+	}
+}
+
+void CppEmitter::Block(Node* node)
+{
+	Line("{");
+	this->depth++;
+	this->scopes.emplace_back();
+
+	node->Accept(*this);
+
+	this->scopes.pop_back();
+	this->depth--;
+	Line("}");
+}
+
+CppExpression CppEmitter::Expression(Node* node)
+{
+	this->expression = CppExpression();
+
+	node->Accept(*this);
+
+	CppExpression result = std::move(this->expression);
+	this->expression = CppExpression();
+
+	return result;
+}
+
+std::string CppEmitter::UniqueName(const std::string& prefix, const std::string& name)
+{
+	return prefix + "_" + name + "_" + std::to_string(this->uniqueId++);
+}
+
+const CppEmitter::CppVariable& CppEmitter::DeclareVariable(const std::string& name, TokenType type)
+{
+	CppVariable& variable = this->scopes.back()[name];
+	variable.name = UniqueName("v", name);
+	variable.type = type;
+
+	return variable;
+}
+
+const CppEmitter::CppVariable& CppEmitter::ResolveVariable(const std::string& name)
+{
+	// The semantic analyzer has ensured that every used variable is declared
+	for (auto scope = this->scopes.rbegin(); scope != this->scopes.rend(); ++scope)
+	{
+		auto variable = scope->find(name);
+		if (variable != scope->end())
+		{
+			return variable->second;
+		}
+	}
+
+	throw std::runtime_error("Variable '" + name + "' is not declared in this scope");
+}
+
+std::string CppEmitter::Condition(const CppExpression& condition, int line, const char* expression)
+{
+	if (condition.type == TokenType::Bool)
+	{
+		return condition.code;
+	}
+
+	return "Iona::Runtime::Condition(" + Boxed(condition).code + ", " + std::to_string(line) + ", \"" + expression + "\")";
+}
+
+CppExpression CppEmitter::Ordered(const CppExpression& left, const CppExpression& right, TokenType type,
+	const std::function<std::string(const std::string&, const std::string&)>& combine)
+{
+	CppExpression result;
+	result.type = type;
+	result.constant = left.constant && right.constant;
+	result.sideEffects = left.sideEffects || right.sideEffects;
+
+	// C++ does not define the order of operands, the interpreter evaluates the left one first
+	if ((right.sideEffects && !left.constant) || (left.sideEffects && !right.constant))
+	{
+		result.code = "[&]() { auto left = " + left.code + "; return " + combine("left", right.code) + "; }()";
+	}
+	else
+	{
+		result.code = combine(left.code, right.code);
+	}
+
+	return result;
+}
+
+CppExpression CppEmitter::InternalCall(FunctionCallNode& n, std::vector<CppExpression> arguments)
+{
+	const FunctionEntry& entry = *n.GetInternalFunction();
+	const InternalFunction& function = internalFunctions.at(n.GetName());
+	std::string line = std::to_string(n.GetLine());
+
+	CppExpression result;
+	result.sideEffects = true;
+	result.type = function.result;
+
+	// Arguments of types the semantic analyzer has not proven can still be known here (eg. results of internal functions)
+	bool checked = n.AreTypesChecked() || arguments.size() == entry.parameterCount;
+	for (size_t i = 0; !n.AreTypesChecked() && checked && i < arguments.size(); i++)
+	{
+		checked = IsVariableType(arguments[i].type) && entry.Accepts(i, arguments[i].type);
+	}
+
+	if (checked)
+	{
+		// Sizes and lines of known types do not need the arguments of an internal function
+		if (n.GetName() == "Size" && arguments[0].type == TokenType::String)
+		{
+			result.code = "((int) " + arguments[0].code + ".size())";
+			result.sideEffects = arguments[0].sideEffects;
+			return result;
+		}
+		else if (n.GetName() == "Size" && IsVariableArrayType(arguments[0].type))
+		{
+			result.code = "((int) " + arguments[0].code + ".GetArraySize())";
+			result.sideEffects = arguments[0].sideEffects;
+			return result;
+		}
+		else if (n.GetName() == "WriteLine" && IsNative(arguments[0].type))
+		{
+			result.code = "Iona::Runtime::WriteLine(Iona::Runtime::ToString(" + arguments[0].code + "))";
+			return result;
+		}
+		else if ((n.GetName() == "Min" || n.GetName() == "Max") && arguments[0].type == arguments[1].type
+			&& IsNumberType(arguments[0].type))
+		{
+			result.type = arguments[0].type;
+		}
+		else if (n.GetName() == "Reverse" && IsVariableArrayType(arguments[0].type))
+		{
+			result.type = arguments[0].type;
+		}
+	}
+
+	// Initializer lists are evaluated in order, so the arguments do not need to be ordered
+	std::string values;
+	for (size_t i = 0; i < arguments.size(); i++)
+	{
+		values.append(i > 0 ? ", " : "").append(Boxed(arguments[i]).code);
+	}
+
+	std::string call;
+	if (checked)
+	{
+		call = "Iona::Runtime::Call(" + std::string(function.name) + ", { " + values + " })";
+	}
+	else
+	{
+		std::string masks;
+		for (size_t i = 0; i < entry.parameterTypes.size(); i++)
+		{
+			masks.append(i > 0 ? ", " : "").append(std::to_string(entry.parameterTypes[i])).append("ull");
+		}
+
+		call = "Iona::Runtime::CheckedCall(" + std::string(function.name) + ", " + line + ", " + Quote(n.GetName())
+			+ ", { " + masks + " }, { " + values + " })";
+	}
+
+	result.code = Unboxed(call, IsNative(result.type) ? result.type : TokenType::None);
+
+	return result;
+}
+
+std::string CppEmitter::TailCallAdapter(const FunctionNode& function)
+{
+	std::string name = "t_" + function.GetName();
+	if (this->adapted.insert(&function).second)
+	{
+		std::string values;
+		for (size_t i = 0; i < function.GetParameters().size(); i++)
+		{
+			values.append(i > 0 ? ", " : "").append("std::move(arguments[").append(std::to_string(i)).append("])");
+		}
+
+		this->adapters << "static Value " << name << "(std::vector<Value>& arguments)\n{\n";
+		this->adapters << "\treturn " << this->functionNames[&function] << "(" << values << ");\n}\n\n";
+	}
+
+	return name;
+}
+
+void CppEmitter::Visit(MainNode& n)
+{
+	this->scopes.emplace_back();
+	this->out = &this->initialization;
+	this->depth = 2;
+
+	for (auto& [name, value] : Iona::InternalVariables())
+	{
+		const CppVariable& variable = DeclareVariable(name, value.GetType());
+		std::string literal;
+		switch (value.GetType())
+		{
+			case TokenType::Int:
+				literal = IntLiteral(value.GetInt());
+				break;
+			case TokenType::Long:
+				literal = LongLiteral(value.GetLong());
+				break;
+			case TokenType::Double:
+				literal = DoubleLiteral(value.GetDouble());
+				break;
+			default:
+				literal = FloatLiteral(value.GetFloat());
+				break;
+		}
+
+		this->declarations << "static " << NativeType(variable.type) << " " << variable.name << " = " << literal << ";\n";
+	}
+
+	this->argsName = DeclareVariable("ARGS", TokenType::StringArray).name;
+	this->declarations << "static Value " << this->argsName << ";\n\n";
+
+	// Functions can be called before they are defined
+	for (const auto& globalFunction : n.GetGlobalFunctions())
+	{
+		auto& function = static_cast<FunctionNode&>(*globalFunction);
+		std::string name = "f_" + function.GetName();
+		this->functionNames[&function] = name;
+
+		std::string parameters;
+		for (size_t i = 0; i < function.GetParameters().size(); i++)
+		{
+			parameters.append(i > 0 ? ", " : "").append("Value");
+		}
+
+		this->declarations << "static Value " << name << "(" << parameters << ");\n";
+	}
+
+	// Parser has ensured that there is a main function at index zero
+	this->mainName = this->functionNames[static_cast<FunctionNode*>(n.GetGlobalFunctions()[0])];
+	this->declarations << "\n";
+
+	for (const auto& globalVariable : n.GetGlobalVariables())
+	{
+		Statement(globalVariable);
+	}
+
+	this->out = &this->functions;
+	this->depth = 0;
+
+	for (const auto& globalFunction : n.GetGlobalFunctions())
+	{
+		globalFunction->Accept(*this);
+	}
+
+}
+
+void CppEmitter::Visit(VariableDeclarationAssignNode& n)
+{
+	CppExpression value = Expression(n.GetExpression());
+
+	std::string code = value.code;
+	TokenType type = value.type;
+	if (!IsNative(type) && !IsVariableArrayType(type))
+	{
+		code = "Iona::Runtime::Declare(" + code + ", " + std::to_string(n.GetLine()) + ", " + Quote(n.GetName()) + ")";
+		type = TokenType::None;
+	}
+
+	const CppVariable& variable = DeclareVariable(n.GetName(), type);
+
+	// Global variables are initialized in order by the main of the C++ program
+	if (this->scopes.size() == 1)
+	{
+		this->declarations << "static " << NativeType(variable.type) << " " << variable.name << ";\n";
+		Line(variable.name + " = " + code + ";");
+	}
+	else
+	{
+		Line(NativeType(variable.type) + " " + variable.name + " = " + code + ";");
+	}
+}
+
+void CppEmitter::Visit(VariableArrayDeclarationAssignNode& n)
+{
+	TokenType elementType = GetArrayElementType(n.GetArrayType());
+
+	std::vector<CppExpression> values;
+	bool typed = true;
+	for (auto& value : n.GetValues())
+	{
+		values.push_back(Expression(value));
+		typed = typed && values.back().type == elementType;
+	}
+
+	std::string code;
+	if (typed)
+	{
+		// Values of the element type are stored without checking them
+		std::string elements;
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			elements.append(i > 0 ? ", " : "").append(elementType == TokenType::String ? Boxed(values[i]).code : values[i].code);
+		}
+
+		switch (elementType)
+		{
+			case TokenType::Int:
+				code = "Value(std::vector<int32_t>{ " + elements + " })";
+				break;
+			case TokenType::Float:
+				code = "Value(std::vector<float>{ " + elements + " })";
+				break;
+			case TokenType::Bool:
+				code = "Value(std::vector<bool>{ " + elements + " })";
+				break;
+			default:
+				code = "Value(TokenType::StringArray, std::vector<Value>{ " + elements + " })";
+				break;
+		}
+	}
+	else
+	{
+		std::string elements;
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			elements.append(i > 0 ? ", " : "").append(Boxed(values[i]).code);
+		}
+
+		code = "Iona::Runtime::NewArray(" + TokenTypeName(n.GetArrayType()) + ", { " + elements + " }, "
+			+ std::to_string(n.GetLine()) + ", " + Quote(n.GetName()) + ")";
+	}
+
+	const CppVariable& variable = DeclareVariable(n.GetName(), n.GetArrayType());
+
+	if (this->scopes.size() == 1)
+	{
+		this->declarations << "static Value " << variable.name << ";\n";
+		Line(variable.name + " = " + code + ";");
+	}
+	else
+	{
+		Line("Value " + variable.name + " = " + code + ";");
+	}
+}
+
+void CppEmitter::Visit(FunctionNode& n)
+{
+	std::ostringstream* functions = this->out;
+	std::ostringstream body;
+	this->out = &body;
+	this->currentFunction = &n;
+	this->selfTailCall = false;
+
+	this->scopes.emplace_back();
+
+	std::string parameters;
+	for (size_t i = 0; i < n.GetParameters().size(); i++)
+	{
+		parameters.append(i > 0 ? ", " : "").append("Value ").append(DeclareVariable(n.GetParameters()[i], TokenType::None).name);
+	}
+
+	this->depth = 1;
+	n.GetBlock()->Accept(*this);
+	this->depth = 0;
+
+	this->scopes.pop_back();
+	this->out = functions;
+
+	*this->out << "static Value " << this->functionNames[&n] << "(" << parameters << ")\n{\n";
+	*this->out << "\tIona::Runtime::CallFrame frame;\n";
+
+	// Calls of the function itself in a return continue at the start of it, like in the interpreter they do not grow the stack
+	if (this->selfTailCall)
+	{
+		*this->out << "tail_call:\n";
+	}
+
+	*this->out << body.str();
+
+	// Like in the interpreter, a function without a return statement returns nothing
+	*this->out << "\treturn Value();\n}\n\n";
+
+	this->currentFunction = nullptr;
+}
+
+void CppEmitter::Visit(FunctionCallNode& n)
+{
+	std::vector<CppExpression> arguments;
+	for (auto& parameter : n.GetParameters())
+	{
+		arguments.push_back(Expression(parameter));
+	}
+
+	FunctionNode* function = n.GetFunction();
+	if (function == nullptr)
+	{
+		this->expression = InternalCall(n, std::move(arguments));
+		return;
+	}
+
+	this->expression.sideEffects = true;
+
+	// Like in the interpreter, the arguments are not evaluated if their count is wrong
+	if (arguments.size() != function->GetParameters().size())
+	{
+		this->expression.code = "(Iona::Runtime::Fail(" + std::to_string(n.GetLine())
+			+ ", \"Function call parameter count (%i) is not matching expected parameter count (%i) of function '%s'\", "
+			+ std::to_string(arguments.size()) + ", " + std::to_string(function->GetParameters().size()) + ", "
+			+ Quote(n.GetName()) + "), Value())";
+		return;
+	}
+
+	// Arguments are evaluated one after another only if one has side effects another one could see
+	bool sideEffects = false;
+	size_t variables = 0;
+	for (const auto& argument : arguments)
+	{
+		sideEffects = sideEffects || argument.sideEffects;
+		variables += argument.constant ? 0 : 1;
+	}
+	bool ordered = sideEffects && variables > 1;
+
+	// The call depth is checked before the arguments are evaluated, like in the interpreter
+	const std::string& name = this->functionNames[function];
+	std::string check = "Iona::Runtime::CheckCallDepth(" + std::to_string(n.GetLine()) + ", " + Quote(n.GetName()) + ")";
+	if (ordered)
+	{
+		std::string code = "Iona::Runtime::Trampoline([&]() { " + check + "; ";
+		std::string values;
+		for (size_t i = 0; i < arguments.size(); i++)
+		{
+			code.append("Value argument").append(std::to_string(i)).append(" = ").append(Boxed(arguments[i]).code).append("; ");
+			values.append(i > 0 ? ", " : "").append("std::move(argument").append(std::to_string(i)).append(")");
+		}
+
+		this->expression.code = code + "return " + name + "(" + values + "); }())";
+	}
+	else
+	{
+		std::string values;
+		for (size_t i = 0; i < arguments.size(); i++)
+		{
+			values.append(i > 0 ? ", " : "").append(Boxed(arguments[i]).code);
+		}
+
+		this->expression.code = "Iona::Runtime::Trampoline((" + check + ", " + name + "(" + values + ")))";
+	}
+}
+
+void CppEmitter::Visit(ForEachNode& n)
+{
+	CppExpression array = Expression(n.GetExpression());
+	std::string arrayName = UniqueName("array", n.GetVariableName());
+	std::string elementName = UniqueName("element", n.GetVariableName());
+
+	Line("{");
+	this->depth++;
+
+	// The loop holds the array, writes to the array variable inside the block copy it
+	if (IsVariableArrayType(array.type))
+	{
+		Line("Value " + arrayName + " = " + array.code + ";");
+	}
+	else
+	{
+		Line("Value " + arrayName + " = Iona::Runtime::Iterable(" + Boxed(array).code + ", " + std::to_string(n.GetLine()) + ");");
+	}
+
+	TokenType elementType = GetArrayElementType(array.type);
+	this->scopes.emplace_back();
+	const CppVariable& variable = DeclareVariable(n.GetVariableName(), elementType);
+
+	switch (array.type)
+	{
+		case TokenType::IntArray:
+			Line("for (int32_t " + elementName + " : " + arrayName + ".GetIntArray())");
+			break;
+		case TokenType::FloatArray:
+			Line("for (float " + elementName + " : " + arrayName + ".GetFloatArray())");
+			break;
+		case TokenType::BoolArray:
+			Line("for (bool " + elementName + " : " + arrayName + ".GetBoolArray())");
+			break;
+		case TokenType::StringArray:
+			Line("for (const Value& " + elementName + " : " + arrayName + ".GetStringArray())");
+			break;
+		default:
+			Line("for (size_t " + elementName + " = 0; " + elementName + " < " + arrayName + ".GetArraySize(); " + elementName + "++)");
+			break;
+	}
+
+	Line("{");
+	this->depth++;
+
+	switch (array.type)
+	{
+		case TokenType::IntArray:
+		case TokenType::FloatArray:
+		case TokenType::BoolArray:
+			Line(NativeType(elementType) + " " + variable.name + " = " + elementName + ";");
+			break;
+		case TokenType::StringArray:
+			Line("std::string " + variable.name + " = " + elementName + ".GetString();");
+			break;
+		default:
+			Line("Value " + variable.name + " = " + arrayName + ".GetArrayElement(" + elementName + ");");
+			break;
+	}
+
+	n.GetBlock()->Accept(*this);
+
+	this->depth--;
+	Line("}");
+
+	this->scopes.pop_back();
+	this->depth--;
+	Line("}");
+}
+
+void CppEmitter::Visit(ForINode& n)
+{
+	std::string counter = UniqueName("i", n.GetVariableName());
+
+	this->scopes.emplace_back();
+	const CppVariable& variable = DeclareVariable(n.GetVariableName(), TokenType::Int);
+
+	Line("for (int " + counter + " = " + IntLiteral(n.GetFrom()) + "; " + counter + " < " + IntLiteral(n.GetTo()) + "; "
+		+ counter + " += " + IntLiteral(n.GetStep()) + ")");
+	Line("{");
+	this->depth++;
+
+	// Like in the interpreter, the block can change the variable but not the counter
+	Line("int " + variable.name + " = " + counter + ";");
+
+	n.GetBlock()->Accept(*this);
+
+	this->depth--;
+	Line("}");
+	this->scopes.pop_back();
+}
+
+void CppEmitter::Visit(BlockNode& n)
+{
+	for (auto& statement : n.GetStatements())
+	{
+		Statement(statement);
+	}
+}
+
+void CppEmitter::Visit(BinaryNode& n)
+{
+	CppExpression left = Expression(n.GetLeft());
+	CppExpression right = Expression(n.GetRight());
+
+	std::string line = std::to_string(n.GetLine());
+	std::string operant = ArithmeticOperator(n.GetOperant());
+
+	bool numbers = left.type == right.type && IsNumberType(left.type);
+	bool strings = left.type == TokenType::String && right.type == TokenType::String && n.GetOperant() == TokenType::Plus;
+	const char* wrapping = WrappingOperation(n.GetOperant());
+
+	if (numbers && (left.type == TokenType::Int || left.type == TokenType::Long) && wrapping != nullptr)
+	{
+		this->expression = Ordered(left, right, left.type, [&](const std::string& l, const std::string& r)
+		{
+			return std::string(wrapping) + "<" + NativeType(left.type) + ">()(" + l + ", " + r + ")";
+		});
+	}
+	else if (numbers || strings)
+	{
+		this->expression = Ordered(left, right, left.type, [&](const std::string& l, const std::string& r)
+		{
+			return "(" + l + " " + operant + " " + r + ")";
+		});
+	}
+	else
+	{
+		// Mixed or unknown types are checked while executing, mixed types do not have a result
+		this->expression = Ordered(Boxed(left), Boxed(right), TokenType::None, [&](const std::string& l, const std::string& r)
+		{
+			return "Iona::Runtime::Arithmetic(" + TokenTypeName(n.GetOperant()) + ", " + l + ", " + r + ", " + line + ")";
+		});
+	}
+}
+
+void CppEmitter::Visit(BooleanNode& n)
+{
+	CppExpression left = Expression(n.GetLeft());
+	CppExpression right = Expression(n.GetRight());
+
+	std::string operant = ComparisonOperator(n.GetOperant());
+
+	bool numbers = IsNumberType(left.type) && IsNumberType(right.type);
+	bool strings = left.type == TokenType::String && right.type == TokenType::String
+		&& (n.GetOperant() == TokenType::Equals || n.GetOperant() == TokenType::NotEquals);
+
+	if (numbers || strings)
+	{
+		this->expression = Ordered(left, right, TokenType::Bool, [&](const std::string& l, const std::string& r)
+		{
+			return "(" + l + " " + operant + " " + r + ")";
+		});
+	}
+	else
+	{
+		// Bools and values of different types are never equal, Compare handles them
+		this->expression = Ordered(Boxed(left), Boxed(right), TokenType::Bool, [&](const std::string& l, const std::string& r)
+		{
+			return l + ".Compare(" + TokenTypeName(n.GetOperant()) + ", " + r + ")";
+		});
+	}
+}
+
+void CppEmitter::Visit(IfNode& n)
+{
+	Line("if (" + Condition(Expression(n.GetExpression()), n.GetLine(), "an if") + ")");
+	Block(n.GetTrueBlock());
+
+	for (const auto& [expression, block] : n.GetElseIfBlocks())
+	{
+		Line("else if (" + Condition(Expression(expression), n.GetLine(), "an if") + ")");
+		Block(block);
+	}
+
+	if (n.GetElseBlock() != nullptr)
+	{
+		Line("else");
+		Block(n.GetElseBlock());
+	}
+}
+
+void CppEmitter::Visit(WhileNode& n)
+{
+	Line("while (" + Condition(Expression(n.GetExpression()), n.GetLine(), "a while") + ")");
+	Block(n.GetBlock());
+}
+
+void CppEmitter::Visit(DoWhileNode& n)
+{
+	// The expression sees the variables of the block, so it is evaluated inside of it
+	Line("while (true)");
+	Line("{");
+	this->depth++;
+	this->scopes.emplace_back();
+
+	n.GetBlock()->Accept(*this);
+
+	Line("if (!" + Condition(Expression(n.GetExpression()), n.GetLine(), "a do while") + ")");
+	Line("{");
+	Line("\tbreak;");
+	Line("}");
+
+	this->scopes.pop_back();
+	this->depth--;
+	Line("}");
+}
+
+void CppEmitter::Visit(ReturnNode& n)
+{
+	FunctionCallNode* call = n.GetTailCall();
+	if (call != nullptr && call->GetFunction() == this->currentFunction
+		&& call->GetParameters().size() == this->currentFunction->GetParameters().size())
+	{
+		// The arguments are evaluated before any parameter is overwritten
+		std::vector<std::string> arguments;
+		Line("{");
+		this->depth++;
+
+		for (auto& parameter : call->GetParameters())
+		{
+			arguments.push_back(UniqueName("argument", this->currentFunction->GetName()));
+			Line("Value " + arguments.back() + " = " + Boxed(Expression(parameter)).code + ";");
+		}
+
+		for (size_t i = 0; i < arguments.size(); i++)
+		{
+			Line(ResolveVariable(this->currentFunction->GetParameters()[i]).name + " = std::move(" + arguments[i] + ");");
+		}
+
+		Line("goto tail_call;");
+
+		this->depth--;
+		Line("}");
+
+		this->selfTailCall = true;
+		return;
+	}
+
+	if (call != nullptr && call->GetParameters().size() == call->GetFunction()->GetParameters().size())
+	{
+		// The caller executes the call after this function returned
+		std::string values;
+		for (auto& parameter : call->GetParameters())
+		{
+			values.append(values.empty() ? "" : ", ").append(Boxed(Expression(parameter)).code);
+		}
+
+		Line("{");
+		Line("\tIona::Runtime::tailCallArguments = { " + values + " };");
+		Line("\tIona::Runtime::tailCall = " + TailCallAdapter(*call->GetFunction()) + ";");
+		Line("\treturn Value();");
+		Line("}");
+		return;
+	}
+
+	Line("return " + Boxed(Expression(n.GetExpression())).code + ";");
+}
+
+void CppEmitter::Visit(StringNode& n)
+{
+	this->expression.type = TokenType::String;
+
+	if (n.GetExpressions().empty())
+	{
+		this->expression.code = "std::string(" + Quote(n.GetValue()) + ")";
+		this->expression.constant = true;
+		return;
+	}
+
+	// The parts between the expressions are found in the order the interpreter replaces them
+	std::string parts;
+	size_t start = 0;
+	for (auto& expression : n.GetExpressions())
+	{
+		size_t index = n.GetValue().find("$R$", start);
+		CppExpression value = Expression(expression);
+
+		parts.append(Quote(n.GetValue().substr(start, index - start))).append(", ");
+		parts.append("Iona::Runtime::ToString(").append(value.code).append("), ");
+
+		this->expression.sideEffects = this->expression.sideEffects || value.sideEffects;
+		start = index + 3;
+	}
+	parts.append(Quote(n.GetValue().substr(start)));
+
+	this->expression.type = TokenType::String;
+	this->expression.code = "Iona::Runtime::Concat({ " + parts + " })";
+}
+
+void CppEmitter::Visit(IntNode& n)
+{
+	this->expression.code = IntLiteral(n.GetValue());
+	this->expression.type = TokenType::Int;
+	this->expression.constant = true;
+}
+
+void CppEmitter::Visit(FloatNode& n)
+{
+	this->expression.code = FloatLiteral(n.GetValue());
+	this->expression.type = TokenType::Float;
+	this->expression.constant = true;
+}
+
+void CppEmitter::Visit(LongNode& n)
+{
+	this->expression.code = LongLiteral(n.GetValue());
+	this->expression.type = TokenType::Long;
+	this->expression.constant = true;
+}
+
+void CppEmitter::Visit(DoubleNode& n)
+{
+	this->expression.code = DoubleLiteral(n.GetValue());
+	this->expression.type = TokenType::Double;
+	this->expression.constant = true;
+}
+
+void CppEmitter::Visit(BoolNode& n)
+{
+	this->expression.code = n.GetValue() ? "true" : "false";
+	this->expression.type = TokenType::Bool;
+	this->expression.constant = true;
+}
+
+void CppEmitter::Visit(VariableUsageNode& n)
+{
+	const CppVariable& variable = ResolveVariable(n.GetName());
+
+	this->expression.code = variable.name;
+	this->expression.type = variable.type;
+}
+
+void CppEmitter::Visit(VariableAssignNode& n)
+{
+	CppExpression value = Expression(n.GetExpression());
+	const CppVariable& variable = ResolveVariable(n.GetName());
+
+	if (value.type == variable.type && variable.type != TokenType::None)
+	{
+		Line(variable.name + " = " + value.code + ";");
+	}
+	else if (IsNative(variable.type))
+	{
+		Line(variable.name + " = Iona::Runtime::AssignAs<" + NativeType(variable.type) + ">(" + Boxed(value).code + ", "
+			+ std::to_string(n.GetLine()) + ", " + Quote(n.GetName()) + ");");
+	}
+	else
+	{
+		Line("Iona::Runtime::Assign(" + variable.name + ", " + Boxed(value).code + ", " + std::to_string(n.GetLine()) + ", "
+			+ Quote(n.GetName()) + ");");
+	}
+}
+
+void CppEmitter::Visit(VariableArrayUsageNode& n)
+{
+	const CppVariable& variable = ResolveVariable(n.GetName());
+	std::string arguments = std::to_string(n.GetIndex()) + ", " + std::to_string(n.GetLine());
+
+	if (IsVariableArrayType(variable.type))
+	{
+		TokenType elementType = GetArrayElementType(variable.type);
+
+		this->expression.code = "Iona::Runtime::ElementAs<" + NativeType(elementType) + ">(" + variable.name + ", " + arguments + ")";
+		this->expression.type = elementType;
+	}
+	else
+	{
+		this->expression.code = "Iona::Runtime::Element(" + Boxed({ variable.name, variable.type }).code + ", " + arguments + ")";
+	}
+}
+
+void CppEmitter::Visit(VariableArrayAssignNode& n)
+{
+	CppExpression value = Expression(n.GetExpression());
+	const CppVariable& variable = ResolveVariable(n.GetName());
+
+	std::string arguments = std::to_string(n.GetIndex()) + ", " + Boxed(value).code + ", " + std::to_string(n.GetLine()) + ", " + Quote(n.GetName());
+
+	if (IsVariableArrayType(variable.type) && GetArrayElementType(variable.type) == value.type)
+	{
+		Line("Iona::Runtime::SetElementAs<" + NativeType(value.type) + ">(" + variable.name + ", " + std::to_string(n.GetIndex()) + ", "
+			+ value.code + ", " + std::to_string(n.GetLine()) + ");");
+	}
+	else if (IsNative(variable.type))
+	{
+		// Fails like in the interpreter, the variable is not an array
+		Line("{");
+		Line("\tValue array(" + variable.name + ");");
+		Line("\tIona::Runtime::SetElement(array, " + arguments + ");");
+		Line("}");
+	}
+	else
+	{
+		Line("Iona::Runtime::SetElement(" + variable.name + ", " + arguments + ");");
+	}
+}
+
+void CppEmitter::Visit(VariableIncrementDecrementNode& n)
+{
+	const CppVariable& variable = ResolveVariable(n.GetName());
+
+	this->expression.sideEffects = true;
+	this->expression.type = variable.type;
+
+	if (variable.type == TokenType::Int)
+	{
+		this->expression.code = "(" + variable.name + " += " + IntLiteral(n.GetValue()) + ")";
+	}
+	else if (variable.type == TokenType::Float)
+	{
+		this->expression.code = "(" + variable.name + " += " + FloatLiteral((float) n.GetValue()) + ")";
+	}
+	else if (variable.type == TokenType::Long)
+	{
+		this->expression.code = "(" + variable.name + " += " + LongLiteral(n.GetValue()) + ")";
+	}
+	else if (variable.type == TokenType::Double)
+	{
+		this->expression.code = "(" + variable.name + " += " + DoubleLiteral(n.GetValue()) + ")";
+	}
+	else if (IsNative(variable.type))
+	{
+		// Fails like in the interpreter, only numbers can be incremented
+		this->expression.code = "[&]() { Value variable(" + variable.name + "); return Iona::Runtime::Increment(variable, "
+			+ IntLiteral(n.GetValue()) + ", " + std::to_string(n.GetLine()) + "); }()";
+		this->expression.type = TokenType::None;
+	}
+	else
+	{
+		this->expression.code = "Iona::Runtime::Increment(" + variable.name + ", " + IntLiteral(n.GetValue()) + ", "
+			+ std::to_string(n.GetLine()) + ")";
+		this->expression.type = TokenType::None;
+	}
+}
+
+void CppEmitter::Visit(VariableCompoundAssignNode& n)
+{
+	CppExpression value = Expression(n.GetExpression());
+	const CppVariable& variable = ResolveVariable(n.GetName());
+
+	std::string operation = TokenTypeName(n.GetOperation());
+	std::string arguments = std::to_string(n.GetLine()) + ", " + Quote(n.GetName());
+
+	const char* wrapping = WrappingOperation(n.GetOperation());
+
+	if (value.type == variable.type && (variable.type == TokenType::Int || variable.type == TokenType::Long) && wrapping != nullptr)
+	{
+		// Like for the compound operator, the value is evaluated before the variable is read
+		Line("{");
+		Line("\t" + NativeType(variable.type) + " value = " + value.code + ";");
+		Line("\t" + variable.name + " = " + wrapping + "<" + NativeType(variable.type) + ">()(" + variable.name + ", value);");
+		Line("}");
+	}
+	else if (value.type == variable.type && IsNumberType(variable.type))
+	{
+		Line(variable.name + " " + ArithmeticOperator(n.GetOperation()) + "= " + value.code + ";");
+	}
+	else if (IsNative(variable.type))
+	{
+		// The expression is evaluated before the variable is read
+		Line("{");
+		Line("\tValue value = " + Boxed(value).code + ";");
+		Line("\tValue variable(" + variable.name + ");");
+		Line("\tIona::Runtime::CompoundAssign(variable, " + operation + ", value, " + arguments + ");");
+		Line("\t" + variable.name + " = Iona::Runtime::As<" + NativeType(variable.type) + ">(variable);");
+		Line("}");
+	}
+	else
+	{
+		Line("Iona::Runtime::CompoundAssign(" + variable.name + ", " + operation + ", " + Boxed(value).code + ", " + arguments + ");");
+	}
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <SemanticAnalyzer.h>
+#include "Lexer.h"
+#include "MappedFile.h"
+#include "Parser.h"
+#include "Optimizer.h"
+#include "CppEmitter.h"
+#include "Vm/BytecodeCompiler.h"
+#include "Vm/ProgramContainer.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <spawn.h>
+#include <sys/wait.h>
+#define IONA_SPAWN_SUPPORTED
+extern char** environ;
+#endif
+
+// Runs the C++ compiler with its arguments as they are, without a shell which would interpret them
+static bool RunCompiler(const std::vector<std::string>& arguments)
+{
+#ifdef IONA_SPAWN_SUPPORTED
+	std::vector<char*> argv;
+	for (const auto& argument : arguments)
+	{
+		argv.push_back(const_cast<char*>(argument.c_str()));
+	}
+	argv.push_back(nullptr);
+
+	pid_t pid;
+	if (posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ) != 0)
+	{
+		return false;
+	}
+
+	int status;
+	while (waitpid(pid, &status, 0) == -1)
+	{
+		if (errno != EINTR)
+		{
+			return false;
+		}
+	}
+
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#else
+	// Without posix_spawn the command goes through the shell, quotes can not be escaped there
+	std::string command;
+	for (const auto& argument : arguments)
+	{
+		if (argument.find('"') != std::string::npos)
+		{
+			return false;
+		}
+		command += (command.empty() ? "\"" : " \"") + argument + "\"";
+	}
+
+	return std::system(command.c_str()) == 0;
+#endif
+}
+
+int main(int argc, char const* argv[])
+{
+	// Options are given before the source file, eg. 'ionac --build --output=hello Main.ion'.
+	// '--container' compiles to bytecode for ionai, the other modes translate to C++.
+	int fileIndex = 1;
+	std::string mode;
+	std::string output;
+	bool optimize = true;
+	// Zero keeps the default of the tree walking interpreter
+	int maxCallDepth = 0;
+	for (; fileIndex < argc && Helper::StartsWith(argv[fileIndex], "-"); fileIndex++)
+	{
+		std::string option = argv[fileIndex];
+
+		if (option == "--emit-c" || option == "--build" || option == "--container")
+		{
+			mode = option.substr(2);
+		}
+		else if (option == "-O0" || option == "-O1")
+		{
+			optimize = option == "-O1";
+		}
+		else if (Helper::StartsWith(option, "--output="))
+		{
+			output = option.substr(9);
+		}
+		else if (Helper::StartsWith(option, "--max-call-depth="))
+		{
+			if (!ParsePositive(std::string_view(option).substr(17), maxCallDepth))
+			{
+				std::cout << "Maximum call depth needs to be a positive number ('" << option << "')" << std::endl;
+				return EXIT_FAILURE;
+			}
+		}
+		else
+		{
+			std::cout << "Unknown option '" << option << "', supported are '--emit-c', '--build', '--container', '-O0', '-O1', '--output=<file>' and '--max-call-depth=<n>'" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (mode.empty() || fileIndex != argc - 1)
+	{
+		std::cout << "Usage: ionac --emit-c|--build|--container [-O0] [--output=<file>] [--max-call-depth=<n>] Main.ion" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Containers run on the virtual machine, translated programs recurse on the native stack like the tree walker
+	if (mode != "container" && maxCallDepth > Interpreter::MaxCallDepth)
+	{
+		std::cout << "Maximum call depth of translated programs is " << Interpreter::MaxCallDepth
+			<< ", deeper recursion needs '--container' and the virtual machine ('--max-call-depth=" << maxCallDepth << "')" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const char* fileName = argv[fileIndex];
+
+	if (!Helper::EndsWith(fileName, ".ion") && !Helper::EndsWith(fileName, ".iona"))
+	{
+		std::cout << "Source files for iona must end with '.ion' or '.iona' ('" << fileName << "')" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (!std::filesystem::exists(fileName))
+	{
+		std::cout << "Source file '" << fileName << "' does not exist" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// The C++ source is written next to the program, which is named like the source file
+	std::filesystem::path program = output.empty() ? std::filesystem::path(fileName).replace_extension() : std::filesystem::path(output);
+	if (mode == "container" && output.empty())
+	{
+		program.replace_extension(ProgramContainer::Extension);
+	}
+	std::filesystem::path cppFile = mode == "emit-c" ? program : std::filesystem::path(program).concat(".cpp");
+	if (mode == "emit-c" && output.empty())
+	{
+		cppFile.replace_extension(".cpp");
+	}
+
+	MappedFile source(fileName);
+	if (!source.IsValid())
+	{
+		std::cout << "Source file '" << fileName << "' could not be read" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Errors of the translated program name the same file as the ones of the interpreter
+	Lexer lexer(source.GetContent(), "Main.ion");
+	Parser parser(lexer);
+
+	try
+	{
+		Ref<Node> astRoot = parser.Parse();
+
+		Ref<SemanticAnalyzer> semanticAnalyzer = std::make_shared<SemanticAnalyzer>(astRoot);
+		semanticAnalyzer->Analyze();
+
+		if (optimize)
+		{
+			Optimizer optimizer(astRoot, parser.GetArena());
+			optimizer.Optimize();
+		}
+
+		if (mode == "container")
+		{
+			// The call depth is limited by ionai when the program runs
+			Ref<BytecodeCompiler> compiler = std::make_shared<BytecodeCompiler>(astRoot);
+
+			std::ofstream out(program, std::ios::binary);
+			ProgramContainer::Write(*compiler->Compile(), out);
+			out.close();
+
+			if (!out)
+			{
+				std::cerr << "Program container '" << program.string() << "' could not be written" << std::endl;
+				return EXIT_FAILURE;
+			}
+
+			return EXIT_SUCCESS;
+		}
+
+		std::ofstream out(cppFile);
+		CppEmitter::WriteRuntime(out);
+
+		CppEmitter emitter(astRoot, "Main.ion");
+		if (maxCallDepth > 0)
+		{
+			emitter.SetMaxCallDepth(maxCallDepth);
+		}
+		emitter.Emit(out);
+		out.close();
+
+		if (!out)
+		{
+			std::cerr << "C++ source '" << cppFile.string() << "' could not be written" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+
+		return EXIT_FAILURE;
+	}
+
+	if (mode == "emit-c")
+	{
+		return EXIT_SUCCESS;
+	}
+
+	// Translated int arithmetic wraps around by itself (see WrappingPlus in Value.h), so the C++ source
+	// is correct with any flags. -fwrapv only guards against signed overflow the translation missed.
+	// CXX may hold a launcher and flags too (eg. 'ccache c++'), they are separated by spaces like in make
+	std::vector<std::string> arguments;
+	std::istringstream compiler(std::getenv("CXX") != nullptr ? std::getenv("CXX") : "");
+	for (std::string argument; compiler >> argument;)
+	{
+		arguments.push_back(argument);
+	}
+	if (arguments.empty())
+	{
+		arguments.emplace_back("c++");
+	}
+	arguments.insert(arguments.end(), { "-std=c++17", "-O2", "-fwrapv", "-o", program.string(), cppFile.string() });
+
+	if (!RunCompiler(arguments))
+	{
+		std::string command;
+		for (const auto& argument : arguments)
+		{
+			command += (command.empty() ? "" : " ") + argument;
+		}
+
+		std::cerr << "Building '" << program.string() << "' failed: " << command << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::filesystem::remove(cppFile);
+
+	return EXIT_SUCCESS;
+}
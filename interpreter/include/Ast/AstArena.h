@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef AST_ARENA_H
+#define AST_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "Node.h"
+
+// Fixed size list of children, which lives inside the arena of its node
+template <typename T>
+class NodeList
+{
+private:
+	T* values = nullptr;
+	size_t count = 0;
+public:
+	NodeList() = default;
+	NodeList(T* values, size_t count) : values(values), count(count) { }
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	T& operator[](size_t index) const
+	{
+		return values[index];
+	}
+
+	T* begin() const
+	{
+		return values;
+	}
+
+	T* end() const
+	{
+		return values + count;
+	}
+};
+
+// Owns all nodes of one parse result. The nodes are allocated one after another
+// in large blocks in the order they are parsed and are freed together with the arena.
+class AstArena
+{
+private:
+	static constexpr size_t BlockSize = 64 * 1024;
+
+	std::vector<std::unique_ptr<char[]>> blocks;
+	char* current = nullptr;
+	size_t remaining = 0;
+
+	// Nodes still own strings (names, literals), so their destructors have to run
+	std::vector<Node*> nodes;
+
+	void* Allocate(size_t size, size_t alignment);
+public:
+	AstArena() = default;
+	AstArena(const AstArena&) = delete;
+	AstArena& operator=(const AstArena&) = delete;
+	~AstArena();
+
+	template <typename T, typename ...Args>
+	T* New(Args&&... args)
+	{
+		T* node = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		this->nodes.push_back(node);
+
+		return node;
+	}
+
+	template <typename T>
+	NodeList<T> NewList(const std::vector<T>& values)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "Node list values are never destructed");
+
+		if (values.empty())
+		{
+			return NodeList<T>();
+		}
+
+		T* list = static_cast<T*>(Allocate(sizeof(T) * values.size(), alignof(T)));
+		std::uninitialized_copy(values.begin(), values.end(), list);
+
+		return NodeList<T>(list, values.size());
+	}
+};
+
+#endif
@@ -11,34 +11,64 @@
 #include <vector>
 #include "Node.h"
 #include "Token.h"
+#include "TypedOperations.h"
 
-class BinaryNode : public Node, public std::enable_shared_from_this<BinaryNode>
+class BinaryNode : public Node
 {
 private:
-	Ref<Node> left;
+	Node* left;
 	TokenType operant;
-	Ref<Node> right;
+	Node* right;
+	// Set by the semantic analyzer if it has proven the types of both operands
+	BinaryOperation typedOperation = nullptr;
+	// Otherwise the interpreter caches the operation for the operand types of the last evaluation
+	InlineCache inlineCache;
 public:
-	BinaryNode(const Ref<Node>& left, const TokenType& operant, const Ref<Node>& right);
+	BinaryNode(Node* left, const TokenType& operant, Node* right);
 
 	~BinaryNode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	Ref<Node> GetLeft() const
+	Node* GetLeft() const
 	{
 		return left;
 	}
 
+	void SetLeft(Node* left)
+	{
+		this->left = left;
+	}
+
 	TokenType GetOperant() const
 	{
 		return operant;
 	}
 
-	Ref<Node> GetRight() const
+	Node* GetRight() const
 	{
 		return right;
 	}
+
+	void SetRight(Node* right)
+	{
+		this->right = right;
+	}
+
+	BinaryOperation GetTypedOperation() const
+	{
+		return typedOperation;
+	}
+
+	void SetTypedOperation(BinaryOperation typedOperation)
+	{
+		this->typedOperation = typedOperation;
+	}
+
+	InlineCache& GetInlineCache()
+	{
+		return inlineCache;
+	}
 };
 
 #endif
@@ -11,23 +11,29 @@
 #include <vector>
 #include <string>
 #include "Node.h"
+#include "AstArena.h"
 #include "Token.h"
 
-class BlockNode : public Node, public std::enable_shared_from_this<BlockNode>
+class BlockNode : public Node
 {
 private:
-	std::vector<Ref<Node>> statements;
+	NodeList<Node*> statements;
 public:
-	BlockNode(std::vector<Ref<Node>> statements);
+	BlockNode(NodeList<Node*> statements);
 
 	~BlockNode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::vector<Ref<Node>> GetStatements()
+	const NodeList<Node*>& GetStatements() const
 	{
 		return statements;
 	}
+
+	void SetStatements(NodeList<Node*> statements)
+	{
+		this->statements = statements;
+	}
 };
 
 #endif
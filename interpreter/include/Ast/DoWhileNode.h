@@ -10,24 +10,29 @@
 
 #include "Node.h"
 
-class DoWhileNode : public Node, public std::enable_shared_from_this<DoWhileNode>
+class DoWhileNode : public Node
 {
 private:
-	Ref<Node> expression;
-	Ref<Node> block;
+	Node* expression;
+	Node* block;
 public:
-	DoWhileNode(const std::string& fileName, int line, const Ref<Node>& expression, const Ref<Node>& block);
+	DoWhileNode(uint32_t fileId, int line, Node* expression, Node* block);
 
 	~DoWhileNode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	Ref<Node> GetExpression() const
+	Node* GetExpression() const
 	{
 		return expression;
 	}
 
-	Ref<Node> GetBlock() const
+	void SetExpression(Node* expression)
+	{
+		this->expression = expression;
+	}
+
+	Node* GetBlock() const
 	{
 		return block;
 	}
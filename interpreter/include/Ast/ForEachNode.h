@@ -10,32 +10,38 @@
 
 #include <string>
 #include "Node.h"
+#include "ResolvedVariable.h"
 #include "Token.h"
 
-class ForEachNode : public Node, public std::enable_shared_from_this<ForEachNode>
+class ForEachNode : public Node, public ResolvedVariable
 {
 private:
 	std::string variableName;
-	Ref<Node> expression;
-	Ref<Node> block;
+	Node* expression;
+	Node* block;
 public:
-	ForEachNode(const std::string& fileName, int line, std::string variableName, const Ref<Node>& expression, const Ref<Node>& block);
+	ForEachNode(uint32_t fileId, int line, std::string variableName, Node* expression, Node* block);
 
 	~ForEachNode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetVariableName() const
+	const std::string& GetVariableName() const
 	{
 		return variableName;
 	}
 
-	Ref<Node> GetExpression() const
+	Node* GetExpression() const
 	{
 		return expression;
 	}
 
-	Ref<Node> GetBlock() const
+	void SetExpression(Node* expression)
+	{
+		this->expression = expression;
+	}
+
+	Node* GetBlock() const
 	{
 		return block;
 	}
@@ -10,23 +10,24 @@
 
 #include <string>
 #include "Node.h"
+#include "ResolvedVariable.h"
 
-class ForINode : public Node, public std::enable_shared_from_this<ForINode>
+class ForINode : public Node, public ResolvedVariable
 {
 private:
 	std::string variableName;
 	int from;
 	int to;
 	int step;
-	Ref<Node> block;
+	Node* block;
 public:
-	ForINode(const std::string& fileName, int line, std::string variableName, int from, int to, int step, const Ref<Node>& block);
+	ForINode(uint32_t fileId, int line, std::string variableName, int from, int to, int step, Node* block);
 
 	~ForINode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetVariableName() const
+	const std::string& GetVariableName() const
 	{
 		return variableName;
 	}
@@ -46,7 +47,7 @@ public:
 		return step;
 	}
 
-	Ref<Node> GetBlock() const
+	Node* GetBlock() const
 	{
 		return block;
 	}
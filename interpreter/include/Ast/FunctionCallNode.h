@@ -11,29 +11,65 @@
 #include <vector>
 #include <string>
 #include "Node.h"
+#include "AstArena.h"
 #include "Token.h"
 
-class FunctionCallNode : public Node, public std::enable_shared_from_this<FunctionCallNode>
+class FunctionNode;
+struct FunctionEntry;
+
+class FunctionCallNode : public Node
 {
 private:
 	std::string name;
-	std::vector<Ref<Node>> parameters;
+	NodeList<Node*> parameters;
+
+	// Resolved by the semantic analyzer, either a function of the program or an internal function
+	FunctionNode* function = nullptr;
+	const FunctionEntry* internalFunction = nullptr;
+	// The argument types are known to be accepted by the internal function, so they are not checked at runtime
+	bool typesChecked = false;
 public:
-	FunctionCallNode(const std::string& fileName, int line, std::string name, std::vector<Ref<Node>> parameters);
+	FunctionCallNode(uint32_t fileId, int line, std::string name, NodeList<Node*> parameters);
 
 	~FunctionCallNode() override = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetName() const
+	const std::string& GetName() const
 	{
 		return name;
 	}
 
-	std::vector<Ref<Node>> GetParameters()
+	const NodeList<Node*>& GetParameters() const
 	{
 		return parameters;
 	}
+
+	void Resolve(FunctionNode* function)
+	{
+		this->function = function;
+	}
+
+	void Resolve(const FunctionEntry* internalFunction, bool typesChecked)
+	{
+		this->internalFunction = internalFunction;
+		this->typesChecked = typesChecked;
+	}
+
+	FunctionNode* GetFunction() const
+	{
+		return function;
+	}
+
+	const FunctionEntry* GetInternalFunction() const
+	{
+		return internalFunction;
+	}
+
+	bool AreTypesChecked() const
+	{
+		return typesChecked;
+	}
 };
 
 #endif
\ No newline at end of file
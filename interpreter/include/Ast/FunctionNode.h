@@ -10,36 +10,75 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include "Node.h"
 #include "Token.h"
 
-class FunctionNode : public Node, public std::enable_shared_from_this<FunctionNode>
+class FunctionNode : public Node
 {
 private:
 	std::string name;
-	Ref<Node> block;
+	// nullptr until the body of a lazily parsed function is loaded
+	Node* block;
 	std::vector<std::string> parameters;
+	// Source of the body (including its curly brackets) and its first line, if the parser skipped it
+	std::string_view body;
+	int bodyLine = 0;
+	// Number of variable slots of the function frame, parameters are the first ones
+	int frameSize = 0;
 public:
-	FunctionNode(const std::string& fileName, int line, std::string name, Ref<Node> block, std::vector<std::string> parameters);
+	FunctionNode(uint32_t fileId, int line, std::string name, Node* block, std::vector<std::string> parameters);
+	// Function whose body was only pre-parsed, it is parsed on its first call (see FunctionLoader)
+	FunctionNode(uint32_t fileId, int line, std::string name, std::string_view body, int bodyLine, std::vector<std::string> parameters);
 
 	~FunctionNode() override = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetName() const
+	const std::string& GetName() const
 	{
 		return name;
 	}
 
-	Ref<Node> GetBlock()
+	Node* GetBlock() const
 	{
 		return block;
 	}
 
-	std::vector<std::string> GetParameters()
+	void SetBlock(Node* block)
+	{
+		this->block = block;
+	}
+
+	bool IsParsed() const
+	{
+		return block != nullptr;
+	}
+
+	std::string_view GetBody() const
+	{
+		return body;
+	}
+
+	int GetBodyLine() const
+	{
+		return bodyLine;
+	}
+
+	const std::vector<std::string>& GetParameters() const
 	{
 		return parameters;
 	}
+
+	void SetFrameSize(int frameSize)
+	{
+		this->frameSize = frameSize;
+	}
+
+	int GetFrameSize() const
+	{
+		return frameSize;
+	}
 };
 
 #endif
\ No newline at end of file
@@ -10,39 +10,45 @@
 
 #include <string>
 #include "Node.h"
+#include "AstArena.h"
 #include "Token.h"
-#include <map>
+#include <vector>
 
-class IfNode : public Node, public std::enable_shared_from_this<IfNode>
+class IfNode : public Node
 {
 private:
-	Ref<Node> expression;
-	Ref<Node> trueBlock;
-	std::map<Ref<Node>, Ref<Node>> elseIfBlocks;
-	Ref<Node> elseBlock;
+	Node* expression;
+	Node* trueBlock;
+	NodeList<std::pair<Node*, Node*>> elseIfBlocks;
+	Node* elseBlock;
 public:
-	IfNode(const std::string& fileName, int line, const Ref<Node>& expression, const Ref<Node>& trueBlock, std::map<Ref<Node>, Ref<Node>> elseIfBlocks, const Ref<Node>& elseBlock);
+	IfNode(uint32_t fileId, int line, Node* expression, Node* trueBlock, NodeList<std::pair<Node*, Node*>> elseIfBlocks, Node* elseBlock);
 
 	~IfNode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	Ref<Node> GetExpression() const
+	Node* GetExpression() const
 	{
 		return expression;
 	}
 
-	Ref<Node> GetTrueBlock() const
+	void SetExpression(Node* expression)
+	{
+		this->expression = expression;
+	}
+
+	Node* GetTrueBlock() const
 	{
 		return trueBlock;
 	}
 
-	std::map<Ref<Node>, Ref<Node>> GetElseIfBlocks() const
+	const NodeList<std::pair<Node*, Node*>>& GetElseIfBlocks() const
 	{
 		return elseIfBlocks;
 	}
 
-	Ref<Node> GetElseBlock() const
+	Node* GetElseBlock() const
 	{
 		return elseBlock;
 	}
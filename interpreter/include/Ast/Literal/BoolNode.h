@@ -10,15 +10,16 @@
 
 #include "Node.h"
 
-class BoolNode : public Node, public std::enable_shared_from_this<BoolNode>
+class BoolNode : public Node
 {
 private:
 	bool value;
 public:
 	explicit BoolNode(const std::string& value);
+	explicit BoolNode(bool value);
 	~BoolNode() override = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
 	bool GetValue() const
 	{
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef DOUBLE_NODE_H
+#define DOUBLE_NODE_H
+
+#include "Node.h"
+
+class DoubleNode : public Node
+{
+private:
+	double value;
+public:
+	explicit DoubleNode(double value);
+	~DoubleNode() override = default;
+
+	void Accept(Visitor& v) override;
+
+	double GetValue() const
+	{
+		return value;
+	}
+};
+
+#endif
@@ -10,15 +10,15 @@
 
 #include "Node.h"
 
-class FloatNode : public Node, public std::enable_shared_from_this<FloatNode>
+class FloatNode : public Node
 {
 private:
 	float value;
 public:
-	explicit FloatNode(const std::string& value);
+	explicit FloatNode(float value);
 	~FloatNode() override = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
 	float GetValue() const
 	{
@@ -11,15 +11,15 @@
 #include <utility>
 #include "Node.h"
 
-class IntNode : public Node, public std::enable_shared_from_this<IntNode>
+class IntNode : public Node
 {
 private:
 	int value;
 public:
-	explicit IntNode(const std::string& value);
+	explicit IntNode(int value);
 	~IntNode() override = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
 	int GetValue() const
 	{
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef LONG_NODE_H
+#define LONG_NODE_H
+
+#include <cstdint>
+#include "Node.h"
+
+class LongNode : public Node
+{
+private:
+	int64_t value;
+public:
+	explicit LongNode(int64_t value);
+	~LongNode() override = default;
+
+	void Accept(Visitor& v) override;
+
+	int64_t GetValue() const
+	{
+		return value;
+	}
+};
+
+#endif
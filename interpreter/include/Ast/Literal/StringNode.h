@@ -11,25 +11,26 @@
 #include <utility>
 #include <vector>
 #include "Node.h"
+#include "AstArena.h"
 
-class StringNode : public Node, public std::enable_shared_from_this<StringNode>
+class StringNode : public Node
 {
 private:
 	std::string value;
-	std::vector<Ref<Node>> expressions;
+	NodeList<Node*> expressions;
 public:
-	StringNode(const std::string& fileName, int line, std::string  value, std::vector<Ref<Node>> expressions);
+	StringNode(uint32_t fileId, int line, std::string  value, NodeList<Node*> expressions);
 
 	~StringNode() override = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetValue() const
+	const std::string& GetValue() const
 	{
 		return value;
 	}
 
-	std::vector<Ref<Node>> GetExpressions() const
+	const NodeList<Node*>& GetExpressions() const
 	{
 		return expressions;
 	}
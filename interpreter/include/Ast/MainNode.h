@@ -10,25 +10,26 @@
 
 #include <vector>
 #include "Node.h"
+#include "AstArena.h"
 
-class MainNode : public Node, public std::enable_shared_from_this<MainNode>
+class MainNode : public Node
 {
 private:
-	std::vector<Ref<Node>> globalVariables;
-	std::vector<Ref<Node>> globalFunctions;
+	NodeList<Node*> globalVariables;
+	NodeList<Node*> globalFunctions;
 public:
-	MainNode(std::vector<Ref<Node>> globalVariables, std::vector<Ref<Node>> globalFunctions);
+	MainNode(NodeList<Node*> globalVariables, NodeList<Node*> globalFunctions);
 
 	~MainNode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::vector<Ref<Node>>& GetGlobalVariables()
+	const NodeList<Node*>& GetGlobalVariables() const
 	{
 		return globalVariables;
 	}
 
-	std::vector<Ref<Node>>& GetGlobalFunctions()
+	const NodeList<Node*>& GetGlobalFunctions() const
 	{
 		return globalFunctions;
 	}
@@ -10,25 +10,31 @@
 
 #include <sstream>
 #include "Core.h"
+#include "FileTable.h"
 
 class Visitor;
 
 class Node
 {
 protected:
-    std::string fileName;
+	uint32_t fileId = 0;
 	int line = 0;
 public:
 	Node() = default;
-	explicit Node(const std::string& fileName, int line) : fileName(fileName), line(line) { }
+	explicit Node(uint32_t fileId, int line) : fileId(fileId), line(line) { }
 	virtual ~Node() = default;
 
-	virtual void Accept(const Ref<Visitor>& v) = 0;
+	virtual void Accept(Visitor& v) = 0;
 
-	std::string GetFileName() const
-    {
-	    return fileName;
-    }
+	const std::string& GetFileName() const
+	{
+		return FileTable::GetName(fileId);
+	}
+
+	uint32_t GetFileId() const
+	{
+		return fileId;
+	}
 
 	int GetLine() const
 	{
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef RESOLVED_VARIABLE_H
+#define RESOLVED_VARIABLE_H
+
+// Location of the variable a node declares or uses, resolved by the semantic analyzer.
+// The depth is the number of function frames between the node and the declaration
+// (zero for the current frame), the slot is the index of the variable in that frame.
+class ResolvedVariable
+{
+private:
+	int depth = 0;
+	int slot = 0;
+public:
+	void Resolve(int depth, int slot)
+	{
+		this->depth = depth;
+		this->slot = slot;
+	}
+
+	int GetDepth() const
+	{
+		return depth;
+	}
+
+	int GetSlot() const
+	{
+		return slot;
+	}
+};
+
+#endif
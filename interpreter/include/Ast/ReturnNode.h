@@ -12,21 +12,41 @@
 #include "Node.h"
 #include "Token.h"
 
-class ReturnNode : public Node, public std::enable_shared_from_this<ReturnNode>
+class FunctionCallNode;
+
+class ReturnNode : public Node
 {
 private:
-	Ref<Node> expression;
+	Node* expression;
+	// Set by the semantic analyzer if the expression is a call of a function of the program,
+	// the frame of the returning function can then be reused for the called one
+	FunctionCallNode* tailCall = nullptr;
 public:
-	ReturnNode(const Ref<Node>& expression);
+	ReturnNode(Node* expression);
 
 	~ReturnNode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	Ref<Node> GetExpression() const
+	Node* GetExpression() const
 	{
 		return expression;
 	}
+
+	void SetExpression(Node* expression)
+	{
+		this->expression = expression;
+	}
+
+	void SetTailCall(FunctionCallNode* tailCall)
+	{
+		this->tailCall = tailCall;
+	}
+
+	FunctionCallNode* GetTailCall() const
+	{
+		return tailCall;
+	}
 };
 
 #endif
\ No newline at end of file
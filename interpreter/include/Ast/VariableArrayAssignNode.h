@@ -10,21 +10,22 @@
 
 #include <string>
 #include "Node.h"
+#include "ResolvedVariable.h"
 
-class VariableArrayAssignNode : public Node, public std::enable_shared_from_this<VariableArrayAssignNode>
+class VariableArrayAssignNode : public Node, public ResolvedVariable
 {
 private:
 	std::string name;
 	unsigned int index;
-	Ref<Node> expression;
+	Node* expression;
 public:
-	VariableArrayAssignNode(const std::string& fileName, int line, std::string name, unsigned int index, const Ref<Node>& expression);
+	VariableArrayAssignNode(uint32_t fileId, int line, std::string name, unsigned int index, Node* expression);
 
 	~VariableArrayAssignNode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetName() const
+	const std::string& GetName() const
 	{
 		return name;
 	}
@@ -34,10 +35,15 @@ public:
 		return index;
 	}
 
-	Ref<Node> GetExpression() const
+	Node* GetExpression() const
 	{
 		return expression;
 	}
+
+	void SetExpression(Node* expression)
+	{
+		this->expression = expression;
+	}
 };
 
 #endif
\ No newline at end of file
@@ -11,22 +11,24 @@
 #include <vector>
 #include <string>
 #include "Node.h"
+#include "AstArena.h"
+#include "ResolvedVariable.h"
 #include "Token.h"
 
-class VariableArrayDeclarationAssignNode : public Node, public std::enable_shared_from_this<VariableArrayDeclarationAssignNode>
+class VariableArrayDeclarationAssignNode : public Node, public ResolvedVariable
 {
 private:
 	std::string name;
 	TokenType arrayType;
-	std::vector<Ref<Node>> values;
+	NodeList<Node*> values;
 public:
-	VariableArrayDeclarationAssignNode(const std::string& fileName, int line, std::string name, const TokenType arrayType, std::vector<Ref<Node>> values);
+	VariableArrayDeclarationAssignNode(uint32_t fileId, int line, std::string name, const TokenType arrayType, NodeList<Node*> values);
 
 	~VariableArrayDeclarationAssignNode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetName() const
+	const std::string& GetName() const
 	{
 		return name;
 	}
@@ -36,7 +38,7 @@ public:
 		return arrayType;
 	}
 
-	std::vector<Ref<Node>> GetValues() const
+	const NodeList<Node*>& GetValues() const
 	{
 		return values;
 	}
@@ -10,20 +10,21 @@
 
 #include <string>
 #include "Node.h"
+#include "ResolvedVariable.h"
 
-class VariableArrayUsageNode : public Node, public std::enable_shared_from_this<VariableArrayUsageNode>
+class VariableArrayUsageNode : public Node, public ResolvedVariable
 {
 private:
 	std::string name;
 	unsigned int index;
 public:
-	VariableArrayUsageNode(const std::string& fileName, int line, std::string name, unsigned int index);
+	VariableArrayUsageNode(uint32_t fileId, int line, std::string name, unsigned int index);
 
 	~VariableArrayUsageNode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetName() const
+	const std::string& GetName() const
 	{
 		return name;
 	}
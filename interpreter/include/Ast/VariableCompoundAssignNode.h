@@ -11,35 +11,54 @@
 #include <vector>
 #include <string>
 #include "Node.h"
+#include "ResolvedVariable.h"
 #include "Token.h"
+#include "TypedOperations.h"
 
-class VariableCompoundAssignNode : public Node, public std::enable_shared_from_this<VariableCompoundAssignNode>
+class VariableCompoundAssignNode : public Node, public ResolvedVariable
 {
 private:
 	std::string name;
-	Ref<Node> expression;
+	Node* expression;
 	TokenType operation;
+	// Set by the semantic analyzer if the variable and the expression are proven to be of the same number type
+	BinaryOperation typedOperation = nullptr;
 public:
-	VariableCompoundAssignNode(const std::string& fileName, int line, std::string name, const Ref<Node>& expression, const TokenType& operation);
+	VariableCompoundAssignNode(uint32_t fileId, int line, std::string name, Node* expression, const TokenType& operation);
 
 	~VariableCompoundAssignNode() override = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetName() const
+	const std::string& GetName() const
 	{
 		return name;
 	}
 
-	Ref<Node> GetExpression() const
+	Node* GetExpression() const
 	{
 		return expression;
 	}
 
+	void SetExpression(Node* expression)
+	{
+		this->expression = expression;
+	}
+
 	TokenType GetOperation() const
 	{
 		return operation;
 	}
+
+	BinaryOperation GetTypedOperation() const
+	{
+		return typedOperation;
+	}
+
+	void SetTypedOperation(BinaryOperation typedOperation)
+	{
+		this->typedOperation = typedOperation;
+	}
 };
 
 #endif
\ No newline at end of file
@@ -11,29 +11,35 @@
 #include <vector>
 #include <string>
 #include "Node.h"
+#include "ResolvedVariable.h"
 #include "Token.h"
 
-class VariableDeclarationAssignNode : public Node, public std::enable_shared_from_this<VariableDeclarationAssignNode>
+class VariableDeclarationAssignNode : public Node, public ResolvedVariable
 {
 private:
 	std::string name;
-	Ref<Node> expression;
+	Node* expression;
 public:
-	VariableDeclarationAssignNode(const std::string& fileName, int line, std::string name, const Ref<Node>& expression);
+	VariableDeclarationAssignNode(uint32_t fileId, int line, std::string name, Node* expression);
 
 	~VariableDeclarationAssignNode() override = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetName() const
+	const std::string& GetName() const
 	{
 		return name;
 	}
 
-	Ref<Node> GetExpression() const
+	Node* GetExpression() const
 	{
 		return expression;
 	}
+
+	void SetExpression(Node* expression)
+	{
+		this->expression = expression;
+	}
 };
 
 #endif
\ No newline at end of file
@@ -10,21 +10,25 @@
 
 #include <string>
 #include "Node.h"
+#include "ResolvedVariable.h"
 #include "Token.h"
+#include "TypedOperations.h"
 
-class VariableIncrementDecrementNode : public Node, public std::enable_shared_from_this<VariableIncrementDecrementNode>
+class VariableIncrementDecrementNode : public Node, public ResolvedVariable
 {
 private:
 	std::string name;
 	int value;
+	// Set by the semantic analyzer if the variable is proven to be an int or a float
+	IncrementOperation typedOperation = nullptr;
 public:
-	VariableIncrementDecrementNode(const std::string& fileName, int line, std::string name, int value);
+	VariableIncrementDecrementNode(uint32_t fileId, int line, std::string name, int value);
 
 	~VariableIncrementDecrementNode() override = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetName() const
+	const std::string& GetName() const
 	{
 		return name;
 	}
@@ -33,6 +37,16 @@ public:
 	{
 		return value;
 	}
+
+	IncrementOperation GetTypedOperation() const
+	{
+		return typedOperation;
+	}
+
+	void SetTypedOperation(IncrementOperation typedOperation)
+	{
+		this->typedOperation = typedOperation;
+	}
 };
 
 #endif
\ No newline at end of file
@@ -10,20 +10,21 @@
 
 #include <string>
 #include "Node.h"
+#include "ResolvedVariable.h"
 #include "Token.h"
 
-class VariableUsageNode : public Node, public std::enable_shared_from_this<VariableUsageNode>
+class VariableUsageNode : public Node, public ResolvedVariable
 {
 private:
 	std::string name;
 public:
-	VariableUsageNode(const std::string& fileName, int line, std::string name);
+	VariableUsageNode(uint32_t fileId, int line, std::string name);
 
 	~VariableUsageNode() override = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	std::string GetName() const
+	const std::string& GetName() const
 	{
 		return name;
 	}
@@ -11,24 +11,29 @@
 #include <string>
 #include "Node.h"
 
-class WhileNode : public Node, public std::enable_shared_from_this<WhileNode>
+class WhileNode : public Node
 {
 private:
-	Ref<Node> expression;
-	Ref<Node> block;
+	Node* expression;
+	Node* block;
 public:
-	WhileNode(const std::string& fileName, int line, const Ref<Node>& expression, const Ref<Node>& block);
+	WhileNode(uint32_t fileId, int line, Node* expression, Node* block);
 
 	~WhileNode() = default;
 
-	void Accept(const Ref<Visitor>& v) override;
+	void Accept(Visitor& v) override;
 
-	Ref<Node> GetExpression() const
+	Node* GetExpression() const
 	{
 		return expression;
 	}
 
-	Ref<Node> GetBlock() const
+	void SetExpression(Node* expression)
+	{
+		this->expression = expression;
+	}
+
+	Node* GetBlock() const
 	{
 		return block;
 	}
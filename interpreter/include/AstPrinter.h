@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef AST_PRINTER_H
+#define AST_PRINTER_H
+
+#include <ostream>
+#include "Visitor.h"
+#include "Core.h"
+
+// Writes the ast as an indented tree, one node per line. Used to inspect what the optimizer did.
+class AstPrinter : public Visitor
+{
+private:
+	std::ostream& out;
+	int depth = 0;
+
+	void Line(const std::string& text);
+	void Child(Node* node);
+public:
+	AstPrinter(const Ref<Node>& astRoot, std::ostream& out);
+	~AstPrinter() = default;
+
+	void Print();
+
+	void Visit(MainNode& n) override;
+	void Visit(VariableDeclarationAssignNode& n) override;
+	void Visit(VariableArrayDeclarationAssignNode& n) override;
+	void Visit(FunctionNode& n) override;
+	void Visit(FunctionCallNode& n) override;
+	void Visit(ForEachNode& n) override;
+	void Visit(ForINode& n) override;
+	void Visit(BlockNode& n) override;
+	void Visit(BinaryNode& n) override;
+	void Visit(BooleanNode& n) override;
+	void Visit(IfNode& n) override;
+	void Visit(WhileNode& n) override;
+	void Visit(DoWhileNode& n) override;
+	void Visit(StringNode& n) override;
+	void Visit(IntNode& n) override;
+	void Visit(FloatNode& n) override;
+	void Visit(LongNode& n) override;
+	void Visit(DoubleNode& n) override;
+	void Visit(VariableUsageNode& n) override;
+	void Visit(VariableAssignNode& n) override;
+	void Visit(VariableArrayUsageNode& n) override;
+	void Visit(VariableArrayAssignNode& n) override;
+	void Visit(VariableIncrementDecrementNode& n) override;
+	void Visit(VariableCompoundAssignNode& n) override;
+	void Visit(BoolNode& n) override;
+	void Visit(ReturnNode& n) override;
+};
+
+#endif
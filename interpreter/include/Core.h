@@ -8,8 +8,10 @@
 #ifndef CORE_H
 #define CORE_H
 
+#include <charconv>
 #include <stdexcept>
 #include <memory>
+#include <string_view>
 #include <utility>
 #include <vector>
 #include "Token.h"
@@ -39,6 +41,13 @@ static void Exit(std::string fileName, int line, const std::string& error, Args
 	throw std::runtime_error(&buffer[0]);
 }
 
+// Parses the whole text as a positive number, fails on anything else (eg. '50abc' or '-1')
+inline bool ParsePositive(std::string_view text, int& value)
+{
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size() && value > 0;
+}
+
 template <typename ...Args>
 static void Exit(const Token& token, const std::string& error, Args ...args)
 {
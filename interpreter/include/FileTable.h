@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef FILE_TABLE_H
+#define FILE_TABLE_H
+
+#include <cstdint>
+#include <string>
+
+// Interns the names of all source files, so that ast nodes only store a small id.
+// The id zero is reserved for nodes without a source location and has an empty name.
+class FileTable
+{
+public:
+	static uint32_t Intern(const std::string& fileName);
+	static const std::string& GetName(uint32_t fileId);
+};
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef FUNCTION_LOADER_H
+#define FUNCTION_LOADER_H
+
+#include "Core.h"
+#include "Ast/AstArena.h"
+#include "Ast/FunctionNode.h"
+#include "Semantic/SemanticAnalyzer.h"
+
+// Loads the bodies of lazily parsed functions (see Parser::SetLazyFunctions) on their first call.
+// A body goes through the same passes as the rest of the program: it is parsed, analyzed and optimized.
+// The source of the program has to outlive the loader, the bodies are views into it.
+class FunctionLoader
+{
+private:
+	Ref<Node> astRoot;
+	Ref<AstArena> arena;
+	Ref<SemanticAnalyzer> semanticAnalyzer;
+	bool optimize;
+
+	size_t loadedFunctions = 0;
+public:
+	FunctionLoader(const Ref<Node>& astRoot, const Ref<AstArena>& arena, const Ref<SemanticAnalyzer>& semanticAnalyzer, bool optimize);
+	~FunctionLoader() = default;
+
+	// Does nothing if the function is already loaded
+	void Load(FunctionNode& function);
+
+	size_t GetLoadedFunctions() const
+	{
+		return loadedFunctions;
+	}
+};
+
+#endif
@@ -8,19 +8,43 @@
 #ifndef FUNCTION_REGISTRY_H
 #define FUNCTION_REGISTRY_H
 
-#include <functional>
-#include <stack>
 #include <map>
 #include "Core.h"
 #include "TokenType.h"
+#include "Value.h"
 
-using InternalFunctionCallback = std::function<void(std::vector<VariableType>& in, VariableType& out)>;
+using InternalFunctionCallback = void (*)(std::vector<Value>& in, Value& out);
+
+// Set of value types with one bit per token type
+using TypeMask = uint64_t;
+
+static_assert(TokenType::None < 64, "Every token type needs a bit in a TypeMask");
+
+static TypeMask TypeMaskOf(TokenType type)
+{
+	// Parameters of type array accept all array types
+	if (type == TokenType::Array)
+	{
+		return TypeMaskOf(TokenType::IntArray) | TypeMaskOf(TokenType::FloatArray)
+			| TypeMaskOf(TokenType::BoolArray) | TypeMaskOf(TokenType::StringArray);
+	}
+
+	return (TypeMask) 1 << type;
+}
 
 struct FunctionEntry
 {
 	InternalFunctionCallback function;
 	unsigned int parameterCount;
-	std::map<int, std::vector<TokenType>> functionParameters;
+	// Allowed types of every parameter
+	std::vector<TypeMask> parameterTypes;
+	// Pure functions only depend on their parameters, so calls with constant parameters can be folded
+	bool pure = false;
+
+	bool Accepts(size_t index, TokenType type) const
+	{
+		return (parameterTypes[index] & TypeMaskOf(type)) != 0;
+	}
 };
 
 class FunctionRegistry
@@ -31,9 +55,21 @@ public:
 	FunctionRegistry() = default;
 	~FunctionRegistry() = default;
 
-	void Register(const std::string& name, InternalFunctionCallback function, unsigned int parameterCount, std::map<int, std::vector<TokenType>> functionParameters = {});
+	// The internal functions of iona, which are registered once and shared by all passes and engines
+	static const FunctionRegistry& Internal();
+
+	void Register(const std::string& name, InternalFunctionCallback function, unsigned int parameterCount, std::map<int, std::vector<TokenType>> functionParameters = {}, bool pure = false);
+
+	void RegisterInternalFunctions();
+
+	// Checks the parameter count and types before calling the function
+	static void Call(const std::string& fileName, int line, const std::string& name, const FunctionEntry& entry, std::vector<Value>& in, Value& out);
+
+	// Checks the parameter count and types, without calling the function
+	static bool Accepts(const FunctionEntry& entry, const std::vector<Value>& in);
 
-	void Call(const std::string& fileName, int line, const std::string& name, std::vector<VariableType>& in, VariableType& out);
+	// Entries are never moved, so the returned pointer stays valid as long as the registry
+	const FunctionEntry* Find(const std::string& name) const;
 
 	bool Exists(const std::string& name);
 };
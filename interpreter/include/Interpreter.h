@@ -11,60 +11,150 @@
 #include "Visitor.h"
 #include <functional>
 #include <stack>
+#include <cstdint>
 #include "Core.h"
 #include "InterpreterScope.h"
+#include "FunctionLoader.h"
 #include <FunctionRegistry.h>
 
-class Interpreter : public Visitor, public std::enable_shared_from_this<Interpreter>
+class Interpreter : public Visitor
 {
 private:
-	std::vector<Ref<InterpreterScope>> scopes;
-	std::map<std::string, Ref<FunctionNode>> globalFunctions;
-	FunctionRegistry internalFunctions;
+	static constexpr size_t GlobalFrame = SIZE_MAX;
 
-	VariableType currentVariable;
-	std::vector<std::string> currentFunctionCallFunctionParams;
-	std::vector<Ref<Node>> currentFunctionCallParams;
+	Ref<InterpreterScope> globals;
+	// The frames of the called functions lie one after another in this stack, sized by the
+	// frame sizes of the semantic analyzer. It only grows, returning releases no memory.
+	std::vector<Value> stack;
+	// First slot of the current function frame, GlobalFrame while no function is executed
+	size_t frameBase = GlobalFrame;
+	size_t stackTop = 0;
+
+	Value currentVariable;
+	// Every call recurses natively through the visitor, so the limit needs to be reached before the C++ stack overflows
+	int maxCallDepth = DefaultMaxCallDepth;
+	int callDepth = 0;
+
+	// Set by a return statement, blocks and loops stop executing until the function call is left
+	bool returning = false;
+	// Function of a tail call, which is executed in the frame of the returning function
+	FunctionNode* tailCall = nullptr;
+	// Slot of the evaluated tail call arguments in the stack
+	size_t tailCallArguments = 0;
+
+	// Loads functions whose body was not parsed yet, only needed if the parser skipped them
+	Ref<FunctionLoader> functionLoader;
 
-	void RegisterInternalFunctions();
 	void RegisterInternalVariables();
-	Ref<InterpreterScope> FindScopeOfVariable(const std::string& variableName);
+
+	size_t inlineCacheHits = 0;
+	size_t inlineCacheMisses = 0;
+
+	size_t PushFrame(FunctionNode& function);
+	size_t PushArguments(FunctionCallNode& n, FunctionNode& function);
+	void Execute(FunctionNode& function, size_t base);
+
+	// Returns the typed operation for the operand types, nullptr if there is none. On a miss the cache is filled again.
+	BinaryOperation Quicken(InlineCache& cache, TokenType operant, const Value& left, const Value& right,
+		BinaryOperation (*specialize)(TokenType operant, TokenType left, TokenType right))
+	{
+		if (cache.operation != nullptr && cache.left == left.GetType() && cache.right == right.GetType())
+		{
+			this->inlineCacheHits++;
+			return cache.operation;
+		}
+
+		this->inlineCacheMisses++;
+		cache = { left.GetType(), right.GetType(), specialize(operant, left.GetType(), right.GetType()) };
+
+		return cache.operation;
+	}
+
+	Value& GetVariable(const ResolvedVariable& variable)
+	{
+		// Functions are only declared globally, so the frame above a function frame is always the global one
+		if (variable.GetDepth() == 0 && this->frameBase != GlobalFrame)
+		{
+			return this->stack[this->frameBase + variable.GetSlot()];
+		}
+
+		return this->globals->GetVariable(variable.GetSlot());
+	}
+
+	void DeclareVariable(int slot, Value variable)
+	{
+		if (this->frameBase != GlobalFrame)
+		{
+			this->stack[this->frameBase + slot] = std::move(variable);
+		}
+		else
+		{
+			this->globals->DeclareVariable(slot, std::move(variable));
+		}
+	}
 public:
+	static constexpr int DefaultMaxCallDepth = 3000;
+	// Every call recurses on the native stack, deeper limits would overflow it before they are reached.
+	// Translated programs of ionac recurse on it as well and have the same maximum.
+	static constexpr int MaxCallDepth = 5000;
+
 	Interpreter(const std::vector<std::string>& args, const Ref<Node>& astRoot);
 	Interpreter(const std::vector<std::string>& args, const Ref<Node>& astRoot, const Ref<InterpreterScope>& scope);
 	~Interpreter() = default;
 
+	void SetMaxCallDepth(int maxCallDepth)
+	{
+		this->maxCallDepth = maxCallDepth;
+	}
+
+	void SetFunctionLoader(const Ref<FunctionLoader>& functionLoader)
+	{
+		this->functionLoader = functionLoader;
+	}
+
 	void Interpret();
 
-	VariableType GetCurrentVariable() const
+	const Value& GetCurrentVariable() const
 	{
 		return currentVariable;
 	}
 
-	void Visit(const Ref<MainNode>& n) override;
-	void Visit(const Ref<VariableDeclarationAssignNode>& n) override;
-	void Visit(const Ref<VariableArrayDeclarationAssignNode>& n) override;
-	void Visit(const Ref<FunctionNode>& n) override;
-	void Visit(const Ref<FunctionCallNode>& n) override;
-	void Visit(const Ref<ForEachNode>& n) override;
-	void Visit(const Ref<ForINode>& n) override;
-	void Visit(const Ref<BlockNode>& n) override;
-	void Visit(const Ref<BinaryNode>& n) override;
-	void Visit(const Ref<BooleanNode>& n) override;
-	void Visit(const Ref<IfNode>& n) override;
-	void Visit(const Ref<WhileNode>& n) override;
-	void Visit(const Ref<DoWhileNode>& n) override;
-	void Visit(const Ref<StringNode>& n) override;
-	void Visit(const Ref<IntNode>& n) override;
-	void Visit(const Ref<FloatNode>& n) override;
-	void Visit(const Ref<VariableUsageNode>& n) override;
-	void Visit(const Ref<VariableAssignNode>& n) override;
-	void Visit(const Ref<VariableArrayUsageNode>& n) override;
-	void Visit(const Ref<VariableArrayAssignNode>& n) override;
-	void Visit(const Ref<VariableIncrementDecrementNode>& n) override;
-	void Visit(const Ref<VariableCompoundAssignNode>& n) override;
-	void Visit(const Ref<BoolNode>& n) override;
-	void Visit(const Ref<ReturnNode>& n) override;
+	size_t GetInlineCacheHits() const
+	{
+		return inlineCacheHits;
+	}
+
+	size_t GetInlineCacheMisses() const
+	{
+		return inlineCacheMisses;
+	}
+
+	void Visit(MainNode& n) override;
+	void Visit(VariableDeclarationAssignNode& n) override;
+	void Visit(VariableArrayDeclarationAssignNode& n) override;
+	void Visit(FunctionNode& n) override;
+	void Visit(FunctionCallNode& n) override;
+	void Visit(ForEachNode& n) override;
+	void Visit(ForINode& n) override;
+	void Visit(BlockNode& n) override;
+	void Visit(BinaryNode& n) override;
+	void Visit(BooleanNode& n) override;
+	void Visit(IfNode& n) override;
+	void Visit(WhileNode& n) override;
+	void Visit(DoWhileNode& n) override;
+	void Visit(StringNode& n) override;
+	void Visit(IntNode& n) override;
+	void Visit(FloatNode& n) override;
+	void Visit(LongNode& n) override;
+	void Visit(DoubleNode& n) override;
+	void Visit(VariableUsageNode& n) override;
+	void Visit(VariableAssignNode& n) override;
+	void Visit(VariableArrayUsageNode& n) override;
+	void Visit(VariableArrayAssignNode& n) override;
+	void Visit(VariableIncrementDecrementNode& n) override;
+	void Visit(VariableCompoundAssignNode& n) override;
+	void Visit(BoolNode& n) override;
+	void Visit(ReturnNode& n) override;
 };
 
 #endif
\ No newline at end of file
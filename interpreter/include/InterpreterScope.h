@@ -8,30 +8,34 @@
 #ifndef INTERPRETER_SCOPE_H
 #define INTERPRETER_SCOPE_H
 
-#include <map>
+#include <vector>
 #include <string>
 #include <memory>
 #include "Core.h"
 #include "Token.h"
+#include "Value.h"
 
+// Flat frame of a function call (or of the global variables), variables
+// are addressed by the slot the semantic analyzer resolved for them
 class InterpreterScope
 {
 private:
-	std::map<std::string, Ref<VariableType>> variables;
+	std::vector<Value> variables;
 public:
 	InterpreterScope() = default;
+	explicit InterpreterScope(size_t size) : variables(size) { }
 	~InterpreterScope() = default;
 
-	void DeclareVariable(const std::string& variableName, const TokenType& variableType);
-	void DeclareVariable(const std::string& variableName, const VariableType& variable);
-	void DeclareVariable(const std::string& variableName, const TokenType& arrayType, const std::vector<VariableType>& token);
+	void DeclareVariable(int slot, Value variable);
+	void DeclareVariable(int slot, const TokenType& arrayType, std::vector<Value> values);
 
-	bool IsDeclared(const std::string& name);
+	// Makes sure that all slots up to the given size exist
+	void Resize(size_t size);
 
-	void UpdateVariable(const std::string& variableName, const VariableType& variableType);
-	void UpdateVariable(const std::string& variableName, unsigned int arrayIndex, const VariableType& variableType);
-
-	Ref<VariableType> GetVariable(const std::string& name);
+	Value& GetVariable(int slot)
+	{
+		return variables[slot];
+	}
 };
 
-#endif
\ No newline at end of file
+#endif
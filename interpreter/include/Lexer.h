@@ -9,34 +9,58 @@
 #define LEXER_H
 
 #include <string>
-#include <sstream>
-#include <map>
+#include <string_view>
 #include "Token.h"
 
+// Splits the source into tokens. The input is borrowed, it has to outlive the lexer and all of its
+// tokens, whose values are views into it. Lexing allocates nothing.
 class Lexer
 {
 private:
-	std::string input;
-	std::string fileName;
+	std::string_view input;
+	uint32_t fileId;
 	char currentChar;
-	int pos;
-	std::map<std::string, Token> reservedKeywords;
+	size_t pos;
 	int line;
 
 	void Advance();
-	char Peek();
+	// Continues at the position, hot loops scan ahead on the input instead of advancing char by char
+	void Seek(size_t position);
+	char Peek() const;
 
+	// End of the block comment which starts at the position, the new lines in it are counted.
+	// Exits if the comment is not closed.
+	size_t SkipBlockComment(size_t position);
 	Token HandleReserved();
 public:
-	Lexer(std::string  input, std::string  fileName);
+	Lexer(std::string_view input, const std::string& fileName);
+	// Lexers of the same file (eg. of string interpolations) reuse its id, constructing them costs nothing.
+	// Parts of a file (eg. lazily parsed function bodies) start at the line they have in it.
+	Lexer(std::string_view input, uint32_t fileId, int line = 1);
 	~Lexer() = default;
 
 	Token NextToken();
+	// Continues right behind the curly bracket which closes the block the lexer is in, without creating
+	// tokens for it. Strings and comments are skipped like by NextToken. Returns false if the input ends before.
+	bool SkipBlock();
 
-	std::string GetFileName() const
+	std::string_view GetInput() const
 	{
-		return fileName;
+		return input;
 	}
+
+	// Position right behind the last returned token
+	size_t GetPosition() const
+	{
+		return pos;
+	}
+
+	uint32_t GetFileId() const
+	{
+		return fileId;
+	}
+
+	const std::string& GetFileName() const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+
+// Read only content of a whole file. It is mapped into memory where supported (and read
+// into a buffer elsewhere), the content stays valid until the mapped file is destroyed.
+class MappedFile
+{
+private:
+	void* address = nullptr;
+	size_t size = 0;
+	// Content on platforms without mmap
+	std::string buffer;
+	bool valid = false;
+public:
+	explicit MappedFile(const std::string& fileName);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Empty files are valid, they just have no content
+	bool IsValid() const
+	{
+		return valid;
+	}
+
+	std::string_view GetContent() const;
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "Visitor.h"
+#include "Core.h"
+#include "Value.h"
+#include "Ast/AstArena.h"
+#include <FunctionRegistry.h>
+
+// Runs after the semantic analyzer and rewrites the ast in place. Constant expressions (including
+// calls of pure internal functions) are folded into literals and branches which can never be executed
+// are removed. Expressions which would fail at runtime are left untouched, so the error stays the same.
+class Optimizer : public Visitor
+{
+private:
+	// New nodes are allocated in the arena of the parse result
+	Ref<AstArena> arena;
+
+	// The node which replaces the last visited one, nullptr if the statement can be removed
+	Node* replacement = nullptr;
+
+	Node* Fold(Node* node);
+
+	static bool IsConstant(Node* node, Value& value);
+	Node* NewLiteral(const Node& origin, const Value& value);
+public:
+	Optimizer(const Ref<Node>& astRoot, const Ref<AstArena>& arena);
+	~Optimizer() = default;
+
+	void Optimize();
+	// Optimizes the body of a lazily parsed function after it was analyzed
+	void OptimizeFunction(FunctionNode& function);
+
+	void Visit(MainNode& n) override;
+	void Visit(VariableDeclarationAssignNode& n) override;
+	void Visit(VariableArrayDeclarationAssignNode& n) override;
+	void Visit(FunctionNode& n) override;
+	void Visit(FunctionCallNode& n) override;
+	void Visit(ForEachNode& n) override;
+	void Visit(ForINode& n) override;
+	void Visit(BlockNode& n) override;
+	void Visit(BinaryNode& n) override;
+	void Visit(BooleanNode& n) override;
+	void Visit(IfNode& n) override;
+	void Visit(WhileNode& n) override;
+	void Visit(DoWhileNode& n) override;
+	void Visit(StringNode& n) override;
+	void Visit(IntNode& n) override;
+	void Visit(FloatNode& n) override;
+	void Visit(LongNode& n) override;
+	void Visit(DoubleNode& n) override;
+	void Visit(VariableUsageNode& n) override;
+	void Visit(VariableAssignNode& n) override;
+	void Visit(VariableArrayUsageNode& n) override;
+	void Visit(VariableArrayAssignNode& n) override;
+	void Visit(VariableIncrementDecrementNode& n) override;
+	void Visit(VariableCompoundAssignNode& n) override;
+	void Visit(BoolNode& n) override;
+	void Visit(ReturnNode& n) override;
+};
+
+#endif
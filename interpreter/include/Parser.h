@@ -12,33 +12,48 @@
 #include <iostream>
 #include <vector>
 #include "Ast/Node.h"
+#include "Ast/AstArena.h"
 #include "Lexer.h"
 
+class FunctionNode;
+
 class Parser
 {
 private:
 	Lexer& lexer;
 	Token currentToken;
 
+	// Shared with the parsers of string interpolations, all nodes of one parse result live in it
+	Ref<AstArena> arena;
+	uint32_t fileId;
+	bool lazyFunctions = false;
+
+	Parser(Lexer& lexer, const Ref<AstArena>& arena);
+
 	void Advance(TokenType tokenType);
+	// Advance over an int or float literal, the lexer makes literals which do not fit into 32 bits longs and doubles
+	int ParseInt();
+	float ParseFloat();
+
+	Node* ParseMainFile();
+	Node* ParseGlobalVariables();
+	Node* ParseFunction();
+	Node* ParseFunctionCall();
+	Node* ParseFor();
+	Node* ParseWhile();
+	Node* ParseDoWhile();
+	Node* ParseIf();
+	Node* ParseWhen();
+	Node* ParseReturn();
+
+	std::vector<Node*> ParseStatements();
+	Node* ParseBlock();
 
-	Ref<Node> ParseMainFile();
-	Ref<Node> ParseGlobalVariables();
-	Ref<Node> ParseFunction();
-	Ref<Node> ParseFunctionCall();
-	Ref<Node> ParseFor();
-	Ref<Node> ParseWhile();
-	Ref<Node> ParseDoWhile();
-	Ref<Node> ParseIf();
-	Ref<Node> ParseWhen();
-	Ref<Node> ParseReturn();
-
-	std::vector<Ref<Node>> ParseStatements();
-	Ref<Node> ParseBlock();
-
-	Ref<Node> Factor();
-	Ref<Node> Term();
-	Ref<Node> Expression();
+	Node* ParseStatement();
+
+	Node* Factor();
+	Node* Term();
+	Node* Expression();
 public:
 	const std::string MainFunctionName = "Main";
 
@@ -47,6 +62,22 @@ public:
 
 	Ref<Node> Parse();
 	Ref<Node> Statement();
+
+	// Function bodies in curly brackets are only pre-parsed, the parser records their source and skips
+	// to the matching bracket. Errors inside of them are found when they are parsed by ParseFunctionBody.
+	void SetLazyFunctions(bool lazyFunctions)
+	{
+		this->lazyFunctions = lazyFunctions;
+	}
+
+	// Parses the body of a lazily parsed function into the arena of its parse result
+	static Node* ParseFunctionBody(const FunctionNode& function, const Ref<AstArena>& arena);
+
+	// Owns all nodes of the parse results, passes which add nodes allocate them in here as well
+	const Ref<AstArena>& GetArena() const
+	{
+		return arena;
+	}
 };
 
 #endif
\ No newline at end of file
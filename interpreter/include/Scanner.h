@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Characters of a run the lexer skips as a whole
+enum class CharRun
+{
+	// ' ', '\t', '\n', '\v', '\f' and '\r'
+	Spaces,
+	// a-z, A-Z and '_'
+	Name,
+	// 0-9
+	Digits
+};
+
+// Finds the ends of character runs in the source for the lexer. The input is compared 32 (AVX2) or
+// 16 (SSE2) bytes at a time where the cpu supports it, the best implementation is chosen at startup.
+// All of them only read inside of the input and return its size if the run does not end before.
+class Scanner
+{
+public:
+	// Position of the first char at or after the position which is not part of the run
+	static size_t Skip(std::string_view input, size_t position, CharRun run);
+	// Same as Skip for spaces, but adds the new lines of the run to lines
+	static size_t SkipSpaces(std::string_view input, size_t position, int& lines);
+	// Position of the first occurrence of c at or after the position
+	static size_t Find(std::string_view input, size_t position, char c);
+
+	// Name of the implementation in use ("avx2", "sse2" or "scalar")
+	static const char* GetImplementation();
+	// Names of all implementations the cpu supports, the best one first
+	static std::vector<std::string> GetImplementations();
+	// Used to compare the implementations, returns false if the cpu does not support it
+	static bool SetImplementation(const std::string& name);
+};
+
+#endif
@@ -20,11 +20,19 @@ private:
     int level;
     Ref<ScopedSymbolTable> parent;
     std::map<std::string, Symbol> symbols;
+    // Function and global scopes own a frame, the variables of nested scopes get slots in it
+    bool frame;
+    int frameSize = 0;
 public:
-    ScopedSymbolTable(std::string name, int level, Ref<ScopedSymbolTable> parent);
+    ScopedSymbolTable(std::string name, int level, Ref<ScopedSymbolTable> parent, bool frame = false);
 
     void Add(const Symbol& symbol);
     std::optional<Symbol> Find(const std::string& symbolName);
+    // Like find, but also counts the frames between this scope and the scope of the symbol
+    std::optional<Symbol> Resolve(const std::string& symbolName, int& depth);
+
+    int AllocateSlot();
+    int GetFrameSize() const;
 
     int GetLevel() const;
     Ref<ScopedSymbolTable> GetParent() const;
@@ -16,10 +16,14 @@
 #include "ScopedSymbolTable.h"
 #include <FunctionRegistry.h>
 
-class SemanticAnalyzer : public Visitor, public std::enable_shared_from_this<SemanticAnalyzer>
+class SemanticAnalyzer : public Visitor
 {
 private:
     Ref<ScopedSymbolTable> currentScope;
+    std::map<std::string, FunctionNode*> globalFunctions;
+
+    // Type of the last visited expression, if it is known before execution
+    TokenType currentType = TokenType::None;
 
     void RegisterBuiltInSymbols();
 
@@ -27,42 +31,50 @@ private:
     void PushScope();
     void PopScope();
 
-    void EnsureVariableDeclaration(const Ref<Node>& node, const std::string& name);
-    void EnsureFunctionDeclaration(const Ref<Node>& node, const std::string& name);
-    void EnsureVariableUniqueness(const Ref<Node>& node, const std::string& name);
-    void EnsureFunctionUniqueness(const Ref<Node>& node, const std::string& name);
+    int DeclareVariable(const Node& node, const std::string& name, TokenType type = TokenType::None);
+    // Returns the type of the variable, if it is known before execution
+    TokenType ResolveVariable(const Node& node, const std::string& name, ResolvedVariable& variable);
+
+    void EnsureFunctionDeclaration(const Node& node, const std::string& name);
+    void EnsureVariableUniqueness(const Node& node, const std::string& name);
+    void EnsureFunctionUniqueness(const Node& node, const std::string& name);
 public:
-    SemanticAnalyzer(const std::vector<std::string>& args, const Ref<Node>& astRoot);
-    SemanticAnalyzer(const std::vector<std::string>& args, const Ref<Node>& astRoot, const Ref<ScopedSymbolTable>& scope);
+    SemanticAnalyzer(const Ref<Node>& astRoot);
+    SemanticAnalyzer(const Ref<Node>& astRoot, const Ref<ScopedSymbolTable>& scope);
     ~SemanticAnalyzer() = default;
 
     void Analyze();
+    // Analyzes the body of a lazily parsed function after it was parsed, which Analyze skipped.
+    // Bodies only depend on the global scope, so the result is the same as the one of Analyze.
+    void AnalyzeFunction(FunctionNode& function);
 
-    void Visit(const Ref<MainNode>& n) override;
-    void Visit(const Ref<VariableDeclarationAssignNode>& n) override;
-    void Visit(const Ref<VariableArrayDeclarationAssignNode>& n) override;
-    void Visit(const Ref<FunctionNode>& n) override;
-    void Visit(const Ref<FunctionCallNode>& n) override;
-    void Visit(const Ref<ForEachNode>& n) override;
-    void Visit(const Ref<ForINode>& n) override;
-    void Visit(const Ref<BlockNode>& n) override;
-    void Visit(const Ref<BinaryNode>& n) override;
-    void Visit(const Ref<BooleanNode>& n) override;
-    void Visit(const Ref<IfNode>& n) override;
-    void Visit(const Ref<WhileNode>& n) override;
-    void Visit(const Ref<DoWhileNode>& n) override;
-    void Visit(const Ref<VariableUsageNode>& n) override;
-    void Visit(const Ref<VariableAssignNode>& n) override;
-    void Visit(const Ref<VariableArrayUsageNode>& n) override;
-    void Visit(const Ref<VariableArrayAssignNode>& n) override;
-    void Visit(const Ref<VariableIncrementDecrementNode>& n) override;
-    void Visit(const Ref<VariableCompoundAssignNode>& n) override;
+    void Visit(MainNode& n) override;
+    void Visit(VariableDeclarationAssignNode& n) override;
+    void Visit(VariableArrayDeclarationAssignNode& n) override;
+    void Visit(FunctionNode& n) override;
+    void Visit(FunctionCallNode& n) override;
+    void Visit(ForEachNode& n) override;
+    void Visit(ForINode& n) override;
+    void Visit(BlockNode& n) override;
+    void Visit(BinaryNode& n) override;
+    void Visit(BooleanNode& n) override;
+    void Visit(IfNode& n) override;
+    void Visit(WhileNode& n) override;
+    void Visit(DoWhileNode& n) override;
+    void Visit(VariableUsageNode& n) override;
+    void Visit(VariableAssignNode& n) override;
+    void Visit(VariableArrayUsageNode& n) override;
+    void Visit(VariableArrayAssignNode& n) override;
+    void Visit(VariableIncrementDecrementNode& n) override;
+    void Visit(VariableCompoundAssignNode& n) override;
 
-    void Visit(const Ref<ReturnNode>& n) override {};
-    void Visit(const Ref<StringNode>& n) override {};
-    void Visit(const Ref<IntNode>& n) override {};
-    void Visit(const Ref<FloatNode>& n) override {};
-    void Visit(const Ref<BoolNode>& n) override {};
+    void Visit(ReturnNode& n) override;
+    void Visit(StringNode& n) override;
+    void Visit(IntNode& n) override { this->currentType = TokenType::Int; };
+    void Visit(FloatNode& n) override { this->currentType = TokenType::Float; };
+    void Visit(LongNode& n) override { this->currentType = TokenType::Long; };
+    void Visit(DoubleNode& n) override { this->currentType = TokenType::Double; };
+    void Visit(BoolNode& n) override { this->currentType = TokenType::Bool; };
 };
 
 #endif
@@ -9,15 +9,22 @@
 #define SYMBOL_H
 
 #include <string>
+#include "TokenType.h"
 
 class Symbol
 {
 private:
     std::string name;
+    // Slot of a variable in its frame, functions have none
+    int slot;
+    // Type of a variable, if it is known before execution. Variables keep the type of their declaration.
+    TokenType type;
 public:
-    explicit Symbol(std::string name);
+    explicit Symbol(std::string name, int slot = -1, TokenType type = TokenType::None);
 
     std::string GetName() const;
+    int GetSlot() const;
+    TokenType GetType() const;
 };
 
 #endif
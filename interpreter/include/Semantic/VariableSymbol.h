@@ -13,7 +13,7 @@
 class VariableSymbol : public Symbol
 {
 public:
-    VariableSymbol(std::string name);
+    VariableSymbol(std::string name, int slot, TokenType type = TokenType::None);
 };
 
 #endif
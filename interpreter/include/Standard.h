@@ -8,6 +8,9 @@
 #ifndef STANDARD_H
 #define STANDARD_H
 
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <limits>
 #include <random>
 #include <algorithm>
 #include <fstream>
@@ -16,31 +19,40 @@
 #include <filesystem>
 #include <regex>
 #include <iostream>
+#include "Value.h"
 
 namespace Iona
 {
-	static std::string ToStringInternal(VariableType v)
+	static std::string ToStringInternal(const Value& v)
 	{
-		switch (v.type)
+		switch (v.GetType())
 		{
             case TokenType::String:
-                return std::any_cast<std::string>(v.value);
+                return v.GetString();
             case TokenType::Int:
-                return std::to_string(std::any_cast<int>(v.value));
+                return std::to_string(v.GetInt());
             case TokenType::Float:
             {
                 std::stringstream stream;
-                stream << std::fixed << std::setprecision(2) << std::any_cast<float>(v.value);
+                stream << std::fixed << std::setprecision(2) << v.GetFloat();
+                return stream.str();
+            }
+            case TokenType::Long:
+                return std::to_string(v.GetLong());
+            case TokenType::Double:
+            {
+                std::stringstream stream;
+                stream << std::fixed << std::setprecision(2) << v.GetDouble();
                 return stream.str();
             }
             case TokenType::Bool:
-                return std::any_cast<bool>(v.value) ? "true" : "false";
+                return v.GetBool() ? "true" : "false";
             case TokenType::IntArray:
             {
                 std::stringstream out;
-                for (auto& variable : std::any_cast<std::vector<VariableType>>(v.value))
+                for (auto value : v.GetIntArray())
                 {
-                    out << std::any_cast<int>(variable.value) << ", ";
+                    out << value << ", ";
                 }
                 std::string s = out.str();
                 return s.substr(0, s.size() - 2);
@@ -48,9 +60,9 @@ namespace Iona
             case TokenType::FloatArray:
             {
                 std::stringstream out;
-                for (auto& variable : std::any_cast<std::vector<VariableType>>(v.value))
+                for (auto value : v.GetFloatArray())
                 {
-                    out << std::any_cast<float>(variable.value) << ", ";
+                    out << value << ", ";
                 }
                 std::string s = out.str();
                 return s.substr(0, s.size() - 2);
@@ -58,9 +70,9 @@ namespace Iona
             case TokenType::StringArray:
             {
                 std::stringstream out;
-                for (auto& variable : std::any_cast<std::vector<VariableType>>(v.value))
+                for (auto& value : v.GetStringArray())
                 {
-                    out << std::any_cast<std::string>(variable.value) << ", ";
+                    out << value.GetString() << ", ";
                 }
                 std::string s = out.str();
                 return s.substr(0, s.size() - 2);
@@ -68,9 +80,9 @@ namespace Iona
             case TokenType::BoolArray:
             {
                 std::stringstream out;
-                for (auto& variable : std::any_cast<std::vector<VariableType>>(v.value))
+                for (auto value : v.GetBoolArray())
                 {
-                    out << (std::any_cast<bool>(variable.value) ? "true" : "false") << ", ";
+                    out << (value ? "true" : "false") << ", ";
                 }
                 std::string s = out.str();
                 return s.substr(0, s.size() - 2);
@@ -82,200 +94,183 @@ namespace Iona
 
 	namespace Core
 	{
-		static void Size(std::vector<VariableType>& in, VariableType& out)
+		static void Size(std::vector<Value>& in, Value& out)
 		{
-			VariableType v = in[0];
+			const Value& v = in[0];
 
-			out.type = TokenType::Int;
-
-			switch (v.type)
+			switch (v.GetType())
 			{
 				case TokenType::String:
-					out.value = (int) std::any_cast<std::string>(v.value).size();
+					out = Value((int) v.GetString().size());
 					break;
 				case TokenType::StringArray:
 				case TokenType::IntArray:
 				case TokenType::BoolArray:
 				case TokenType::FloatArray:
-					out.value = (int) std::any_cast<std::vector<VariableType>>(v.value).size();
+					out = Value((int) v.GetArraySize());
 					break;
 			}
 		}
 
-		static void Empty(std::vector<VariableType>& in, VariableType& out)
+		static void Empty(std::vector<Value>& in, Value& out)
 		{
-			VariableType v = in[0];
-
-			out.type = TokenType::Bool;
+			const Value& v = in[0];
 
-			switch (v.type)
+			switch (v.GetType())
 			{
 				case TokenType::String:
-					out.value = std::any_cast<std::string>(v.value).empty();
+					out = Value(v.GetString().empty());
 					break;
 				case TokenType::StringArray:
 				case TokenType::IntArray:
 				case TokenType::BoolArray:
 				case TokenType::FloatArray:
-					out.value = std::any_cast<std::vector<VariableType>>(v.value).empty();
+					out = Value(v.GetArraySize() == 0);
 					break;
 			}
 		}
 
-		static void Random(std::vector<VariableType>& in, VariableType& out)
+		static void Random(std::vector<Value>& in, Value& out)
 		{
-			VariableType lowerBoundT = in[0];
-			VariableType upperBoundT = in[1];
-
-			int lowerBound = std::any_cast<int>(lowerBoundT.value);
-			int upperBound = std::any_cast<int>(upperBoundT.value);
+			int lowerBound = in[0].GetInt();
+			int upperBound = in[1].GetInt();
 
 			std::random_device rd;
 			std::mt19937 gen(rd());
 			std::uniform_int_distribution<> dis(lowerBound, upperBound);
 
-			out.type = TokenType::Int;
-			out.value = dis(gen);
+			out = Value(dis(gen));
 		}
 
-		static void Range(std::vector<VariableType>& in, VariableType& out)
+		static void Range(std::vector<Value>& in, Value& out)
 		{
-			VariableType upperBoundT = in[0];
+			int upperBound = in[0].GetInt();
 
-			int upperBound = std::any_cast<int>(upperBoundT.value);
-
-			std::vector<VariableType> values;
-			values.reserve(upperBound);
-            for (int i = 0; i < upperBound; i++)
+			std::vector<int32_t> values(std::max(upperBound, 0));
+			for (int i = 0; i < upperBound; i++)
 			{
-				values.push_back({ TokenType::Int, (int) i });
+				values[i] = i;
 			}
 
-			out.type = TokenType::IntArray;
-			out.value = std::move(values);
+			out = Value(std::move(values));
 		}
 
-		static void Reverse(std::vector<VariableType>& in, VariableType& out)
+		static void Reverse(std::vector<Value>& in, Value& out)
 		{
-			VariableType arrayT = in[0];
-
-			auto array = std::any_cast<std::vector<VariableType>>(arrayT.value);
+			const Value& arrayT = in[0];
 
-			std::reverse(array.begin(), array.end());
-
-			out.type = arrayT.type;
-			out.value = std::move(array);
+			switch (arrayT.GetType())
+			{
+				case TokenType::IntArray:
+					out = Value(std::vector<int32_t>(arrayT.GetIntArray().rbegin(), arrayT.GetIntArray().rend()));
+					break;
+				case TokenType::FloatArray:
+					out = Value(std::vector<float>(arrayT.GetFloatArray().rbegin(), arrayT.GetFloatArray().rend()));
+					break;
+				case TokenType::BoolArray:
+					out = Value(std::vector<bool>(arrayT.GetBoolArray().rbegin(), arrayT.GetBoolArray().rend()));
+					break;
+				case TokenType::StringArray:
+					out = Value(TokenType::StringArray, std::vector<Value>(arrayT.GetStringArray().rbegin(), arrayT.GetStringArray().rend()));
+					break;
+			}
 		}
 
-		static void ToString(std::vector<VariableType>& in, VariableType& out)
+		static void ToString(std::vector<Value>& in, Value& out)
 		{
-			VariableType variableT = in[0];
+			// Strings are immutable, so the storage can be shared
+			if (in[0].GetType() == TokenType::String)
+			{
+				out = in[0];
+				return;
+			}
 
-			out.type = TokenType::String;
-			out.value = ToStringInternal(variableT);
+			out = Value(ToStringInternal(in[0]));
 		}
 	}
 
 	namespace String
 	{
-		static void ToUpperCase(std::vector<VariableType>& in, VariableType& out)
+		static void ToUpperCase(std::vector<Value>& in, Value& out)
 		{
-			VariableType v = in[0];
-
-			auto value = std::any_cast<std::string>(v.value);
+			std::string value = in[0].GetString();
 			std::transform(value.begin(), value.end(), value.begin(),
 				[](unsigned char c) -> unsigned char { return std::toupper(c); });
 
-			out.type = TokenType::String;
-			out.value = value;
+			out = Value(std::move(value));
 		}
 
-		static void ToLowerCase(std::vector<VariableType>& in, VariableType& out)
+		static void ToLowerCase(std::vector<Value>& in, Value& out)
 		{
-			VariableType v = in[0];
-
-			auto value = std::any_cast<std::string>(v.value);
+			std::string value = in[0].GetString();
 			std::transform(value.begin(), value.end(), value.begin(),
 				[](unsigned char c) -> unsigned char { return std::tolower(c); });
 
-			out.type = TokenType::String;
-			out.value = value;
+			out = Value(std::move(value));
 		}
 
-		static void StartsWith(std::vector<VariableType>& in, VariableType& out)
+		static void StartsWith(std::vector<Value>& in, Value& out)
 		{
-			VariableType valueT = in[0];
-			VariableType prefixT = in[1];
-
-			auto value = std::any_cast<std::string>(valueT.value);
-			auto prefix = std::any_cast<std::string>(prefixT.value);
+			const std::string& value = in[0].GetString();
+			const std::string& prefix = in[1].GetString();
 
-			out.type = TokenType::Bool;
-			out.value = Helper::StartsWith(value, prefix);
+			out = Value(Helper::StartsWith(value, prefix));
 		}
 
-		static void EndsWith(std::vector<VariableType>& in, VariableType& out)
+		static void EndsWith(std::vector<Value>& in, Value& out)
 		{
-			VariableType valueT = in[0];
-			VariableType suffixT = in[1];
+			const std::string& value = in[0].GetString();
+			const std::string& suffix = in[1].GetString();
 
-			auto value = std::any_cast<std::string>(valueT.value);
-			auto suffix = std::any_cast<std::string>(suffixT.value);
-
-			out.type = TokenType::Bool;
-			out.value = Helper::EndsWith(value, suffix);
+			out = Value(Helper::EndsWith(value, suffix));
 		}
 
-		static void Contains(std::vector<VariableType>& in, VariableType& out)
+		static void Contains(std::vector<Value>& in, Value& out)
 		{
-			VariableType haystackT = in[0];
-			VariableType needleT = in[1];
-
-			auto haystack = std::any_cast<std::string>(haystackT.value);
-			auto needle = std::any_cast<std::string>(needleT.value);
+			const std::string& haystack = in[0].GetString();
+			const std::string& needle = in[1].GetString();
 
-			out.type = TokenType::Bool;
-			out.value = haystack.find(needle) != std::string::npos;
+			out = Value(haystack.find(needle) != std::string::npos);
 		}
 
-		static void Split(std::vector<VariableType>& in, VariableType& out)
+		static void Split(std::vector<Value>& in, Value& out)
 		{
-			VariableType valueT = in[0];
-			VariableType delimiterT = in[1];
-
-			auto value = std::any_cast<std::string>(valueT.value);
-			auto delimiter = std::any_cast<std::string>(delimiterT.value);
+			const std::string& value = in[0].GetString();
+			const std::string& delimiter = in[1].GetString();
 
-			std::vector<VariableType> values;
+			std::vector<Value> values;
 			size_t start;
 			size_t end = 0;
 
 			while ((start = value.find_first_not_of(delimiter, end)) != std::string::npos)
 			{
 				end = value.find(delimiter, start);
-				values.push_back({ TokenType::String, value.substr(start, end - start) });
+				values.emplace_back(value.substr(start, end - start));
 			}
 
-			out.type = TokenType::StringArray;
-			out.value = std::move(values);
+			out = Value(TokenType::StringArray, std::move(values));
 		}
 
-		static void Trim(std::vector<VariableType>& in, VariableType& out)
+		static void Trim(std::vector<Value>& in, Value& out)
 		{
-			VariableType valueT = in[0];
+            const std::string& value = in[0].GetString();
 
-            auto value = std::any_cast<std::string>(valueT.value);
-
-			value.erase(value.begin(), std::find_if(value.begin(), value.end(), [](int ch) {
+			auto begin = std::find_if(value.begin(), value.end(), [](int ch) {
 				return !std::isspace(ch);
-			}));
+			});
 
-			value.erase(std::find_if(value.rbegin(), value.rend(), [](int ch) {
+			auto end = std::find_if(value.rbegin(), value.rend(), [](int ch) {
 				return !std::isspace(ch);
-				}).base(), value.end());
+				}).base();
+
+			// Share the storage if there is nothing to trim
+			if (begin == value.begin() && end == value.end())
+			{
+				out = in[0];
+				return;
+			}
 
-			out.type = TokenType::String;
-			out.value = std::move(value);
+			out = Value(begin < end ? std::string(begin, end) : std::string());
 		}
 	}
 
@@ -283,108 +278,83 @@ namespace Iona
 	{
 		namespace fs = std::filesystem;
 
-		static void FileExists(std::vector<VariableType>& in, VariableType& out)
+		static void FileExists(std::vector<Value>& in, Value& out)
 		{
-			VariableType v = in[0];
+			const std::string& path = in[0].GetString();
 
-			auto path = std::any_cast<std::string>(v.value);
-
-			out.type = TokenType::Bool;
-			out.value = fs::exists(path);
+			out = Value(fs::exists(path));
 		}
 
-		static void FileRead(std::vector<VariableType>& in, VariableType& out)
+		static void FileRead(std::vector<Value>& in, Value& out)
 		{
-			VariableType v = in[0];
-
-            auto path = std::any_cast<std::string>(v.value);
+            const std::string& path = in[0].GetString();
 
 			std::ifstream file{ path };
-			
-			out.type = TokenType::String;
-			out.value = std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+			out = Value(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
 		}
 
-		static void FileWrite(std::vector<VariableType>& in, VariableType& out)
+		static void FileWrite(std::vector<Value>& in, Value& out)
 		{
-			VariableType pathT = in[0];
-			VariableType dataT = in[1];
-
-			auto path = std::any_cast<std::string>(pathT.value);
-			auto data = std::any_cast<std::string>(dataT.value);
+			const std::string& path = in[0].GetString();
+			const std::string& data = in[1].GetString();
 
 			std::ofstream o{ path, std::ofstream::out };
 			o << data;
-			
-			out.type = TokenType::Bool;
-			out.value = !o.bad();
+
+			out = Value(!o.bad());
 		}
 
-		static void FileCopy(std::vector<VariableType>& in, VariableType& out)
+		static void FileCopy(std::vector<Value>& in, Value& out)
 		{
-			VariableType srcPathT = in[0];
-			VariableType destPathT = in[1];
-
-			auto srcPath = std::any_cast<std::string>(srcPathT.value);
-			auto destPath = std::any_cast<std::string>(destPathT.value);
+			const std::string& srcPath = in[0].GetString();
+			const std::string& destPath = in[1].GetString();
 
 			std::error_code error;
 			std::filesystem::copy(srcPath, destPath, fs::copy_options::recursive, error);
 
-			out.type = TokenType::Bool;
-			out.value = !error;
+			out = Value(!error);
 		}
 
-		static void FileReadLines(std::vector<VariableType>& in, VariableType& out)
+		static void FileReadLines(std::vector<Value>& in, Value& out)
 		{
-			VariableType v = in[0];
-
-			auto path = std::any_cast<std::string>(v.value);
+			const std::string& path = in[0].GetString();
 
-			std::vector<VariableType> lines;
+			std::vector<Value> lines;
 
 			std::ifstream file{ path };
 			std::string line;
 			while (std::getline(file, line))
 			{
-				lines.push_back({ TokenType::String, line });
+				lines.emplace_back(line);
 			}
 			file.close();
 
-			out.type = TokenType::StringArray;
-			out.value = lines;
+			out = Value(TokenType::StringArray, std::move(lines));
 		}
 
-		static void FileWriteLines(std::vector<VariableType>& in, VariableType& out)
+		static void FileWriteLines(std::vector<Value>& in, Value& out)
 		{
-			VariableType pathT = in[0];
-			VariableType dataT = in[1];
-			VariableType appendT = in[2];
-
-			auto path = std::any_cast<std::string>(pathT.value);
-			auto data = std::any_cast<std::vector<VariableType>>(dataT.value);
-			bool append = std::any_cast<bool>(appendT.value);
+			const std::string& path = in[0].GetString();
+			const std::vector<Value>& data = in[1].GetStringArray();
+			bool append = in[2].GetBool();
 
 			std::ofstream file{ path, append ? std::ios_base::app : std::ios_base::trunc };
 			for (const auto& value : data)
 			{
-				file << std::any_cast<std::string>(value.value) << std::endl;
+				file << value.GetString() << std::endl;
 			}
 			file.close();
 
-			out.type = TokenType::Bool;
-			out.value = !file.bad();
+			out = Value(!file.bad());
 		}
 
-		static void FileList(std::vector<VariableType>& in, VariableType& out)
+		static void FileList(std::vector<Value>& in, Value& out)
 		{
-			VariableType pathT = in[0];
-			VariableType regexStringT = in[1];
+			const std::string& path = in[0].GetString();
+			std::string regexString = in[1].GetString();
 
-			auto path = std::any_cast<std::string>(pathT.value);
-			auto regexString = std::any_cast<std::string>(regexStringT.value);
-			
-			std::vector<VariableType> files;
+			std::vector<Value> files;
 
 			try
 			{
@@ -399,7 +369,7 @@ namespace Iona
 				{
 					if (std::regex_match(p.path().string(), regex))
 					{
-						files.push_back(VariableType{ TokenType::String, p.path().string() });
+						files.emplace_back(p.path().string());
 					}
 				}
 			}
@@ -412,96 +382,106 @@ namespace Iona
 				// TODO: Language runtime error handling
 			}
 
-			out.type = TokenType::StringArray;
-			out.value = files;
+			out = Value(TokenType::StringArray, std::move(files));
 		}
 	}
 
 	namespace Console
 	{
-		static void WriteLine(std::vector<VariableType>& in, VariableType& out)
+		static void WriteLine(std::vector<Value>& in, Value& out)
 		{
-			VariableType v = in[0];
-
-			printf("%s\n", ToStringInternal(v).c_str());
+			printf("%s\n", ToStringInternal(in[0]).c_str());
 		}
 
-		static void ReadLine(std::vector<VariableType>& in, VariableType& out)
+		static void ReadLine(std::vector<Value>& in, Value& out)
 		{
 			std::string input;
 			std::getline(std::cin, input);
 
-			out.type = TokenType::String;
-			out.value = input;
+			out = Value(std::move(input));
 		}
 
-		static void ReadInt(std::vector<VariableType>& in, VariableType& out)
+		static void ReadInt(std::vector<Value>& in, Value& out)
 		{
 			int read;
 			std::cin >> read;
 
-			out.type = TokenType::Int;
-			out.value = read;
+			out = Value(read);
 		}
 
-		static void ReadFloat(std::vector<VariableType>& in, VariableType& out)
+		static void ReadFloat(std::vector<Value>& in, Value& out)
 		{
 			float read;
 			std::cin >> read;
 
-			out.type = TokenType::Float;
-			out.value = read;
+			out = Value(read);
 		}
 	}
 
 	namespace Math
 	{
-		static void Min(std::vector<VariableType>& in, VariableType& out)
+		static void Min(std::vector<Value>& in, Value& out)
 		{
-			VariableType valueOneT = in[0];
-			VariableType valueTwoT = in[1];
+			const Value& valueOneT = in[0];
+			const Value& valueTwoT = in[1];
 
-			if (valueOneT.type == TokenType::Int && valueTwoT.type == TokenType::Int)
+			if (valueOneT.GetType() == TokenType::Int && valueTwoT.GetType() == TokenType::Int)
 			{
-				int valueOne = std::any_cast<int>(valueOneT.value);
-				int valueTwo = std::any_cast<int>(valueTwoT.value);
-
-				out.type = TokenType::Int;
-				out.value = std::min(valueOne, valueTwo);
+				out = Value(std::min(valueOneT.GetInt(), valueTwoT.GetInt()));
 			}
-			else if (valueOneT.type == TokenType::Float && valueTwoT.type == TokenType::Float)
+			else if (valueOneT.GetType() == TokenType::Float && valueTwoT.GetType() == TokenType::Float)
 			{
-				auto valueOne = std::any_cast<float>(valueOneT.value);
-				auto valueTwo = std::any_cast<float>(valueTwoT.value);
-
-				out.type = TokenType::Float;
-				out.value = std::min(valueOne, valueTwo);
+				out = Value(std::min(valueOneT.GetFloat(), valueTwoT.GetFloat()));
+			}
+			else if (valueOneT.GetType() == TokenType::Long && valueTwoT.GetType() == TokenType::Long)
+			{
+				out = Value(std::min(valueOneT.GetLong(), valueTwoT.GetLong()));
+			}
+			else if (valueOneT.GetType() == TokenType::Double && valueTwoT.GetType() == TokenType::Double)
+			{
+				out = Value(std::min(valueOneT.GetDouble(), valueTwoT.GetDouble()));
 			}
 		}
 
-		static void Max(std::vector<VariableType>& in, VariableType& out)
+		static void Max(std::vector<Value>& in, Value& out)
 		{
-			VariableType valueOneT = in[0];
-			VariableType valueTwoT = in[1];
+			const Value& valueOneT = in[0];
+			const Value& valueTwoT = in[1];
 
-			if (valueOneT.type == TokenType::Int && valueTwoT.type == TokenType::Int)
+			if (valueOneT.GetType() == TokenType::Int && valueTwoT.GetType() == TokenType::Int)
 			{
-				int valueOne = std::any_cast<int>(valueOneT.value);
-				int valueTwo = std::any_cast<int>(valueTwoT.value);
-
-				out.type = TokenType::Int;
-				out.value = std::max(valueOne, valueTwo);
+				out = Value(std::max(valueOneT.GetInt(), valueTwoT.GetInt()));
 			}
-			else if (valueOneT.type == TokenType::Float && valueTwoT.type == TokenType::Float)
+			else if (valueOneT.GetType() == TokenType::Float && valueTwoT.GetType() == TokenType::Float)
 			{
-				auto valueOne = std::any_cast<float>(valueOneT.value);
-				auto valueTwo = std::any_cast<float>(valueTwoT.value);
-
-				out.type = TokenType::Float;
-				out.value = std::max(valueOne, valueTwo);
+				out = Value(std::max(valueOneT.GetFloat(), valueTwoT.GetFloat()));
+			}
+			else if (valueOneT.GetType() == TokenType::Long && valueTwoT.GetType() == TokenType::Long)
+			{
+				out = Value(std::max(valueOneT.GetLong(), valueTwoT.GetLong()));
+			}
+			else if (valueOneT.GetType() == TokenType::Double && valueTwoT.GetType() == TokenType::Double)
+			{
+				out = Value(std::max(valueOneT.GetDouble(), valueTwoT.GetDouble()));
 			}
 		}
 	}
+
+	// Constant variables which are declared in the global scope of every program
+	static std::vector<std::pair<std::string, Value>> InternalVariables()
+	{
+		return {
+			{ "PI", Value((float) M_PI) },
+			{ "INT_MIN", Value(std::numeric_limits<int>::min()) },
+			{ "INT_MAX", Value(std::numeric_limits<int>::max()) },
+			{ "FLOAT_MIN", Value(std::numeric_limits<float>::min()) },
+			{ "FLOAT_MAX", Value(std::numeric_limits<float>::max()) },
+			{ "LONG_MIN", Value(std::numeric_limits<int64_t>::min()) },
+			{ "LONG_MAX", Value(std::numeric_limits<int64_t>::max()) },
+			{ "DOUBLE_MIN", Value(std::numeric_limits<double>::min()) },
+			{ "DOUBLE_MAX", Value(std::numeric_limits<double>::max()) }
+		};
+	}
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -8,39 +8,85 @@
 #ifndef TOKEN_H
 #define TOKEN_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include "TokenType.h"
 
+// Tokens do not own their text, the value is a view into the input of the lexer (or a
+// static spelling) and the file is an id of the FileTable. Copying a token never allocates.
+// Number literals are converted once by the lexer, their 64 bit value is stored next to the text.
 class Token
 {
 private:
 	TokenType tokenType;
-	std::string value;
+	std::string_view value;
+	union
+	{
+		int64_t intValue;
+		double floatValue;
+	};
 
-	std::string fileName;
+	uint32_t fileId;
 	int line;
 public:
-	Token();
-	Token(const TokenType& tokenType, std::string  value, std::string fileName, int line = 1);
+	Token()
+		: tokenType(TokenType::None), intValue(0), fileId(0), line(0)
+	{
+	}
+
+	Token(TokenType tokenType, std::string_view value, uint32_t fileId, int line = 1)
+		: tokenType(tokenType), value(value), intValue(0), fileId(fileId), line(line)
+	{
+	}
+
+	// Int or long literal
+	Token(TokenType tokenType, std::string_view value, int64_t intValue, uint32_t fileId, int line)
+		: tokenType(tokenType), value(value), intValue(intValue), fileId(fileId), line(line)
+	{
+	}
+
+	// Float or double literal
+	Token(TokenType tokenType, std::string_view value, double floatValue, uint32_t fileId, int line)
+		: tokenType(tokenType), value(value), floatValue(floatValue), fileId(fileId), line(line)
+	{
+	}
+
 	~Token() = default;
 
-	TokenType GetTokenType() const;
-	std::string GetValue() const;
+	TokenType GetTokenType() const
+	{
+		return tokenType;
+	}
+
+	std::string_view GetValue() const
+	{
+		return value;
+	}
 
-	std::string GetFileName() const
-    {
-	    return fileName;
-    }
+	// Only valid for int and long tokens
+	int64_t GetInt() const
+	{
+		return intValue;
+	}
 
-	int GetLine() const
+	// Only valid for float and double tokens
+	double GetFloat() const
 	{
-		return line;
+		return floatValue;
 	}
 
-	void SetLine(const int lineNumber)
+	uint32_t GetFileId() const
 	{
-		this->line = lineNumber;
+		return fileId;
+	}
+
+	const std::string& GetFileName() const;
+
+	int GetLine() const
+	{
+		return line;
 	}
 };
 
-#endif
\ No newline at end of file
+#endif
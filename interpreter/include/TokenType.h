@@ -10,9 +10,9 @@
 
 #include <string>
 #include <vector>
-#include <any>
+#include <cstdint>
 
-enum TokenType
+enum TokenType : uint8_t
 {
 	Function,
 	Name,
@@ -39,6 +39,8 @@ enum TokenType
 
 	Int,
 	Float,
+	Long,
+	Double,
 	Bool,
 	String,
 	IntArray,
@@ -75,32 +77,71 @@ enum TokenType
 	None
 };
 
-struct VariableType
-{
-	TokenType type;
-	std::any value;
-};
-
 static bool IsVariableType(const TokenType& type)
 {
 	return type == TokenType::Int || type == TokenType::String || type == TokenType::Float || type == TokenType::Bool
+		|| type == TokenType::Long || type == TokenType::Double
 		|| type == TokenType::StringArray || type == TokenType::IntArray || type == TokenType::BoolArray || type == TokenType::FloatArray;
 }
 
+// Ints, floats, longs and doubles, only values of the same type can be calculated with each other
+static bool IsNumberType(const TokenType& type)
+{
+	return type == TokenType::Int || type == TokenType::Float || type == TokenType::Long || type == TokenType::Double;
+}
+
 static bool IsVariableArrayType(const TokenType& type)
 {
 	return type == TokenType::StringArray || type == TokenType::IntArray || 
 			type == TokenType::BoolArray || type == TokenType::FloatArray;
 }
 
+static TokenType GetArrayElementType(const TokenType& arrayType)
+{
+	switch (arrayType)
+	{
+		case TokenType::IntArray:
+			return TokenType::Int;
+		case TokenType::FloatArray:
+			return TokenType::Float;
+		case TokenType::BoolArray:
+			return TokenType::Bool;
+		case TokenType::StringArray:
+			return TokenType::String;
+		default:
+			return TokenType::None;
+	}
+}
+
 namespace Helper
 {
 	static std::string ToString(const TokenType& type)
 	{
-		static const char* values[] = { "Function", "Name", "Call", "For", "In", "Step", "While", "Do", "If", "Else", "When", "CurlyLeft", "CurlyRight", "SquareLeft", "SquareRight", "ParanLeft", "ParanRight", "Var", "Int", "Float", "Bool", "String", "IntArray", "BoolArray", "FloatArray", "StringArray", "Array", "Auto", "Return", "Assign", "Comma", "Semicolon", "Colon", "New", "Point", "ExclamationMark", "Arrow", "Plus", "PlusPlus", "Minus", "MinusMinus", "Multiply", "Divide", "Equals", "NotEquals", "GreaterThan", "LessThan", "GreaterEqualThan", "LessEqualThan", "None" };
+		static const char* values[] = { "Function", "Name", "Call", "For", "In", "Step", "While", "Do", "If", "Else", "When", "CurlyLeft", "CurlyRight", "SquareLeft", "SquareRight", "ParanLeft", "ParanRight", "Var", "Int", "Float", "Long", "Double", "Bool", "String", "IntArray", "BoolArray", "FloatArray", "StringArray", "Array", "Auto", "Return", "Assign", "Comma", "Semicolon", "Colon", "New", "Point", "ExclamationMark", "Arrow", "Plus", "PlusPlus", "Minus", "MinusMinus", "Multiply", "Divide", "Equals", "NotEquals", "GreaterThan", "LessThan", "GreaterEqualThan", "LessEqualThan", "None" };
 		return values[static_cast<int>(type)];
 	}
 
+	// Names of a set of token types with one bit per type, eg. 'Int', 'Float' or 'Long'
+	inline std::string TypesToString(uint64_t types)
+	{
+		std::vector<std::string> names;
+		for (int type = 0; type < TokenType::None; type++)
+		{
+			if ((types & ((uint64_t) 1 << type)) != 0)
+			{
+				names.push_back("'" + ToString((TokenType) type) + "'");
+			}
+		}
+
+		std::string result;
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			result += (i == 0 ? "" : i + 1 == names.size() ? " or " : ", ") + names[i];
+		}
+
+		return result;
+	}
+
 	static bool StartsWith(const std::string& s, const std::string& suffix)
 	{
 		return s.rfind(suffix, 0) == 0;
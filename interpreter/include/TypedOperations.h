@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef TYPED_OPERATIONS_H
+#define TYPED_OPERATIONS_H
+
+#include <functional>
+#include "TokenType.h"
+#include "Value.h"
+
+// Operations for operands whose types the semantic analyzer has proven. They are instantiated
+// per operator and type and run without checking the types of their operands.
+using BinaryOperation = void (*)(const Value& left, const Value& right, Value& result);
+using IncrementOperation = void (*)(Value& variable, int value);
+
+// Typed operation for the operand types a node has seen last, used where the types could not be proven
+struct InlineCache
+{
+	TokenType left = TokenType::None;
+	TokenType right = TokenType::None;
+	BinaryOperation operation = nullptr;
+};
+
+template <typename T>
+T ValueAs(const Value& value);
+
+template <>
+inline int ValueAs<int>(const Value& value)
+{
+	return value.GetInt();
+}
+
+template <>
+inline float ValueAs<float>(const Value& value)
+{
+	return value.GetFloat();
+}
+
+template <>
+inline int64_t ValueAs<int64_t>(const Value& value)
+{
+	return value.GetLong();
+}
+
+template <>
+inline double ValueAs<double>(const Value& value)
+{
+	return value.GetDouble();
+}
+
+// The result may be one of the operands, so it is only written after both are read
+template <typename Operation, typename T>
+void Arithmetic(const Value& left, const Value& right, Value& result)
+{
+	result = Value(Operation()(ValueAs<T>(left), ValueAs<T>(right)));
+}
+
+// Numbers of different types are compared with the usual arithmetic conversions, like in Value::Compare
+template <typename Operation, typename L, typename R>
+void Comparison(const Value& left, const Value& right, Value& result)
+{
+	result = Value((bool) Operation()(ValueAs<L>(left), ValueAs<R>(right)));
+}
+
+template <typename Operation>
+void StringComparison(const Value& left, const Value& right, Value& result)
+{
+	result = Value((bool) Operation()(left.GetString(), right.GetString()));
+}
+
+template <typename T>
+void IncrementDecrement(Value& variable, int value)
+{
+	variable = Value(WrappingPlus<T>()(ValueAs<T>(variable), (T) value));
+}
+
+inline void StringConcat(const Value& left, const Value& right, Value& result)
+{
+	result = Value(left.GetString() + right.GetString());
+}
+
+constexpr BinaryOperation IntAdd = Arithmetic<WrappingPlus<int>, int>;
+constexpr BinaryOperation IntSubtract = Arithmetic<WrappingMinus<int>, int>;
+constexpr BinaryOperation IntMultiply = Arithmetic<WrappingMultiplies<int>, int>;
+constexpr BinaryOperation IntDivide = Arithmetic<std::divides<int>, int>;
+constexpr BinaryOperation FloatAdd = Arithmetic<WrappingPlus<float>, float>;
+constexpr BinaryOperation FloatSubtract = Arithmetic<WrappingMinus<float>, float>;
+constexpr BinaryOperation FloatMultiply = Arithmetic<WrappingMultiplies<float>, float>;
+constexpr BinaryOperation FloatDivide = Arithmetic<std::divides<float>, float>;
+
+constexpr BinaryOperation IntEquals = Comparison<std::equal_to<>, int, int>;
+constexpr BinaryOperation IntNotEquals = Comparison<std::not_equal_to<>, int, int>;
+constexpr BinaryOperation IntLessThan = Comparison<std::less<>, int, int>;
+constexpr BinaryOperation IntGreaterThan = Comparison<std::greater<>, int, int>;
+constexpr BinaryOperation IntLessEqualThan = Comparison<std::less_equal<>, int, int>;
+constexpr BinaryOperation IntGreaterEqualThan = Comparison<std::greater_equal<>, int, int>;
+
+constexpr IncrementOperation IntIncrementDecrement = IncrementDecrement<int>;
+constexpr IncrementOperation FloatIncrementDecrement = IncrementDecrement<float>;
+
+// The specializations return nullptr if the operation has none for the types, the node then
+// keeps checking the types of its operands while executing
+BinaryOperation SpecializeArithmetic(TokenType operant, TokenType left, TokenType right);
+BinaryOperation SpecializeComparison(TokenType operant, TokenType left, TokenType right);
+IncrementOperation SpecializeIncrementDecrement(TokenType type);
+
+#endif
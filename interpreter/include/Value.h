@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef VALUE_H
+#define VALUE_H
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "TokenType.h"
+
+class Value;
+
+// Ints and longs wrap around on overflow. Their arithmetic is done unsigned and converted
+// back, because the overflow of signed integers is undefined behaviour in C++.
+template<typename T>
+using WrappingType = typename std::conditional<std::is_integral<T>::value, std::make_unsigned<T>, std::common_type<T>>::type::type;
+
+template<typename T>
+struct WrappingPlus
+{
+	T operator()(T left, T right) const
+	{
+		return (T) ((WrappingType<T>) left + (WrappingType<T>) right);
+	}
+};
+
+template<typename T>
+struct WrappingMinus
+{
+	T operator()(T left, T right) const
+	{
+		return (T) ((WrappingType<T>) left - (WrappingType<T>) right);
+	}
+};
+
+template<typename T>
+struct WrappingMultiplies
+{
+	T operator()(T left, T right) const
+	{
+		return (T) ((WrappingType<T>) left * (WrappingType<T>) right);
+	}
+};
+
+// Heap storage of string and array values. It is shared between all values
+// pointing to it and freed when the last one releases it.
+struct HeapObject
+{
+	uint32_t refCount = 1;
+};
+
+struct StringObject : HeapObject
+{
+	std::string value;
+
+	explicit StringObject(std::string value) : value(std::move(value)) { }
+};
+
+// Arrays are stored densely by their element type, bool arrays as a packed
+// bitset (std::vector<bool>) and string arrays as string values (handles)
+template<typename T>
+struct ArrayObject : HeapObject
+{
+	std::vector<T> values;
+
+	explicit ArrayObject(std::vector<T> values) : values(std::move(values)) { }
+};
+
+using IntArrayObject = ArrayObject<int32_t>;
+using FloatArrayObject = ArrayObject<float>;
+using BoolArrayObject = ArrayObject<bool>;
+using StringArrayObject = ArrayObject<Value>;
+
+// Runtime value of the interpreter. Numbers and bools are stored inline,
+// strings and arrays are stored as a pointer to reference counted storage.
+class Value
+{
+private:
+	// Compiled machine code reads and writes the type and the inline values directly
+	friend class Jit;
+
+	TokenType type;
+	union
+	{
+		int intValue;
+		float floatValue;
+		int64_t longValue;
+		double doubleValue;
+		bool boolValue;
+		StringObject* stringObject;
+		IntArrayObject* intArrayObject;
+		FloatArrayObject* floatArrayObject;
+		BoolArrayObject* boolArrayObject;
+		StringArrayObject* stringArrayObject;
+		HeapObject* heapObject;
+	};
+
+	bool IsHeapType() const
+	{
+		return type == TokenType::String || IsVariableArrayType(type);
+	}
+
+	void Retain() const
+	{
+		if (IsHeapType())
+		{
+			heapObject->refCount++;
+		}
+	}
+
+	void Release()
+	{
+		if (IsHeapType() && --heapObject->refCount == 0)
+		{
+			Free();
+		}
+	}
+
+	void Free();
+	void Detach();
+public:
+	Value() : type(TokenType::None), intValue(0) { }
+	explicit Value(int value) : type(TokenType::Int), intValue(value) { }
+	explicit Value(float value) : type(TokenType::Float), floatValue(value) { }
+	explicit Value(int64_t value) : type(TokenType::Long), longValue(value) { }
+	explicit Value(double value) : type(TokenType::Double), doubleValue(value) { }
+	explicit Value(bool value) : type(TokenType::Bool), boolValue(value) { }
+	explicit Value(std::string value);
+	explicit Value(const char* value);
+	explicit Value(std::vector<int32_t> values);
+	explicit Value(std::vector<float> values);
+	explicit Value(std::vector<bool> values);
+	Value(TokenType arrayType, std::vector<Value> values);
+
+	// The payload is copied by its widest member, which also holds the pointer of heap types
+	Value(const Value& other) : type(other.type), longValue(other.longValue)
+	{
+		Retain();
+	}
+
+	Value(Value&& other) noexcept : type(other.type), longValue(other.longValue)
+	{
+		other.type = TokenType::None;
+	}
+
+	~Value()
+	{
+		Release();
+	}
+
+	Value& operator=(const Value& other)
+	{
+		other.Retain();
+		Release();
+
+		this->type = other.type;
+		this->longValue = other.longValue;
+
+		return *this;
+	}
+
+	Value& operator=(Value&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Release();
+
+			this->type = other.type;
+			this->longValue = other.longValue;
+
+			other.type = TokenType::None;
+		}
+
+		return *this;
+	}
+
+	TokenType GetType() const
+	{
+		return type;
+	}
+
+	int GetInt() const
+	{
+		return intValue;
+	}
+
+	float GetFloat() const
+	{
+		return floatValue;
+	}
+
+	int64_t GetLong() const
+	{
+		return longValue;
+	}
+
+	double GetDouble() const
+	{
+		return doubleValue;
+	}
+
+	bool GetBool() const
+	{
+		return boolValue;
+	}
+
+	const std::string& GetString() const
+	{
+		return stringObject->value;
+	}
+
+	const std::vector<int32_t>& GetIntArray() const
+	{
+		return intArrayObject->values;
+	}
+
+	const std::vector<float>& GetFloatArray() const
+	{
+		return floatArrayObject->values;
+	}
+
+	const std::vector<bool>& GetBoolArray() const
+	{
+		return boolArrayObject->values;
+	}
+
+	const std::vector<Value>& GetStringArray() const
+	{
+		return stringArrayObject->values;
+	}
+
+	// Compares with the comparison operator, values of different types (except numbers) are never equal
+	bool Compare(TokenType operant, const Value& other) const;
+	// Calculates with the arithmetic operator, only numbers of the same type have a result
+	Value Arithmetic(TokenType operant, const Value& other) const;
+
+	size_t GetArraySize() const;
+	Value GetArrayElement(size_t index) const;
+
+	// Writes an array element in place, the index needs to be checked by the caller.
+	// If the storage is shared with other values, it gets copied once before.
+	void SetArrayElement(size_t index, const Value& value);
+};
+
+#endif
@@ -18,6 +18,8 @@
 #include <Ast/VariableUsageNode.h>
 #include <Ast/VariableAssignNode.h>
 #include <Ast/Literal/FloatNode.h>
+#include <Ast/Literal/LongNode.h>
+#include <Ast/Literal/DoubleNode.h>
 #include <Ast/Literal/BoolNode.h>
 #include <Ast/BinaryNode.h>
 #include <Ast/VariableArrayDeclarationAssignNode.h>
@@ -32,6 +34,7 @@
 #include <Ast/VariableIncrementDecrementNode.h>
 #include <Ast/VariableCompoundAssignNode.h>
 #include <Ast/DoWhileNode.h>
+#include <type_traits>
 
 class Visitor
 {
@@ -44,32 +47,73 @@ public:
 
     }
 
-	virtual void Visit(const Ref<MainNode>& n) = 0;
-	virtual void Visit(const Ref<VariableDeclarationAssignNode>& n) = 0;
-	virtual void Visit(const Ref<VariableArrayDeclarationAssignNode>& n) = 0;
-	virtual void Visit(const Ref<FunctionNode>& n) = 0;
-	virtual void Visit(const Ref<FunctionCallNode>& n) = 0;
-	virtual void Visit(const Ref<ForEachNode>& n) = 0;
-	virtual void Visit(const Ref<ForINode>& n) = 0;
-	virtual void Visit(const Ref<BlockNode>& n) = 0;
-	virtual void Visit(const Ref<BinaryNode>& n) = 0;
-	virtual void Visit(const Ref<BooleanNode>& n) = 0;
-	virtual void Visit(const Ref<IfNode>& n) = 0;
-	virtual void Visit(const Ref<WhileNode>& n) = 0;
-	virtual void Visit(const Ref<DoWhileNode>& n) = 0;
-	virtual void Visit(const Ref<ReturnNode>& n) = 0;
+	virtual void Visit(MainNode& n) = 0;
+	virtual void Visit(VariableDeclarationAssignNode& n) = 0;
+	virtual void Visit(VariableArrayDeclarationAssignNode& n) = 0;
+	virtual void Visit(FunctionNode& n) = 0;
+	virtual void Visit(FunctionCallNode& n) = 0;
+	virtual void Visit(ForEachNode& n) = 0;
+	virtual void Visit(ForINode& n) = 0;
+	virtual void Visit(BlockNode& n) = 0;
+	virtual void Visit(BinaryNode& n) = 0;
+	virtual void Visit(BooleanNode& n) = 0;
+	virtual void Visit(IfNode& n) = 0;
+	virtual void Visit(WhileNode& n) = 0;
+	virtual void Visit(DoWhileNode& n) = 0;
+	virtual void Visit(ReturnNode& n) = 0;
 
-	virtual void Visit(const Ref<StringNode>& n) = 0;
-	virtual void Visit(const Ref<IntNode>& n) = 0;
-	virtual void Visit(const Ref<FloatNode>& n) = 0;
-	virtual void Visit(const Ref<BoolNode>& n) = 0;
+	virtual void Visit(StringNode& n) = 0;
+	virtual void Visit(IntNode& n) = 0;
+	virtual void Visit(FloatNode& n) = 0;
+	virtual void Visit(LongNode& n) = 0;
+	virtual void Visit(DoubleNode& n) = 0;
+	virtual void Visit(BoolNode& n) = 0;
 
-	virtual void Visit(const Ref<VariableUsageNode>& n) = 0;
-	virtual void Visit(const Ref<VariableAssignNode>& n) = 0;
-	virtual void Visit(const Ref<VariableArrayUsageNode>& n) = 0;
-	virtual void Visit(const Ref<VariableArrayAssignNode>& n) = 0;
-	virtual void Visit(const Ref<VariableIncrementDecrementNode>& n) = 0;
-	virtual void Visit(const Ref<VariableCompoundAssignNode>& n) = 0;
+	virtual void Visit(VariableUsageNode& n) = 0;
+	virtual void Visit(VariableAssignNode& n) = 0;
+	virtual void Visit(VariableArrayUsageNode& n) = 0;
+	virtual void Visit(VariableArrayAssignNode& n) = 0;
+	virtual void Visit(VariableIncrementDecrementNode& n) = 0;
+	virtual void Visit(VariableCompoundAssignNode& n) = 0;
 };
 
+// Visitors walk the ast millions of times, a child handed out as Ref<Node> (or any other copy)
+// would cost an atomic reference count or an allocation per visited node
+static_assert(std::is_same_v<decltype(&Node::Accept), void (Node::*)(Visitor&)>, "Node::Accept must take the visitor by reference");
+
+#define IONA_CHILD_ACCESSOR(node, accessor) \
+	static_assert(std::is_pointer_v<decltype(std::declval<const node&>().accessor())> \
+		|| std::is_lvalue_reference_v<decltype(std::declval<const node&>().accessor())>, \
+		#node "::" #accessor " must return a raw pointer or a reference")
+IONA_CHILD_ACCESSOR(MainNode, GetGlobalVariables);
+IONA_CHILD_ACCESSOR(MainNode, GetGlobalFunctions);
+IONA_CHILD_ACCESSOR(VariableDeclarationAssignNode, GetExpression);
+IONA_CHILD_ACCESSOR(VariableArrayDeclarationAssignNode, GetValues);
+IONA_CHILD_ACCESSOR(FunctionNode, GetBlock);
+IONA_CHILD_ACCESSOR(FunctionCallNode, GetParameters);
+IONA_CHILD_ACCESSOR(FunctionCallNode, GetFunction);
+IONA_CHILD_ACCESSOR(ForEachNode, GetExpression);
+IONA_CHILD_ACCESSOR(ForEachNode, GetBlock);
+IONA_CHILD_ACCESSOR(ForINode, GetBlock);
+IONA_CHILD_ACCESSOR(BlockNode, GetStatements);
+IONA_CHILD_ACCESSOR(BinaryNode, GetLeft);
+IONA_CHILD_ACCESSOR(BinaryNode, GetRight);
+IONA_CHILD_ACCESSOR(BooleanNode, GetLeft);
+IONA_CHILD_ACCESSOR(BooleanNode, GetRight);
+IONA_CHILD_ACCESSOR(IfNode, GetExpression);
+IONA_CHILD_ACCESSOR(IfNode, GetTrueBlock);
+IONA_CHILD_ACCESSOR(IfNode, GetElseIfBlocks);
+IONA_CHILD_ACCESSOR(IfNode, GetElseBlock);
+IONA_CHILD_ACCESSOR(WhileNode, GetExpression);
+IONA_CHILD_ACCESSOR(WhileNode, GetBlock);
+IONA_CHILD_ACCESSOR(DoWhileNode, GetExpression);
+IONA_CHILD_ACCESSOR(DoWhileNode, GetBlock);
+IONA_CHILD_ACCESSOR(ReturnNode, GetExpression);
+IONA_CHILD_ACCESSOR(ReturnNode, GetTailCall);
+IONA_CHILD_ACCESSOR(StringNode, GetExpressions);
+IONA_CHILD_ACCESSOR(VariableAssignNode, GetExpression);
+IONA_CHILD_ACCESSOR(VariableArrayAssignNode, GetExpression);
+IONA_CHILD_ACCESSOR(VariableCompoundAssignNode, GetExpression);
+#undef IONA_CHILD_ACCESSOR
+
 #endif
\ No newline at end of file
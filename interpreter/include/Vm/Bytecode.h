@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Value.h"
+
+// Instructions of the register based virtual machine. Registers are relative
+// to the frame of the current function, bx is the 32 bit operand made of b and c.
+enum class OpCode : uint8_t
+{
+	LoadConstant,		// a = constants[bx]
+	Move,				// a = b, moves out of b if extra is set
+	Declare,			// a = b, b needs to be a valid variable type, moves out of b if extra is set
+	Assign,				// a = b, b needs to be of the type of a, moves out of b if extra is set
+
+	GetGlobal,			// a = globals[bx]
+	SetGlobal,			// globals[bx] = a
+	DeclareGlobal,		// globals[bx] = a, a needs to be a valid variable type
+	AssignGlobal,		// globals[bx] = a, a needs to be of the type of globals[bx]
+
+	Add,				// a = b + c
+	Subtract,			// a = b - c
+	Multiply,			// a = b * c
+	Divide,				// a = b / c
+	Compare,			// a = b (comparison operator token type in extra) c
+
+	Increment,			// a += (int16_t) b
+	CompoundAssign,		// a = a (arithmetic operator token type in extra) b
+
+	Jump,				// pc = bx
+	JumpIfFalse,		// if !a then pc = bx, the kind of the expression for errors is in extra
+
+	NewArray,			// a = array of type extra with the c values starting at b
+	CheckElementType,	// a needs to be of the element type of the array type in extra
+	GetElement,			// a = b[c]
+	GetGlobalElement,	// a = globals[b][c]
+	SetElement,			// a[b] = c
+	SetGlobalElement,	// globals[a][b] = c
+
+	ForEachPrepare,		// a needs to be an array, a + 1 = 0, if a is empty then pc = bx
+	ForEachLoop,		// a + 2 = a[a + 1], a + 1 += 1, if a + 1 < size of a then pc = bx
+	ForIPrepare,		// if a < a + 1 then a + 3 = a else pc = bx
+	ForILoop,			// a += a + 2, if a < a + 1 then a + 3 = a and pc = bx
+
+	Interpolate,		// a = constants[b] with every "$R$" replaced by the extra values starting at c
+
+	Call,				// a = functions[b](a, ..., a + c - 1)
+	TailCall,			// return functions[b](a, ..., a + c - 1), executed in the frame of the returning function
+	CallInternal,		// a = internalFunctions[b](a, ..., a + c - 1), parameter types are already checked if extra is set
+	Return,				// return a
+	ReturnNone			// return nothing
+};
+
+struct Instruction
+{
+	OpCode opCode;
+	uint8_t extra;
+	uint16_t a;
+	uint16_t b;
+	uint16_t c;
+
+	uint32_t GetBx() const
+	{
+		return ((uint32_t) b << 16) | c;
+	}
+
+	void SetBx(uint32_t bx)
+	{
+		b = (uint16_t) (bx >> 16);
+		c = (uint16_t) bx;
+	}
+};
+
+// Kept apart from the instructions, only needed to report errors
+struct InstructionInfo
+{
+	int line;
+	// Index into the names of the program, zero if no name is needed
+	uint32_t name;
+};
+
+struct BytecodeFunction
+{
+	std::string name;
+	uint16_t parameterCount = 0;
+	uint16_t registerCount = 0;
+	std::vector<Instruction> code;
+	std::vector<InstructionInfo> infos;
+};
+
+struct BytecodeProgram
+{
+	std::string fileName;
+	// Function zero declares the global variables and calls the main function
+	std::vector<BytecodeFunction> functions;
+	std::vector<Value> constants;
+	std::vector<std::string> names;
+	// Global zero is the ARGS array, which is set by the virtual machine
+	std::vector<std::string> globals;
+	// Internal functions are referenced by name and resolved when the program is loaded
+	std::vector<std::string> internalFunctions;
+};
+
+#endif
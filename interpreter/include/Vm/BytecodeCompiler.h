@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef BYTECODE_COMPILER_H
+#define BYTECODE_COMPILER_H
+
+#include <map>
+#include "Visitor.h"
+#include "Core.h"
+#include "Vm/Bytecode.h"
+
+// Compiles the semantically analyzed ast into bytecode for the virtual machine.
+// Every local variable gets its own register, expressions are evaluated into
+// temporary registers above the locals, which are freed after every statement.
+class BytecodeCompiler : public Visitor
+{
+private:
+	static constexpr uint16_t NoRegister = UINT16_MAX;
+
+	Ref<BytecodeProgram> program;
+	size_t currentFunction = 0;
+
+	std::map<std::string, uint32_t> functionIndices;
+	std::map<std::string, uint32_t> internalFunctionIndices;
+	std::map<std::string, uint32_t> globalIndices;
+	std::map<std::string, uint32_t> nameIndices;
+
+	// Local variables of the current function by scope, the global scope has none
+	std::vector<std::map<std::string, uint16_t>> scopes;
+	std::vector<uint16_t> scopeLocalTops;
+	uint16_t localTop = 0;
+	uint16_t nextRegister = 0;
+
+	// Register the current expression should be evaluated into, if possible
+	uint16_t destination = NoRegister;
+	// Register which holds the result of the last compiled expression
+	uint16_t currentRegister = NoRegister;
+
+	BytecodeFunction& GetFunction()
+	{
+		return program->functions[currentFunction];
+	}
+
+	size_t Emit(const Node& node, OpCode opCode, uint16_t a = 0, uint16_t b = 0, uint16_t c = 0, uint8_t extra = 0, uint32_t name = 0);
+	size_t EmitBx(const Node& node, OpCode opCode, uint16_t a, uint32_t bx, uint8_t extra = 0, uint32_t name = 0);
+	void PatchJump(size_t index, size_t target);
+
+	uint32_t AddConstant(Value value);
+	uint32_t AddName(const std::string& name);
+	uint32_t AddGlobal(const Node& node, const std::string& name);
+	uint32_t AddInternalFunction(const std::string& name);
+
+	void PushScope();
+	void PopScope();
+	uint16_t DeclareLocal(const std::string& name, uint16_t reg);
+	bool FindLocal(const std::string& name, uint16_t& reg) const;
+
+	uint16_t AllocateRegisters(const Node& node, size_t count);
+	uint16_t Target(const Node& node, uint16_t target);
+	bool IsTemporary(uint16_t reg) const;
+
+	uint16_t CompileExpression(Node* node, uint16_t target = NoRegister);
+	void CompileExpressionInto(Node* node, uint16_t target);
+	void CompileStatement(Node* node);
+	void CompileScopedBlock(Node* block);
+public:
+	explicit BytecodeCompiler(const Ref<Node>& astRoot);
+	~BytecodeCompiler() = default;
+
+	Ref<BytecodeProgram> Compile();
+
+	void Visit(MainNode& n) override;
+	void Visit(VariableDeclarationAssignNode& n) override;
+	void Visit(VariableArrayDeclarationAssignNode& n) override;
+	void Visit(FunctionNode& n) override;
+	void Visit(FunctionCallNode& n) override;
+	void Visit(ForEachNode& n) override;
+	void Visit(ForINode& n) override;
+	void Visit(BlockNode& n) override;
+	void Visit(BinaryNode& n) override;
+	void Visit(BooleanNode& n) override;
+	void Visit(IfNode& n) override;
+	void Visit(WhileNode& n) override;
+	void Visit(DoWhileNode& n) override;
+	void Visit(StringNode& n) override;
+	void Visit(IntNode& n) override;
+	void Visit(FloatNode& n) override;
+	void Visit(LongNode& n) override;
+	void Visit(DoubleNode& n) override;
+	void Visit(VariableUsageNode& n) override;
+	void Visit(VariableAssignNode& n) override;
+	void Visit(VariableArrayUsageNode& n) override;
+	void Visit(VariableArrayAssignNode& n) override;
+	void Visit(VariableIncrementDecrementNode& n) override;
+	void Visit(VariableCompoundAssignNode& n) override;
+	void Visit(BoolNode& n) override;
+	void Visit(ReturnNode& n) override;
+};
+
+#endif
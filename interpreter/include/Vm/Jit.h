@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef JIT_H
+#define JIT_H
+
+#include <map>
+#include <utility>
+#include "Core.h"
+#include "Vm/Bytecode.h"
+
+// Array of a compiled loop, filled before the machine code is entered
+struct JitArray
+{
+	void* data;
+	uint64_t size;
+};
+
+// Returns the index of the instruction the virtual machine continues with, with
+// the deoptimization flag set if the loop left at an instruction it could not execute
+using JitLoopFunction = uint32_t (*)(Value* registers, JitArray* arrays);
+
+struct JitLoop
+{
+	JitLoopFunction function = nullptr;
+	uint32_t backEdges = 0;
+	uint32_t guardFailures = 0;
+	uint32_t compilations = 0;
+	uint32_t entries = 0;
+	uint32_t deoptimizations = 0;
+	// Set if the loop can not be compiled, it is not tried again
+	bool failed = false;
+
+	// Registers which need to have the type when the loop is entered
+	std::vector<std::pair<uint16_t, TokenType>> guards;
+	// Registers the loop writes before reading, they must not hold a string or an array
+	std::vector<uint16_t> scalars;
+	// Registers of the arrays table, the flag is set if the loop writes elements of the array
+	std::vector<std::pair<uint16_t, bool>> arrays;
+};
+
+// Baseline compiler of the virtual machine. Loops made of int and float arithmetic, comparisons,
+// registers and array elements are compiled to x86-64 machine code once they are hot, which is
+// counted with the back edges of the loop and the invocations of its function. The types are
+// taken from the registers when the loop is compiled and checked each time it is entered. Every
+// other case (division by zero, array bounds, calls, strings) leaves to the virtual machine at the
+// instruction, which executes it and the rest of the iteration.
+class Jit
+{
+private:
+	struct FunctionCounters
+	{
+		uint32_t invocations = 0;
+		// Indexed by the first instruction of the loop
+		std::map<uint32_t, JitLoop> loops;
+	};
+
+	Ref<BytecodeProgram> program;
+	std::vector<FunctionCounters> functions;
+	// Executable memory of the compiled loops
+	std::vector<std::pair<void*, size_t>> memory;
+	std::vector<JitArray> arrays;
+
+	size_t compiledLoops = 0;
+	size_t entries = 0;
+	size_t deoptimizations = 0;
+
+	// Offsets of the type and the value of a register in the registers of a frame
+	static int32_t TypeOffset(uint16_t reg);
+	static int32_t PayloadOffset(uint16_t reg);
+
+	bool Compile(const BytecodeFunction& function, JitLoop& loop, uint32_t header, uint32_t backEdge, const Value* registers);
+	JitLoopFunction Install(const std::vector<uint8_t>& code);
+	bool Enter(JitLoop& loop, Value* registers);
+public:
+	static constexpr uint32_t LoopThreshold = 1000;
+	static constexpr uint32_t FunctionThreshold = 100;
+	static constexpr uint32_t MaxGuardFailures = 16;
+	static constexpr uint32_t MaxCompilations = 3;
+	static constexpr uint32_t MinEntries = 64;
+	static constexpr uint32_t Deoptimized = 0x80000000;
+
+	explicit Jit(const Ref<BytecodeProgram>& program);
+	~Jit();
+
+	// Only x86-64 Linux has a code generator, everywhere else nothing gets compiled
+	static bool IsSupported();
+
+	void Invoke(uint32_t function)
+	{
+		this->functions[function].invocations++;
+	}
+
+	// Called when the back edge at the instruction jumped to the header of its loop. Returns the
+	// index of the instruction to continue with, which is the header if the loop was not run.
+	uint32_t BackEdge(uint32_t function, uint32_t header, uint32_t backEdge, Value* registers);
+
+	size_t GetCompiledLoops() const
+	{
+		return this->compiledLoops;
+	}
+
+	size_t GetEntries() const
+	{
+		return this->entries;
+	}
+
+	size_t GetDeoptimizations() const
+	{
+		return this->deoptimizations;
+	}
+};
+
+#endif
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef PROGRAM_CONTAINER_H
+#define PROGRAM_CONTAINER_H
+
+#include <ostream>
+#include "Core.h"
+#include "Vm/Bytecode.h"
+
+// Single file which holds a compiled program, so it can be run without lexing, parsing and analyzing it again.
+// All strings are stored once in a string table, everything else refers to them by index. Instructions are
+// stored as they are in memory, so a container only runs with the iona version (and byte order) it was written by.
+//
+// Layout, every section starts at a multiple of four bytes:
+//   header, string offsets (string count + 1), string data,
+//   constants, names, globals, internal functions (string indices),
+//   function headers, then the instructions and instruction infos of every function
+class ProgramContainer
+{
+public:
+	static constexpr const char* Extension = ".ionc";
+
+	static void Write(const BytecodeProgram& program, std::ostream& stream);
+	// Maps the file into memory and copies the program out of it, fails with an iona error if it is not a valid container
+	static Ref<BytecodeProgram> Load(const std::string& fileName);
+};
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef VIRTUAL_MACHINE_H
+#define VIRTUAL_MACHINE_H
+
+#include "Core.h"
+#include "FunctionRegistry.h"
+#include "Vm/Bytecode.h"
+#include "Vm/Jit.h"
+
+struct CallFrame
+{
+	const BytecodeFunction* function;
+	// Instruction to continue with when the called function returns
+	const Instruction* pc;
+	// First register of the function in the register stack
+	size_t base;
+};
+
+// Executes compiled bytecode. Calls between iona functions do not recurse
+// natively, the registers of all frames live in one contiguous stack.
+class VirtualMachine
+{
+private:
+	Ref<BytecodeProgram> program;
+	std::vector<const FunctionEntry*> resolvedInternalFunctions;
+
+	std::vector<Value> globals;
+	std::vector<Value> stack;
+	std::vector<CallFrame> frames;
+	// Deep recursion only costs heap memory, the limit turns endless recursion into an error
+	size_t maxCallDepth = DefaultMaxCallDepth;
+	// Reused for the arguments of internal function calls
+	std::vector<Value> arguments;
+	// Compiles hot loops, nullptr if disabled
+	Ref<Jit> jit;
+
+	void Execute();
+	Value Arithmetic(const Instruction& instruction, TokenType operant, const Value& left, const Value& right);
+	void CompoundAssign(const Instruction& instruction, Value& variable, const Value& value);
+
+	const std::string& GetName(const Instruction& instruction) const;
+
+	uint32_t GetFunctionIndex(const BytecodeFunction* function) const
+	{
+		return (uint32_t) (function - this->program->functions.data());
+	}
+
+	template <typename ...Args>
+	void Fail(const Instruction& instruction, const std::string& error, Args ...args) const
+	{
+		const BytecodeFunction& function = *this->frames.back().function;
+		Exit(this->program->fileName, function.infos[&instruction - function.code.data()].line, error, args...);
+	}
+public:
+	static constexpr size_t DefaultMaxCallDepth = 1000000;
+
+	VirtualMachine(const std::vector<std::string>& args, const Ref<BytecodeProgram>& program);
+	~VirtualMachine() = default;
+
+	void SetMaxCallDepth(size_t maxCallDepth)
+	{
+		this->maxCallDepth = maxCallDepth;
+	}
+
+	// The jit is only enabled on platforms it supports
+	void SetJit(bool enabled);
+
+	const Jit* GetJit() const
+	{
+		return this->jit.get();
+	}
+
+	void Run();
+};
+
+#endif
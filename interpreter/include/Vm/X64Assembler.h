@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#ifndef X64_ASSEMBLER_H
+#define X64_ASSEMBLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Only the registers without a REX prefix are used, the jit gets along with them
+enum class X64Register : uint8_t
+{
+	Rax = 0,
+	Rcx = 1,
+	Rdx = 2,
+	Rsi = 6,
+	Rdi = 7
+};
+
+// Condition codes as encoded in jcc and setcc
+enum class X64Condition : uint8_t
+{
+	Below = 0x2,
+	AboveEqual = 0x3,
+	Equal = 0x4,
+	NotEqual = 0x5,
+	Above = 0x7,
+	Parity = 0xA,
+	NoParity = 0xB,
+	Less = 0xC,
+	GreaterEqual = 0xD,
+	LessEqual = 0xE,
+	Greater = 0xF
+};
+
+// Opcodes of "op r32, r/m32" and "op xmm, xmm/m32" (with the f3 prefix)
+enum class X64Arithmetic : uint8_t
+{
+	Add = 0x03,
+	Subtract = 0x2B,
+	Compare = 0x3B,
+	AddFloat = 0x58,
+	MultiplyFloat = 0x59,
+	SubtractFloat = 0x5C,
+	DivideFloat = 0x5E
+};
+
+// Emits the few x86-64 instructions the jit needs. Memory operands are always
+// [base + disp32] or [base + index * 4], the base can not be rsp or rbp.
+class X64Assembler
+{
+private:
+	std::vector<uint8_t> code;
+
+	void Byte(uint8_t value);
+	void Int32(int32_t value);
+	void Memory(uint8_t reg, X64Register base, int32_t displacement);
+public:
+	const std::vector<uint8_t>& GetCode() const
+	{
+		return this->code;
+	}
+
+	size_t GetSize() const
+	{
+		return this->code.size();
+	}
+
+	// mov r32, [base + displacement] and mov r64, [base + displacement]
+	void Load32(X64Register destination, X64Register base, int32_t displacement);
+	void Load64(X64Register destination, X64Register base, int32_t displacement);
+	// mov [base + displacement], r32 and mov [base + displacement], r8 (al, cl or dl)
+	void Store32(X64Register base, int32_t displacement, X64Register source);
+	void Store8(X64Register base, int32_t displacement, X64Register source);
+	void StoreImmediate32(X64Register base, int32_t displacement, int32_t value);
+	void StoreImmediate8(X64Register base, int32_t displacement, uint8_t value);
+	// mov r32, [base + index * 4] and mov [base + index * 4], r32
+	void LoadIndexed32(X64Register destination, X64Register base, X64Register index);
+	void StoreIndexed32(X64Register base, X64Register index, X64Register source);
+	void MoveImmediate32(X64Register destination, int32_t value);
+
+	// op r32, [base + displacement] for add, sub and cmp
+	void Arithmetic32(X64Arithmetic operation, X64Register destination, X64Register base, int32_t displacement);
+	void Multiply32(X64Register destination, X64Register base, int32_t displacement);
+	void AddImmediate32(X64Register destination, int32_t value);
+	void CompareImmediate8(X64Register left, int8_t value);
+	void CompareMemoryImmediate8(X64Register base, int32_t displacement, uint8_t value);
+	// cdq and idiv r32, the dividend is edx:eax
+	void SignExtend();
+	void Divide32(X64Register divisor);
+	void SetCondition(X64Condition condition, X64Register destination);
+	void And8(X64Register destination, X64Register source);
+	void Or8(X64Register destination, X64Register source);
+
+	// movss xmm, [base + displacement], movss [base + displacement], xmm and op xmm, [base + displacement]
+	void LoadFloat(uint8_t destination, X64Register base, int32_t displacement);
+	void StoreFloat(X64Register base, int32_t displacement, uint8_t source);
+	void FloatArithmetic(X64Arithmetic operation, uint8_t destination, X64Register base, int32_t displacement);
+	void FloatArithmetic(X64Arithmetic operation, uint8_t destination, uint8_t source);
+	void CompareFloat(uint8_t left, X64Register base, int32_t displacement);
+	// movd xmm, r32
+	void MoveToFloat(uint8_t destination, X64Register source);
+
+	// The jumps return the position of their rel32 operand, which is patched once the target is known
+	size_t Jump();
+	size_t JumpIf(X64Condition condition);
+	void Patch(size_t position, size_t target);
+	void Return();
+};
+
+#endif
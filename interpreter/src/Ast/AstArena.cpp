@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "Ast/AstArena.h"
+
+AstArena::~AstArena()
+{
+	for (auto it = this->nodes.rbegin(); it != this->nodes.rend(); ++it)
+	{
+		(*it)->~Node();
+	}
+}
+
+void* AstArena::Allocate(size_t size, size_t alignment)
+{
+	size_t padding = (alignment - reinterpret_cast<uintptr_t>(this->current) % alignment) % alignment;
+
+	if (this->current == nullptr || padding + size > this->remaining)
+	{
+		// Huge lists get a block of their own
+		size_t blockSize = size > BlockSize ? size : BlockSize;
+
+		this->blocks.emplace_back(new char[blockSize]);
+		this->current = this->blocks.back().get();
+		this->remaining = blockSize;
+		padding = 0;
+	}
+
+	void* memory = this->current + padding;
+	this->current += padding + size;
+	this->remaining -= padding + size;
+
+	return memory;
+}
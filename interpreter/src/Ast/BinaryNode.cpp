@@ -8,12 +8,12 @@
 #include "BinaryNode.h"
 #include "Visitor.h"
 
-BinaryNode::BinaryNode(const Ref<Node>& left, const TokenType& operant, const Ref<Node>& right) 
+BinaryNode::BinaryNode(Node* left, const TokenType& operant, Node* right) 
 	: left(left), operant(operant), right(right)
 {
 }
 
-void BinaryNode::Accept(const Ref<Visitor>& v)
+void BinaryNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
\ No newline at end of file
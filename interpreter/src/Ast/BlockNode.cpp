@@ -8,13 +8,13 @@
 #include "BlockNode.h"
 #include "Visitor.h"
 
-BlockNode::BlockNode(std::vector<Ref<Node>> statements)
+BlockNode::BlockNode(NodeList<Node*> statements)
 	: statements(std::move(statements))
 {
 
 }
 
-void BlockNode::Accept(const Ref<Visitor>& v)
+void BlockNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
@@ -8,12 +8,12 @@
 #include "BooleanNode.h"
 #include "Visitor.h"
 
-BooleanNode::BooleanNode(const Ref<Node>& left, const TokenType& operant, const Ref<Node>& right) 
+BooleanNode::BooleanNode(Node* left, const TokenType& operant, Node* right) 
 	: left(left), operant(operant), right(right)
 {
 }
 
-void BooleanNode::Accept(const Ref<Visitor>& v)
+void BooleanNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
@@ -8,12 +8,12 @@
 #include "DoWhileNode.h"
 #include "Visitor.h"
 
-DoWhileNode::DoWhileNode(const std::string& fileName, int line, const Ref<Node>& expression, const Ref<Node>& block)
-	: Node(fileName, line), expression(expression), block(block)
+DoWhileNode::DoWhileNode(uint32_t fileId, int line, Node* expression, Node* block)
+	: Node(fileId, line), expression(expression), block(block)
 {
 }
 
-void DoWhileNode::Accept(const Ref<Visitor>& v)
+void DoWhileNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
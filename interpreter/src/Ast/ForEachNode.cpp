@@ -8,12 +8,12 @@
 #include "ForEachNode.h"
 #include "Visitor.h"
 
-ForEachNode::ForEachNode(const std::string& fileName, int line, std::string variableName, const Ref<Node>& expression, const Ref<Node>& block)
-	: Node(fileName, line), variableName(std::move(variableName)), expression(expression), block(block)
+ForEachNode::ForEachNode(uint32_t fileId, int line, std::string variableName, Node* expression, Node* block)
+	: Node(fileId, line), variableName(std::move(variableName)), expression(expression), block(block)
 {
 }
 
-void ForEachNode::Accept(const Ref<Visitor>& v)
+void ForEachNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
\ No newline at end of file
@@ -8,12 +8,12 @@
 #include "ForINode.h"
 #include "Visitor.h"
 
-ForINode::ForINode(const std::string& fileName, int line, std::string variableName, int from, int to, int step, const Ref<Node>& block)
-	: Node(fileName, line), variableName(std::move(variableName)), from(from), to(to), step(step), block(block)
+ForINode::ForINode(uint32_t fileId, int line, std::string variableName, int from, int to, int step, Node* block)
+	: Node(fileId, line), variableName(std::move(variableName)), from(from), to(to), step(step), block(block)
 {
 }
 
-void ForINode::Accept(const Ref<Visitor>& v)
+void ForINode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
\ No newline at end of file
@@ -8,13 +8,13 @@
 #include "Ast/FunctionCallNode.h"
 #include "Visitor.h"
 
-FunctionCallNode::FunctionCallNode(const std::string& fileName, int line, std::string name, std::vector<Ref<Node>> parameters)
-	: Node(fileName, line), name(std::move(name)), parameters(std::move(parameters))
+FunctionCallNode::FunctionCallNode(uint32_t fileId, int line, std::string name, NodeList<Node*> parameters)
+	: Node(fileId, line), name(std::move(name)), parameters(std::move(parameters))
 {
 
 }
 
-void FunctionCallNode::Accept(const Ref<Visitor>& v)
+void FunctionCallNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
@@ -8,12 +8,17 @@
 #include "Ast/FunctionNode.h"
 #include "Visitor.h"
 
-FunctionNode::FunctionNode(const std::string& fileName, int line, std::string name, Ref<Node> block, std::vector<std::string> parameters)
-	: Node(fileName, line), name(std::move(name)), block(std::move(block)), parameters(std::move(parameters))
+FunctionNode::FunctionNode(uint32_t fileId, int line, std::string name, Node* block, std::vector<std::string> parameters)
+	: Node(fileId, line), name(std::move(name)), block(std::move(block)), parameters(std::move(parameters))
 {
 }
 
-void FunctionNode::Accept(const Ref<Visitor>& v)
+FunctionNode::FunctionNode(uint32_t fileId, int line, std::string name, std::string_view body, int bodyLine, std::vector<std::string> parameters)
+	: Node(fileId, line), name(std::move(name)), block(nullptr), parameters(std::move(parameters)), body(body), bodyLine(bodyLine)
 {
-	v->Visit(shared_from_this());
+}
+
+void FunctionNode::Accept(Visitor& v)
+{
+	v.Visit(*this);
 }
\ No newline at end of file
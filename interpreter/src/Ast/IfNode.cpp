@@ -8,12 +8,12 @@
 #include "IfNode.h"
 #include "Visitor.h"
 
-IfNode::IfNode(const std::string& fileName, int line, const Ref<Node>& expression, const Ref<Node>& trueBlock, std::map<Ref<Node>, Ref<Node>> elseIfBlocks, const Ref<Node>& elseBlock)
-	: Node(fileName, line), expression(expression), trueBlock(trueBlock), elseIfBlocks(std::move(elseIfBlocks)), elseBlock(elseBlock)
+IfNode::IfNode(uint32_t fileId, int line, Node* expression, Node* trueBlock, NodeList<std::pair<Node*, Node*>> elseIfBlocks, Node* elseBlock)
+	: Node(fileId, line), expression(expression), trueBlock(trueBlock), elseIfBlocks(std::move(elseIfBlocks)), elseBlock(elseBlock)
 {
 }
 
-void IfNode::Accept(const Ref<Visitor>& v)
+void IfNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
@@ -13,7 +13,12 @@ BoolNode::BoolNode(const std::string& value)
 {
 }
 
-void BoolNode::Accept(const Ref<Visitor>& v)
+BoolNode::BoolNode(bool value)
+	: value(value)
 {
-	v->Visit(shared_from_this());
+}
+
+void BoolNode::Accept(Visitor& v)
+{
+	v.Visit(*this);
 }
\ No newline at end of file
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "Ast/Literal/DoubleNode.h"
+#include "Visitor.h"
+
+DoubleNode::DoubleNode(double value)
+	: value(value)
+{
+}
+
+void DoubleNode::Accept(Visitor& v)
+{
+	v.Visit(*this);
+}
\ No newline at end of file
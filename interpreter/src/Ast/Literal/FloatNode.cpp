@@ -8,12 +8,12 @@
 #include "Ast/Literal/FloatNode.h"
 #include "Visitor.h"
 
-FloatNode::FloatNode(const std::string& value)
-	: value(std::stof(value))
+FloatNode::FloatNode(float value)
+	: value(value)
 {
 }
 
-void FloatNode::Accept(const Ref<Visitor>& v)
+void FloatNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
\ No newline at end of file
@@ -8,12 +8,12 @@
 #include "Ast/Literal/IntNode.h"
 #include "Visitor.h"
 
-IntNode::IntNode(const std::string& value) 
-	: value(std::stoi(value))
+IntNode::IntNode(int value)
+	: value(value)
 {
 }
 
-void IntNode::Accept(const Ref<Visitor>& v)
+void IntNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
\ No newline at end of file
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "Ast/Literal/LongNode.h"
+#include "Visitor.h"
+
+LongNode::LongNode(int64_t value)
+	: value(value)
+{
+}
+
+void LongNode::Accept(Visitor& v)
+{
+	v.Visit(*this);
+}
\ No newline at end of file
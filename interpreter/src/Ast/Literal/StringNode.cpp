@@ -8,12 +8,12 @@
 #include "Ast/Literal/StringNode.h"
 #include "Visitor.h"
 
-StringNode::StringNode(const std::string& fileName, int line, std::string  value, std::vector<Ref<Node>> expressions)
-	: Node(fileName, line), value(std::move(value)), expressions(std::move(expressions))
+StringNode::StringNode(uint32_t fileId, int line, std::string  value, NodeList<Node*> expressions)
+	: Node(fileId, line), value(std::move(value)), expressions(std::move(expressions))
 {
 }
 
-void StringNode::Accept(const Ref<Visitor>& v)
+void StringNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
\ No newline at end of file
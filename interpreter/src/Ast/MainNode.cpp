@@ -8,13 +8,13 @@
 #include "Ast/MainNode.h"
 #include "Visitor.h"
 
-MainNode::MainNode(std::vector<Ref<Node>> globalVariables, std::vector<Ref<Node>> globalFunctions)
+MainNode::MainNode(NodeList<Node*> globalVariables, NodeList<Node*> globalFunctions)
 	: globalVariables(std::move(globalVariables)), globalFunctions(std::move(globalFunctions))
 {
 
 }
 
-void MainNode::Accept(const Ref<Visitor>& v)
+void MainNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
\ No newline at end of file
@@ -8,13 +8,13 @@
 #include "Ast/ReturnNode.h"
 #include "Visitor.h"
 
-ReturnNode::ReturnNode(const Ref<Node>& expression)
+ReturnNode::ReturnNode(Node* expression)
 	: expression(expression)
 {
 
 }
 
-void ReturnNode::Accept(const Ref<Visitor>& v)
+void ReturnNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
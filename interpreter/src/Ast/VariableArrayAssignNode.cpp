@@ -8,12 +8,12 @@
 #include "VariableArrayAssignNode.h"
 #include "Visitor.h"
 
-VariableArrayAssignNode::VariableArrayAssignNode(const std::string& fileName, int line, std::string name, unsigned int index, const Ref<Node>& expression)
-	: Node(fileName, line), name(std::move(name)), index(index), expression(expression)
+VariableArrayAssignNode::VariableArrayAssignNode(uint32_t fileId, int line, std::string name, unsigned int index, Node* expression)
+	: Node(fileId, line), name(std::move(name)), index(index), expression(expression)
 {
 }
 
-void VariableArrayAssignNode::Accept(const Ref<Visitor>& v)
+void VariableArrayAssignNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
@@ -8,15 +8,15 @@
 #include "VariableArrayDeclarationAssignNode.h"
 #include "Visitor.h"
 
-VariableArrayDeclarationAssignNode::VariableArrayDeclarationAssignNode(const std::string& fileName,
+VariableArrayDeclarationAssignNode::VariableArrayDeclarationAssignNode(uint32_t fileId,
                                                                        int line, std::string name,
                                                                        const TokenType arrayType,
-                                                                       std::vector<Ref<Node>> values)
-    : Node(fileName, line), name(std::move(name)), arrayType(arrayType), values(std::move(values))
+                                                                       NodeList<Node*> values)
+    : Node(fileId, line), name(std::move(name)), arrayType(arrayType), values(std::move(values))
 {
 }
 
-void VariableArrayDeclarationAssignNode::Accept(const Ref<Visitor>& v)
+void VariableArrayDeclarationAssignNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
\ No newline at end of file
@@ -8,13 +8,13 @@
 #include "VariableArrayUsageNode.h"
 #include "Visitor.h"
 
-VariableArrayUsageNode::VariableArrayUsageNode(const std::string& fileName, int line, std::string name, unsigned int index)
-	: Node(fileName, line), name(std::move(name)), index(index)
+VariableArrayUsageNode::VariableArrayUsageNode(uint32_t fileId, int line, std::string name, unsigned int index)
+	: Node(fileId, line), name(std::move(name)), index(index)
 {
 
 }
 
-void VariableArrayUsageNode::Accept(const Ref<Visitor>& v)
+void VariableArrayUsageNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
@@ -8,13 +8,13 @@
 #include "Ast/VariableAssignNode.h"
 #include "Visitor.h"
 
-VariableAssignNode::VariableAssignNode(const std::string& fileName, int line, std::string name, const Ref<Node>& expression)
-	: Node(fileName, line), name(std::move(name)), expression(expression)
+VariableAssignNode::VariableAssignNode(uint32_t fileId, int line, std::string name, Node* expression)
+	: Node(fileId, line), name(std::move(name)), expression(expression)
 {
 
 }
 
-void VariableAssignNode::Accept(const Ref<Visitor>& v)
+void VariableAssignNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
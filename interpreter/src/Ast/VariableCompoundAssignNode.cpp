@@ -8,13 +8,13 @@
 #include "Ast/VariableCompoundAssignNode.h"
 #include "Visitor.h"
 
-VariableCompoundAssignNode::VariableCompoundAssignNode(const std::string& fileName, int line, std::string name, const Ref<Node>& expression, const TokenType& operation)
-	: Node(fileName, line), name(std::move(name)), expression(expression), operation(operation)
+VariableCompoundAssignNode::VariableCompoundAssignNode(uint32_t fileId, int line, std::string name, Node* expression, const TokenType& operation)
+	: Node(fileId, line), name(std::move(name)), expression(expression), operation(operation)
 {
 
 }
 
-void VariableCompoundAssignNode::Accept(const Ref<Visitor>& v)
+void VariableCompoundAssignNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
\ No newline at end of file
@@ -8,13 +8,13 @@
 #include "Ast/VariableDeclarationAssignNode.h"
 #include "Visitor.h"
 
-VariableDeclarationAssignNode::VariableDeclarationAssignNode(const std::string& fileName, int line, std::string name, const Ref<Node>& expression)
-	: Node(fileName, line), name(std::move(name)), expression(expression)
+VariableDeclarationAssignNode::VariableDeclarationAssignNode(uint32_t fileId, int line, std::string name, Node* expression)
+	: Node(fileId, line), name(std::move(name)), expression(expression)
 {
 
 }
 
-void VariableDeclarationAssignNode::Accept(const Ref<Visitor>& v)
+void VariableDeclarationAssignNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
\ No newline at end of file
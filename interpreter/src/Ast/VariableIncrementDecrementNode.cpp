@@ -8,13 +8,13 @@
 #include "Ast/VariableIncrementDecrementNode.h"
 #include "Visitor.h"
 
-VariableIncrementDecrementNode::VariableIncrementDecrementNode(const std::string& fileName, int line, std::string name, int value)
-	: Node(fileName, line), name(std::move(name)), value(value)
+VariableIncrementDecrementNode::VariableIncrementDecrementNode(uint32_t fileId, int line, std::string name, int value)
+	: Node(fileId, line), name(std::move(name)), value(value)
 {
 
 }
 
-void VariableIncrementDecrementNode::Accept(const Ref<Visitor>& v)
+void VariableIncrementDecrementNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
@@ -8,13 +8,13 @@
 #include "Ast/VariableUsageNode.h"
 #include "Visitor.h"
 
-VariableUsageNode::VariableUsageNode(const std::string& fileName, int line, std::string name)
-	: Node(fileName, line), name(std::move(name))
+VariableUsageNode::VariableUsageNode(uint32_t fileId, int line, std::string name)
+	: Node(fileId, line), name(std::move(name))
 {
 
 }
 
-void VariableUsageNode::Accept(const Ref<Visitor>& v)
+void VariableUsageNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
@@ -8,12 +8,12 @@
 #include "WhileNode.h"
 #include "Visitor.h"
 
-WhileNode::WhileNode(const std::string& fileName, int line, const Ref<Node>& expression, const Ref<Node>& block)
-	: Node(fileName, line), expression(expression), block(block)
+WhileNode::WhileNode(uint32_t fileId, int line, Node* expression, Node* block)
+	: Node(fileId, line), expression(expression), block(block)
 {
 }
 
-void WhileNode::Accept(const Ref<Visitor>& v)
+void WhileNode::Accept(Visitor& v)
 {
-	v->Visit(shared_from_this());
+	v.Visit(*this);
 }
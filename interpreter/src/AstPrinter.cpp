@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "AstPrinter.h"
+
+AstPrinter::AstPrinter(const Ref<Node>& astRoot, std::ostream& out)
+	: Visitor(astRoot), out(out)
+{
+}
+
+void AstPrinter::Print()
+{
+	this->astRoot->Accept(*this);
+}
+
+void AstPrinter::Line(const std::string& text)
+{
+	this->out << std::string(this->depth * 2, ' ') << text << '\n';
+}
+
+void AstPrinter::Child(Node* node)
+{
+	this->depth++;
+	node->Accept(*this);
+	this->depth--;
+}
+
+void AstPrinter::Visit(MainNode& n)
+{
+	Line("Main");
+
+	for (const auto& globalVariable : n.GetGlobalVariables())
+	{
+		Child(globalVariable);
+	}
+
+	for (const auto& globalFunction : n.GetGlobalFunctions())
+	{
+		Child(globalFunction);
+	}
+}
+
+void AstPrinter::Visit(VariableDeclarationAssignNode& n)
+{
+	Line("VariableDeclarationAssign " + n.GetName());
+	Child(n.GetExpression());
+}
+
+void AstPrinter::Visit(VariableArrayDeclarationAssignNode& n)
+{
+	Line("VariableArrayDeclarationAssign " + n.GetName() + " " + Helper::ToString(n.GetArrayType()));
+
+	for (const auto& value : n.GetValues())
+	{
+		Child(value);
+	}
+}
+
+void AstPrinter::Visit(FunctionNode& n)
+{
+	std::string parameters;
+	for (const auto& parameter : n.GetParameters())
+	{
+		parameters.append(parameters.empty() ? "" : ", ").append(parameter);
+	}
+
+	Line("Function " + n.GetName() + "(" + parameters + ")");
+	Child(n.GetBlock());
+}
+
+void AstPrinter::Visit(FunctionCallNode& n)
+{
+	Line("FunctionCall " + n.GetName());
+
+	for (const auto& parameter : n.GetParameters())
+	{
+		Child(parameter);
+	}
+}
+
+void AstPrinter::Visit(ForEachNode& n)
+{
+	Line("ForEach " + n.GetVariableName());
+	Child(n.GetExpression());
+	Child(n.GetBlock());
+}
+
+void AstPrinter::Visit(ForINode& n)
+{
+	Line("ForI " + n.GetVariableName() + " " + std::to_string(n.GetFrom()) + ".." + std::to_string(n.GetTo())
+		+ " step " + std::to_string(n.GetStep()));
+	Child(n.GetBlock());
+}
+
+void AstPrinter::Visit(BlockNode& n)
+{
+	Line("Block");
+
+	for (const auto& statement : n.GetStatements())
+	{
+		Child(statement);
+	}
+}
+
+void AstPrinter::Visit(BinaryNode& n)
+{
+	Line("Binary " + Helper::ToString(n.GetOperant()));
+	Child(n.GetLeft());
+	Child(n.GetRight());
+}
+
+void AstPrinter::Visit(BooleanNode& n)
+{
+	Line("Boolean " + Helper::ToString(n.GetOperant()));
+	Child(n.GetLeft());
+	Child(n.GetRight());
+}
+
+void AstPrinter::Visit(IfNode& n)
+{
+	Line("If");
+	Child(n.GetExpression());
+	Child(n.GetTrueBlock());
+
+	for (const auto& [expression, block] : n.GetElseIfBlocks())
+	{
+		Line("ElseIf");
+		Child(expression);
+		Child(block);
+	}
+
+	if (n.GetElseBlock() != nullptr)
+	{
+		Line("Else");
+		Child(n.GetElseBlock());
+	}
+}
+
+void AstPrinter::Visit(WhileNode& n)
+{
+	Line("While");
+	Child(n.GetExpression());
+	Child(n.GetBlock());
+}
+
+void AstPrinter::Visit(DoWhileNode& n)
+{
+	Line("DoWhile");
+	Child(n.GetBlock());
+	Child(n.GetExpression());
+}
+
+void AstPrinter::Visit(StringNode& n)
+{
+	Line("String \"" + n.GetValue() + "\"");
+
+	for (const auto& expression : n.GetExpressions())
+	{
+		Child(expression);
+	}
+}
+
+void AstPrinter::Visit(IntNode& n)
+{
+	Line("Int " + std::to_string(n.GetValue()));
+}
+
+void AstPrinter::Visit(FloatNode& n)
+{
+	Line("Float " + std::to_string(n.GetValue()));
+}
+
+void AstPrinter::Visit(LongNode& n)
+{
+	Line("Long " + std::to_string(n.GetValue()));
+}
+
+void AstPrinter::Visit(DoubleNode& n)
+{
+	Line("Double " + std::to_string(n.GetValue()));
+}
+
+void AstPrinter::Visit(BoolNode& n)
+{
+	Line(n.GetValue() ? "Bool true" : "Bool false");
+}
+
+void AstPrinter::Visit(VariableUsageNode& n)
+{
+	Line("VariableUsage " + n.GetName());
+}
+
+void AstPrinter::Visit(VariableAssignNode& n)
+{
+	Line("VariableAssign " + n.GetName());
+	Child(n.GetExpression());
+}
+
+void AstPrinter::Visit(VariableArrayUsageNode& n)
+{
+	Line("VariableArrayUsage " + n.GetName() + "[" + std::to_string(n.GetIndex()) + "]");
+}
+
+void AstPrinter::Visit(VariableArrayAssignNode& n)
+{
+	Line("VariableArrayAssign " + n.GetName() + "[" + std::to_string(n.GetIndex()) + "]");
+	Child(n.GetExpression());
+}
+
+void AstPrinter::Visit(VariableIncrementDecrementNode& n)
+{
+	Line(std::string("VariableIncrementDecrement ") + n.GetName() + (n.GetValue() > 0 ? "++" : "--"));
+}
+
+void AstPrinter::Visit(VariableCompoundAssignNode& n)
+{
+	Line("VariableCompoundAssign " + n.GetName() + " " + Helper::ToString(n.GetOperation()));
+	Child(n.GetExpression());
+}
+
+void AstPrinter::Visit(ReturnNode& n)
+{
+	Line("Return");
+	Child(n.GetExpression());
+}
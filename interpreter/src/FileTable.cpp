@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include <deque>
+#include <map>
+#include "FileTable.h"
+
+// A deque never moves its elements, so the returned names stay valid
+static std::deque<std::string>& Names()
+{
+	static std::deque<std::string> names = { "" };
+
+	return names;
+}
+
+uint32_t FileTable::Intern(const std::string& fileName)
+{
+	static std::map<std::string, uint32_t> ids = { { "", 0 } };
+
+	auto result = ids.find(fileName);
+
+	if (result != ids.end())
+	{
+		return result->second;
+	}
+
+	uint32_t id = (uint32_t) Names().size();
+	Names().push_back(fileName);
+	ids.emplace(fileName, id);
+
+	return id;
+}
+
+const std::string& FileTable::GetName(uint32_t fileId)
+{
+	return Names()[fileId];
+}
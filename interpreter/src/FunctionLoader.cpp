@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "FunctionLoader.h"
+#include "Optimizer.h"
+#include "Parser.h"
+
+FunctionLoader::FunctionLoader(const Ref<Node>& astRoot, const Ref<AstArena>& arena, const Ref<SemanticAnalyzer>& semanticAnalyzer, bool optimize)
+	: astRoot(astRoot), arena(arena), semanticAnalyzer(semanticAnalyzer), optimize(optimize)
+{
+}
+
+void FunctionLoader::Load(FunctionNode& function)
+{
+	if (function.IsParsed())
+	{
+		return;
+	}
+
+	function.SetBlock(Parser::ParseFunctionBody(function, this->arena));
+	this->semanticAnalyzer->AnalyzeFunction(function);
+
+	if (this->optimize)
+	{
+		Optimizer optimizer(this->astRoot, this->arena);
+		optimizer.OptimizeFunction(function);
+	}
+
+	this->loadedFunctions++;
+}
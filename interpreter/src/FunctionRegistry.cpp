@@ -1,59 +1,119 @@
 #include "FunctionRegistry.h"
+#include "Standard.h"
 
 void FunctionRegistry::Register(const std::string& name, 
 								InternalFunctionCallback function,
 								unsigned int parameterCount, 
-								std::map<int, std::vector<TokenType>> functionParameters)
+								std::map<int, std::vector<TokenType>> functionParameters,
+								bool pure)
 {
 	FunctionEntry entry;
-	entry.function = std::move(function);
+	entry.function = function;
 	entry.parameterCount = parameterCount;
-	entry.functionParameters = std::move(functionParameters);
+	entry.parameterTypes.resize(parameterCount);
+	entry.pure = pure;
+
+	for (const auto& [index, allowedTypes] : functionParameters)
+	{
+		for (TokenType allowedType : allowedTypes)
+		{
+			entry.parameterTypes.at(index) |= TypeMaskOf(allowedType);
+		}
+	}
 
 	this->functions.insert(std::pair<std::string, FunctionEntry>(name, entry));
 }
 
-void FunctionRegistry::Call(const std::string& fileName, int line, const std::string& name, std::vector<VariableType>& in, VariableType& out)
+const FunctionRegistry& FunctionRegistry::Internal()
 {
-	auto result = this->functions.find(name);
-	if (result != this->functions.end())
+	static const FunctionRegistry registry = []
 	{
-		if (in.size() == result->second.parameterCount)
-		{
-			unsigned char parameterCheckPassedCount = 0;
+		FunctionRegistry internal;
+		internal.RegisterInternalFunctions();
 
-			// Check if input parameter types match
-			for (size_t i = 0; i < in.size(); i++)
-			{
-				auto allowedParamTypes = result->second.functionParameters.at(i);
-				for (auto & allowedParamType : allowedParamTypes)
-				{
-					if (allowedParamType == in.at(i).type
-						|| (allowedParamType == TokenType::Array && IsVariableArrayType(in.at(i).type)))
-					{
-						parameterCheckPassedCount++;
-						// Functions can have multiple allowed types per parameter, so if one of the allowed types matched, 
-						// we can just break and check the next parameter
-						break;
-					}
-				}
-			}
+		return internal;
+	}();
 
-			if (parameterCheckPassedCount == result->second.parameterCount)
-			{
-				result->second.function(in, out);
-			}
-			else
+	return registry;
+}
+
+void FunctionRegistry::RegisterInternalFunctions()
+{
+	this->Register("WriteLine", Iona::Console::WriteLine, 1, { { 0, { TokenType::Int, TokenType::Float, TokenType::Long, TokenType::Double, TokenType::String, TokenType::Bool, TokenType::Array } } });
+	this->Register("ReadLine", Iona::Console::ReadLine, 0);
+	this->Register("ReadInt", Iona::Console::ReadInt, 0);
+	this->Register("ReadFloat", Iona::Console::ReadFloat, 0);
+
+	this->Register("ToUpperCase", Iona::String::ToUpperCase, 1, { { 0, { TokenType::String } } }, true);
+	this->Register("ToLowerCase", Iona::String::ToLowerCase, 1, { { 0, { TokenType::String } } }, true);
+	this->Register("StartsWith", Iona::String::StartsWith, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } }, true);
+	this->Register("EndsWith", Iona::String::EndsWith, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } }, true);
+	this->Register("Contains", Iona::String::Contains, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } }, true);
+	this->Register("Split", Iona::String::Split, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } });
+	this->Register("Trim", Iona::String::Trim, 1, { { 0, { TokenType::String } } }, true);
+
+	this->Register("Size", Iona::Core::Size, 1, { { 0, { TokenType::String, TokenType::Array } } }, true);
+	this->Register("Empty", Iona::Core::Empty, 1, { { 0, { TokenType::String, TokenType::Array } } }, true);
+	this->Register("Random", Iona::Core::Random, 2, { { 0, { TokenType::Int } }, { 1, { TokenType::Int } } });
+	this->Register("Range", Iona::Core::Range, 1, { { 0, { TokenType::Int } } });
+	this->Register("Reverse", Iona::Core::Reverse, 1, { { 0, { TokenType::IntArray, TokenType::StringArray, TokenType::BoolArray, TokenType::FloatArray } } });
+	this->Register("ToString", Iona::Core::ToString, 1, { { 0, { TokenType::String, TokenType::Int, TokenType::Float, TokenType::Long, TokenType::Double, TokenType::Bool, TokenType::Array } } }, true);
+
+	this->Register("Min", Iona::Math::Min, 2, { { 0, { TokenType::Int, TokenType::Float, TokenType::Long, TokenType::Double } }, { 1, { TokenType::Int, TokenType::Float, TokenType::Long, TokenType::Double } } }, true);
+	this->Register("Max", Iona::Math::Max, 2, { { 0, { TokenType::Int, TokenType::Float, TokenType::Long, TokenType::Double } }, { 1, { TokenType::Int, TokenType::Float, TokenType::Long, TokenType::Double } } }, true);
+
+	this->Register("FileExists", Iona::File::FileExists, 1, { { 0, { TokenType::String } } });
+	this->Register("FileRead", Iona::File::FileRead, 1, { { 0, { TokenType::String } } });
+	this->Register("FileWrite", Iona::File::FileWrite, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } });
+	this->Register("FileCopy", Iona::File::FileCopy, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } });
+	this->Register("FileReadLines", Iona::File::FileReadLines, 1, { { 0, { TokenType::String } } });
+	this->Register("FileWriteLines", Iona::File::FileWriteLines, 3, { { 0, { TokenType::String } }, { 1, { TokenType::StringArray } }, { 2, { TokenType::Bool } } });
+	this->Register("FileList", Iona::File::FileList, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } });
+}
+
+void FunctionRegistry::Call(const std::string& fileName, int line, const std::string& name, const FunctionEntry& entry, std::vector<Value>& in, Value& out)
+{
+	if (in.size() == entry.parameterCount)
+	{
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			if (!entry.Accepts(i, in[i].GetType()))
 			{
-				// TODO: More details like what parameter index, which type etc.
-				Exit(fileName, line, "Function call parameter types are not matching the allowed types from function '%s'", name.c_str());
+				Exit(fileName, line, "Parameter %zu of function '%s' needs to be of type %s, but is '%s'",
+					i + 1, name.c_str(), Helper::TypesToString(entry.parameterTypes[i]).c_str(), Helper::ToString(in[i].GetType()).c_str());
 			}
 		}
-		else
+
+		entry.function(in, out);
+	}
+	else
+	{
+		Exit(fileName, line, "Function call parameter count (%zu) is not matching expected parameter count (%u) of function '%s'", in.size(), entry.parameterCount, name.c_str());
+	}
+}
+
+bool FunctionRegistry::Accepts(const FunctionEntry& entry, const std::vector<Value>& in)
+{
+	if (in.size() != entry.parameterCount)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < in.size(); i++)
+	{
+		if (!entry.Accepts(i, in[i].GetType()))
 		{
-			Exit(fileName, line, "Function call parameter count (%i) is not matching expected parameter count (%i) of function '%s'", in.size(), result->second.parameterCount, name.c_str());
+			return false;
 		}
 	}
+
+	return true;
+}
+
+const FunctionEntry* FunctionRegistry::Find(const std::string& name) const
+{
+	auto result = this->functions.find(name);
+	return result != this->functions.end() ? &result->second : nullptr;
 }
 
 bool FunctionRegistry::Exists(const std::string& name)
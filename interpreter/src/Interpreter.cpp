@@ -8,9 +8,6 @@
 #include "Interpreter.h"
 #include "Standard.h"
 #include <chrono>
-#define _USE_MATH_DEFINES
-#include <math.h>
-#include <limits>
 
 Interpreter::Interpreter(const std::vector<std::string>& args, const Ref<Node>& astRoot)
     : Interpreter(args, astRoot, std::make_shared<InterpreterScope>())
@@ -18,87 +15,35 @@ Interpreter::Interpreter(const std::vector<std::string>& args, const Ref<Node>&
 }
 
 Interpreter::Interpreter(const std::vector<std::string>& args, const Ref<Node>& astRoot, const Ref<InterpreterScope>& scope)
-	: Visitor(astRoot)
+	: Visitor(astRoot), globals(scope), stack(1024)
 {
-	this->scopes.push_back(scope);
-
-	RegisterInternalFunctions();
 	RegisterInternalVariables();
 
-	std::vector<VariableType> argsValues;
+	std::vector<Value> argsValues;
 	argsValues.reserve(args.size());
 	for (auto& arg : args)
 	{
-		argsValues.push_back({ TokenType::String, arg });
+		argsValues.emplace_back(arg);
 	}
-	this->scopes.back()->DeclareVariable("ARGS", TokenType::StringArray, argsValues);
-}
-
-void Interpreter::RegisterInternalFunctions()
-{
-	this->internalFunctions.Register("WriteLine", Iona::Console::WriteLine, 1, { { 0, { TokenType::Int, TokenType::Float, TokenType::String, TokenType::Bool, TokenType::Array } } });
-	this->internalFunctions.Register("ReadLine", Iona::Console::ReadLine, 0);
-	this->internalFunctions.Register("ReadInt", Iona::Console::ReadInt, 0);
-	this->internalFunctions.Register("ReadFloat", Iona::Console::ReadFloat, 0);
 
-	this->internalFunctions.Register("ToUpperCase", Iona::String::ToUpperCase, 1, { { 0, { TokenType::String } } });
-	this->internalFunctions.Register("ToLowerCase", Iona::String::ToLowerCase, 1, { { 0, { TokenType::String } } });
-	this->internalFunctions.Register("StartsWith", Iona::String::StartsWith, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } });
-	this->internalFunctions.Register("EndsWith", Iona::String::EndsWith, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } });
-	this->internalFunctions.Register("Contains", Iona::String::Contains, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } });
-	this->internalFunctions.Register("Split", Iona::String::Split, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } });
-	this->internalFunctions.Register("Trim", Iona::String::Trim, 1, { { 0, { TokenType::String } } });
-
-	this->internalFunctions.Register("Size", Iona::Core::Size, 1, { { 0, { TokenType::String, TokenType::Array } } });
-	this->internalFunctions.Register("Empty", Iona::Core::Empty, 1, { { 0, { TokenType::String, TokenType::Array } } });
-	this->internalFunctions.Register("Random", Iona::Core::Random, 2, { { 0, { TokenType::Int } }, { 1, { TokenType::Int } } });
-	this->internalFunctions.Register("Range", Iona::Core::Range, 1, { { 0, { TokenType::Int } } });
-	this->internalFunctions.Register("Reverse", Iona::Core::Reverse, 1, { { 0, { TokenType::IntArray, TokenType::StringArray, TokenType::BoolArray, TokenType::FloatArray } } });
-	this->internalFunctions.Register("ToString", Iona::Core::ToString, 1, { { 0, { TokenType::String, TokenType::Int, TokenType::Float, TokenType::Bool, TokenType::Array } } });
-
-	this->internalFunctions.Register("Min", Iona::Math::Min, 2, { { 0, { TokenType::Int, TokenType::Float } }, { 1, { TokenType::Int, TokenType::Float } } });
-	this->internalFunctions.Register("Max", Iona::Math::Max, 2, { { 0, { TokenType::Int, TokenType::Float } }, { 1, { TokenType::Int, TokenType::Float } } });
-
-	this->internalFunctions.Register("FileExists", Iona::File::FileExists, 1, { { 0, { TokenType::String } } });
-	this->internalFunctions.Register("FileRead", Iona::File::FileRead, 1, { { 0, { TokenType::String } } });
-	this->internalFunctions.Register("FileWrite", Iona::File::FileWrite, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } });
-	this->internalFunctions.Register("FileCopy", Iona::File::FileCopy, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } });
-	this->internalFunctions.Register("FileReadLines", Iona::File::FileReadLines, 1, { { 0, { TokenType::String } } });
-	this->internalFunctions.Register("FileWriteLines", Iona::File::FileWriteLines, 3, { { 0, { TokenType::String } }, { 1, { TokenType::StringArray } }, { 2, { TokenType::Bool } } });
-	this->internalFunctions.Register("FileList", Iona::File::FileList, 2, { { 0, { TokenType::String } }, { 1, { TokenType::String } } });
+	// ARGS follows the internal variables, like in the semantic analyzer
+	this->globals->DeclareVariable(Iona::InternalVariables().size(), TokenType::StringArray, argsValues);
 }
 
 void Interpreter::RegisterInternalVariables()
 {
-	this->scopes.back()->DeclareVariable("PI", { TokenType::Float, (float) M_PI });
-
-	this->scopes.back()->DeclareVariable("INT_MIN", { TokenType::Int, std::numeric_limits<int>::min() });
-	this->scopes.back()->DeclareVariable("INT_MAX", { TokenType::Int, std::numeric_limits<int>::max() });
-
-	this->scopes.back()->DeclareVariable("FLOAT_MIN", { TokenType::Float, std::numeric_limits<float>::min() });
-	this->scopes.back()->DeclareVariable("FLOAT_MAX", { TokenType::Float, std::numeric_limits<float>::max() });
-}
-
-Ref<InterpreterScope> Interpreter::FindScopeOfVariable(const std::string& variableName)
-{
-	Ref<InterpreterScope> scope = nullptr;
-	for (size_t i = this->scopes.size(); i-- > 0; )
+	int slot = 0;
+	for (auto& [name, value] : Iona::InternalVariables())
 	{
-		if (this->scopes[i]->IsDeclared(variableName))
-		{
-			scope = this->scopes[i];
-			break;
-		}
+		this->globals->DeclareVariable(slot++, std::move(value));
 	}
-
-	return scope;
 }
 
 void Interpreter::Interpret()
 {
 	auto start = std::chrono::high_resolution_clock::now();
 
-	this->astRoot->Accept(shared_from_this());
+	this->astRoot->Accept(*this);
 
     auto end = std::chrono::high_resolution_clock::now();
 
@@ -107,683 +52,601 @@ void Interpreter::Interpret()
 		std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
 }
 
-void Interpreter::Visit(const Ref<MainNode>& n)
+void Interpreter::Visit(MainNode& n)
 {
-	for (const auto& globalVariable : n->GetGlobalVariables())
+	for (const auto& globalVariable : n.GetGlobalVariables())
 	{
-		globalVariable->Accept(shared_from_this());
+		globalVariable->Accept(*this);
 	}
 
-	for (auto& globalFunction : n->GetGlobalFunctions())
-	{
-		Ref<FunctionNode> fun = std::dynamic_pointer_cast<FunctionNode>(globalFunction);
+	// Parser has ensured that there is a main function at index zero
+	n.GetGlobalFunctions()[0]->Accept(*this);
+}
+
+void Interpreter::Visit(VariableDeclarationAssignNode& n)
+{
+	n.GetExpression()->Accept(*this);
 
-		this->globalFunctions.insert(std::pair<std::string, Ref<FunctionNode>>(fun->GetName(), fun));
+	if (!IsVariableType(this->currentVariable.GetType()))
+	{
+		Exit(n.GetFileName(), n.GetLine(), "Type '%s' of variable '%s' is not a valid variable type",
+			Helper::ToString(this->currentVariable.GetType()).c_str(), n.GetName().c_str());
 	}
 
-	// Parser has ensured that there is a main function at index zero
-	n->GetGlobalFunctions().at(0)->Accept(shared_from_this());
+	DeclareVariable(n.GetSlot(), this->currentVariable);
 }
 
-void Interpreter::Visit(const Ref<VariableDeclarationAssignNode>& n)
+size_t Interpreter::PushFrame(FunctionNode& function)
 {
-	n->GetExpression()->Accept(shared_from_this());
+	// The frame size of a lazily parsed function is known once its body is loaded on the first call
+	if (!function.IsParsed())
+	{
+		this->functionLoader->Load(function);
+	}
+
+	size_t base = this->stackTop;
+	this->stackTop += function.GetFrameSize();
 
-	if (!IsVariableType(this->currentVariable.type))
+	// Grows only while no reference to a variable is held, as calls are never part of one
+	if (this->stackTop > this->stack.size())
 	{
-		Exit(n->GetFileName(), n->GetLine(), "Type '%s' of variable '%s' is not a valid variable type",
-			Helper::ToString(this->currentVariable.type).c_str(), n->GetName().c_str());
+		this->stack.resize(std::max(this->stackTop, this->stack.size() * 2));
 	}
 
-	this->scopes.back()->DeclareVariable(n->GetName(), this->currentVariable);
+	return base;
 }
 
-void Interpreter::Visit(const Ref<FunctionNode>& n)
+size_t Interpreter::PushArguments(FunctionCallNode& n, FunctionNode& function)
 {
-	this->scopes.push_back(std::make_shared<InterpreterScope>());
+	if (n.GetParameters().size() != function.GetParameters().size())
+	{
+		Exit(n.GetFileName(), n.GetLine(), "Function call parameter count (%zu) is not matching expected parameter count (%zu) of function '%s'",
+			n.GetParameters().size(), function.GetParameters().size(), function.GetName().c_str());
+	}
 
-	// We need to register possible function parameters after the possible function scope was pushed
-	for (size_t i = 0; i < this->currentFunctionCallParams.size(); ++i)
+	// Parameters are the first slots of the frame. The arguments are evaluated in the frame of
+	// the caller directly into them, calls inside the arguments get frames above the new one.
+	size_t base = PushFrame(function);
+
+	for (size_t i = 0; i < n.GetParameters().size(); i++)
 	{
-		// Accept the parameter types (eg. StringNode)
-		this->currentFunctionCallParams[i]->Accept(shared_from_this());
+		n.GetParameters()[i]->Accept(*this);
 
-		this->scopes.back()->DeclareVariable(this->currentFunctionCallFunctionParams[i], this->currentVariable);
+		this->stack[base + i] = std::move(this->currentVariable);
 	}
 
-	n->GetBlock()->Accept(shared_from_this());
-
-	this->scopes.pop_back();
+	return base;
 }
 
-void Interpreter::Visit(const Ref<BlockNode>& n)
+void Interpreter::Execute(FunctionNode& function, size_t base)
 {
-	for (auto& statement : n->GetStatements())
+	size_t callerBase = this->frameBase;
+	this->frameBase = base;
+	this->callDepth++;
+
+	function.GetBlock()->Accept(*this);
+
+	// Tail calls continue in the same frame, so the native stack does not grow with the recursion depth
+	while (this->tailCall != nullptr)
 	{
-		statement->Accept(shared_from_this());
+		FunctionNode& callee = *this->tailCall;
+		size_t arguments = this->tailCallArguments;
+		this->tailCall = nullptr;
+		this->returning = false;
+
+		// The arguments were evaluated into a frame above this one, move them into the parameter slots
+		for (size_t i = 0; i < callee.GetParameters().size() && arguments != base; i++)
+		{
+			this->stack[base + i] = std::move(this->stack[arguments + i]);
+		}
+
+		for (size_t i = base + callee.GetParameters().size(); i < this->stackTop; i++)
+		{
+			this->stack[i] = Value();
+		}
+
+		// The stack already holds the frame of the callee above this one, so it is large enough
+		this->stackTop = base + callee.GetFrameSize();
+
+		callee.GetBlock()->Accept(*this);
 	}
+
+	// Like in the virtual machine, a function without a return statement returns nothing
+	if (!this->returning)
+	{
+		this->currentVariable = Value();
+	}
+	this->returning = false;
+
+	// Release the values of the frame, the slots are reused by the next call
+	for (size_t i = base; i < this->stackTop; i++)
+	{
+		this->stack[i] = Value();
+	}
+
+	this->callDepth--;
+	this->frameBase = callerBase;
+	this->stackTop = base;
 }
 
-void Interpreter::Visit(const Ref<FunctionCallNode>& n)
+void Interpreter::Visit(FunctionNode& n)
 {
-	auto result = this->globalFunctions.find(n->GetName());
+	// Only the main function is visited, calls enter their function in Visit(FunctionCallNode)
+	Execute(n, PushFrame(n));
+}
 
-	if (result != this->globalFunctions.end())
+void Interpreter::Visit(BlockNode& n)
+{
+	for (auto& statement : n.GetStatements())
 	{
-		Ref<FunctionNode> function = result->second;
+		statement->Accept(*this);
 
-		if (n->GetParameters().size() != function->GetParameters().size())
+		if (this->returning)
 		{
-			Exit(n->GetFileName(), n->GetLine(), "Function call parameter count (%i) is not matching expected parameter count (%i) of function '%s'",
-				n->GetParameters().size(), function->GetParameters().size(), function->GetName().c_str());
+			return;
 		}
+	}
+}
 
-		this->currentFunctionCallParams = n->GetParameters();
-		this->currentFunctionCallFunctionParams = function->GetParameters();
+void Interpreter::Visit(FunctionCallNode& n)
+{
+	// The semantic analyzer has bound the call to either a function of the program or an internal one
+	if (FunctionNode* function = n.GetFunction())
+	{
+		// Tail calls are not counted, they do not recurse
+		if (this->callDepth >= this->maxCallDepth)
+		{
+			Exit(n.GetFileName(), n.GetLine(), "Maximum call depth of %i exceeded by a call of function '%s'", this->maxCallDepth, n.GetName().c_str());
+		}
 
-		function->Accept(shared_from_this());
+		Execute(*function, PushArguments(n, *function));
 	}
 	// Internal function handling
 	else
 	{
-        std::vector<VariableType> in;
-        in.reserve(n->GetParameters().size());
-        VariableType out;
+        std::vector<Value> in;
+        in.reserve(n.GetParameters().size());
+        Value out;
 
-        for (auto& parameter : n->GetParameters())
+        for (auto& parameter : n.GetParameters())
         {
-            parameter->Accept(shared_from_this());
+            parameter->Accept(*this);
 
-            in.push_back(this->currentVariable);
+            // Arguments share the storage of strings and arrays, they are only copied on a write
+            in.push_back(std::move(this->currentVariable));
         }
 
-        this->internalFunctions.Call(n->GetFileName(), n->GetLine(), n->GetName(), in, out);
+        const FunctionEntry& entry = *n.GetInternalFunction();
+
+        // Parameter types proven by the semantic analyzer are not checked again
+        if (n.AreTypesChecked())
+        {
+            entry.function(in, out);
+        }
+        else
+        {
+            FunctionRegistry::Call(n.GetFileName(), n.GetLine(), n.GetName(), entry, in, out);
+        }
 
         // We need to update the current variable with the returned one
         this->currentVariable = std::move(out);
 	}
 }
 
-void Interpreter::Visit(const Ref<ForEachNode>& n)
+void Interpreter::Visit(ForEachNode& n)
 {
-	n->GetExpression()->Accept(shared_from_this());
+	n.GetExpression()->Accept(*this);
 
-	if (!IsVariableArrayType(this->currentVariable.type))
+	if (!IsVariableArrayType(this->currentVariable.GetType()))
 	{
-		Exit(n->GetFileName(), n->GetLine(), "For loop can only loop over arrays, but in type is '%s'", Helper::ToString(this->currentVariable.type).c_str());
+		Exit(n.GetFileName(), n.GetLine(), "For loop can only loop over arrays, but in type is '%s'", Helper::ToString(this->currentVariable.GetType()).c_str());
 	}
 
-	this->scopes.push_back(std::make_shared<InterpreterScope>());
+	// Keep a reference to the array while looping, the block may overwrite the current variable.
+	// Writes to the array variable inside the block copy it, so the loop is not affected by them.
+	Value array = std::move(this->currentVariable);
 
-	this->scopes.back()->DeclareVariable(n->GetVariableName(), this->currentVariable.type);
+	// Loop directly over the dense storage of the array
+	auto loop = [&](const auto& values)
+	{
+		for (const auto& value : values)
+		{
+			DeclareVariable(n.GetSlot(), Value(value));
 
-	auto values = std::any_cast<std::vector<VariableType>>(this->currentVariable.value);
-		
-	for (auto& value : values)
+			n.GetBlock()->Accept(*this);
+
+			if (this->returning)
+			{
+				return;
+			}
+		}
+	};
+
+	switch (array.GetType())
 	{
-		// TODO: Check variable type??
-		this->scopes.back()->UpdateVariable(n->GetVariableName(), value);
-			
-		n->GetBlock()->Accept(shared_from_this());
+		case TokenType::IntArray:
+			loop(array.GetIntArray());
+			break;
+		case TokenType::FloatArray:
+			loop(array.GetFloatArray());
+			break;
+		case TokenType::BoolArray:
+			loop(array.GetBoolArray());
+			break;
+		case TokenType::StringArray:
+			loop(array.GetStringArray());
+			break;
+		default:
+			break;
 	}
-
-	this->scopes.pop_back();
 }
 
-void Interpreter::Visit(const Ref<ForINode>& n)
+void Interpreter::Visit(ForINode& n)
 {
-	this->scopes.push_back(std::make_shared<InterpreterScope>());
-
-	this->scopes.back()->DeclareVariable(n->GetVariableName(), TokenType::Int);
-
-	for (int i = n->GetFrom(); i < n->GetTo(); i += n->GetStep())
+	for (int i = n.GetFrom(); i < n.GetTo(); i += n.GetStep())
 	{
-		this->scopes.back()->UpdateVariable(n->GetVariableName(), { TokenType::Int, i });
+		DeclareVariable(n.GetSlot(), Value(i));
 
-		n->GetBlock()->Accept(shared_from_this());
-	}
+		n.GetBlock()->Accept(*this);
 
-	this->scopes.pop_back();
+		if (this->returning)
+		{
+			return;
+		}
+	}
 }
 
-void Interpreter::Visit(const Ref<StringNode>& n)
+void Interpreter::Visit(StringNode& n)
 {
-	std::string value = n->GetValue();
+	std::string value = n.GetValue();
 
-	for (auto& expression : n->GetExpressions())
+	for (auto& expression : n.GetExpressions())
 	{
-		expression->Accept(shared_from_this());
+		expression->Accept(*this);
 
 		int index = value.find("$R$");
 		value = value.replace(index, 3, Iona::ToStringInternal(this->currentVariable));
 	}
 
-	VariableType v;
-	v.type = TokenType::String;
-	v.value = value;
-
-	this->currentVariable = std::move(v);
+	this->currentVariable = Value(std::move(value));
 }
 
-void Interpreter::Visit(const Ref<IntNode>& n)
+void Interpreter::Visit(IntNode& n)
 {
-	VariableType v;
-	v.type = TokenType::Int;
-	v.value = n->GetValue();
-
-	this->currentVariable = std::move(v);
+	this->currentVariable = Value(n.GetValue());
 }
 
-void Interpreter::Visit(const Ref<FloatNode>& n)
+void Interpreter::Visit(FloatNode& n)
 {
-	VariableType v;
-	v.type = TokenType::Float;
-	v.value = n->GetValue();
-
-	this->currentVariable = std::move(v);
+	this->currentVariable = Value(n.GetValue());
 }
 
-void Interpreter::Visit(const Ref<BoolNode>& n)
+void Interpreter::Visit(LongNode& n)
 {
-	VariableType v;
-	v.type = TokenType::Bool;
-	v.value = n->GetValue();
+	this->currentVariable = Value(n.GetValue());
+}
 
-	this->currentVariable = std::move(v);
+void Interpreter::Visit(DoubleNode& n)
+{
+	this->currentVariable = Value(n.GetValue());
 }
 
-void Interpreter::Visit(const Ref<VariableUsageNode>& n)
+void Interpreter::Visit(BoolNode& n)
 {
-	auto scope = FindScopeOfVariable(n->GetName());
+	this->currentVariable = Value(n.GetValue());
+}
 
-	if (scope != nullptr)
-	{
-		this->currentVariable = *scope->GetVariable(n->GetName());
-	}
+void Interpreter::Visit(VariableUsageNode& n)
+{
+	this->currentVariable = GetVariable(n);
 }
 
-void Interpreter::Visit(const Ref<VariableIncrementDecrementNode>& n)
+void Interpreter::Visit(VariableIncrementDecrementNode& n)
 {
-	auto scope = FindScopeOfVariable(n->GetName());
+	Value& variable = GetVariable(n);
 
-	if (scope != nullptr)
+	if (IncrementOperation operation = n.GetTypedOperation())
 	{
-		auto variable = scope->GetVariable(n->GetName());
-		
-		if (variable->type == TokenType::Int)
-		{
-			variable->value = std::any_cast<int>(variable->value) + n->GetValue();
-		}
-		else if (variable->type == TokenType::Float)
-		{
-			variable->value = std::any_cast<float>(variable->value) + (float)n->GetValue();
-		}
-		else
-		{
-			Exit(n->GetFileName(), n->GetLine(), "Variable increments are only supported with int and float type, but got %s",
-				Helper::ToString(variable->type).c_str());
-		}
+		operation(variable, n.GetValue());
 
-		this->currentVariable = *variable;
+		this->currentVariable = variable;
+		return;
 	}
+
+	if (variable.GetType() == TokenType::Int)
+	{
+		variable = Value(WrappingPlus<int>()(variable.GetInt(), n.GetValue()));
+	}
+	else if (variable.GetType() == TokenType::Float)
+	{
+		variable = Value(variable.GetFloat() + (float)n.GetValue());
+	}
+	else if (variable.GetType() == TokenType::Long)
+	{
+		variable = Value(WrappingPlus<int64_t>()(variable.GetLong(), n.GetValue()));
+	}
+	else if (variable.GetType() == TokenType::Double)
+	{
+		variable = Value(variable.GetDouble() + n.GetValue());
+	}
+	else
+	{
+		Exit(n.GetFileName(), n.GetLine(), "Variable increments are only supported with int, float, long and double type, but got %s",
+			Helper::ToString(variable.GetType()).c_str());
+	}
+
+	this->currentVariable = variable;
 }
 
-void Interpreter::Visit(const Ref<VariableAssignNode>& n)
+void Interpreter::Visit(VariableAssignNode& n)
 {
-	auto innerScope = FindScopeOfVariable(n->GetName());
+	n.GetExpression()->Accept(*this);
 
-	n->GetExpression()->Accept(shared_from_this());
-
-	auto variable = innerScope->GetVariable(n->GetName());
+	Value& variable = GetVariable(n);
 
 	// We only need to check for same type, because the variable needs to be declared
 	// so it was already checked that it's a valid variable type
-	if (this->currentVariable.type != variable->type)
+	if (this->currentVariable.GetType() != variable.GetType())
 	{
-		Exit(n->GetFileName(), n->GetLine(), "New value of variable '%s' needs to be of type '%s', but is '%s'",
-			n->GetName().c_str(), Helper::ToString(variable->type).c_str(), Helper::ToString(this->currentVariable.type).c_str());
+		Exit(n.GetFileName(), n.GetLine(), "New value of variable '%s' needs to be of type '%s', but is '%s'",
+			n.GetName().c_str(), Helper::ToString(variable.GetType()).c_str(), Helper::ToString(this->currentVariable.GetType()).c_str());
 	}
 
-	innerScope->UpdateVariable(n->GetName(), this->currentVariable);
+	variable = this->currentVariable;
 }
 
-void Interpreter::Visit(const Ref<VariableCompoundAssignNode>& n)
+void Interpreter::Visit(VariableCompoundAssignNode& n)
 {
-	auto innerScope = FindScopeOfVariable(n->GetName());
+	n.GetExpression()->Accept(*this);
+
+	Value& variable = GetVariable(n);
 
-	n->GetExpression()->Accept(shared_from_this());
+	if (BinaryOperation operation = n.GetTypedOperation())
+	{
+		operation(variable, this->currentVariable, variable);
 
-	auto variable = innerScope->GetVariable(n->GetName());
+		this->currentVariable = variable;
+		return;
+	}
 
 	// We only need to check for same type, because the variable needs to be declared
 	// so it was already checked that it's a valid variable type
-	if (this->currentVariable.type != variable->type)
+	if (this->currentVariable.GetType() != variable.GetType())
 	{
-		Exit(n->GetFileName(), n->GetLine(), "New value of variable '%s' needs to be of type '%s', but is '%s'",
-			n->GetName().c_str(), Helper::ToString(variable->type).c_str(), Helper::ToString(this->currentVariable.type).c_str());
+		Exit(n.GetFileName(), n.GetLine(), "New value of variable '%s' needs to be of type '%s', but is '%s'",
+			n.GetName().c_str(), Helper::ToString(variable.GetType()).c_str(), Helper::ToString(this->currentVariable.GetType()).c_str());
 	}
 
-	VariableType vt;
-
-	if (variable->type == TokenType::Int)
+	if (!IsNumberType(variable.GetType()))
 	{
-		vt.type = TokenType::Int;
-
-		switch (n->GetOperation())
-		{
-			case TokenType::Plus:
-				vt.value = std::any_cast<int>(variable->value) + std::any_cast<int>(this->currentVariable.value);
-				break;
-			case TokenType::Minus:
-				vt.value = std::any_cast<int>(variable->value) - std::any_cast<int>(this->currentVariable.value);
-				break;
-			case TokenType::Multiply:
-				vt.value = std::any_cast<int>(variable->value) * std::any_cast<int>(this->currentVariable.value);
-				break;
-			case TokenType::Divide:
-				vt.value = std::any_cast<int>(variable->value) / std::any_cast<int>(this->currentVariable.value);
-				break;
-		}
+		Exit(n.GetFileName(), n.GetLine(), "Variable increment assignments are only supported with int, float, long and double type, but got %s",
+			Helper::ToString(variable.GetType()).c_str());
 	}
-	else if (variable->type == TokenType::Float)
-	{
-		vt.type = TokenType::Float;
 
-		switch (n->GetOperation())
-		{
-			case TokenType::Plus:
-				vt.value = std::any_cast<float>(variable->value) + std::any_cast<float>(this->currentVariable.value);
-				break;
-			case TokenType::Minus:
-				vt.value = std::any_cast<float>(variable->value) - std::any_cast<float>(this->currentVariable.value);
-				break;
-			case TokenType::Multiply:
-				vt.value = std::any_cast<float>(variable->value) * std::any_cast<float>(this->currentVariable.value);
-				break;
-			case TokenType::Divide:
-				vt.value = std::any_cast<float>(variable->value) / std::any_cast<float>(this->currentVariable.value);
-				break;
-		}
-	}
-	else
-	{
-		Exit(n->GetFileName(), n->GetLine(), "Variable increment assignments are only supported with int and float type, but got %s",
-			Helper::ToString(variable->type).c_str());
-	}
+	Value vt = variable.Arithmetic(n.GetOperation(), this->currentVariable);
 
 	this->currentVariable = vt;
 
-	innerScope->UpdateVariable(n->GetName(), vt);
+	variable = std::move(vt);
 }
 
-void Interpreter::Visit(const Ref<BinaryNode>& n)
+void Interpreter::Visit(BinaryNode& n)
 {
-	n->GetLeft()->Accept(shared_from_this());
+	n.GetLeft()->Accept(*this);
 
-	VariableType leftVariable = this->currentVariable;
+	Value leftVariable = std::move(this->currentVariable);
 
-	n->GetRight()->Accept(shared_from_this());
+	n.GetRight()->Accept(*this);
 
-	VariableType rightVariable = this->currentVariable;
-
-	VariableType resultVariable;
-
-	if (leftVariable.type == TokenType::Int && rightVariable.type == TokenType::Int)
+	// Proven types have their operation, other types use the one cached for the types of the last evaluation.
+	// The result replaces the right operand in the current variable.
+	BinaryOperation operation = n.GetTypedOperation();
+	if (operation == nullptr)
 	{
-		resultVariable.type = TokenType::Int;
-			
-		if (n->GetOperant() == TokenType::Plus)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) + std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::Minus)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) - std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::Multiply)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) * std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::Divide)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) / std::any_cast<int>(rightVariable.value);
-		}
+		operation = Quicken(n.GetInlineCache(), n.GetOperant(), leftVariable, this->currentVariable, SpecializeArithmetic);
 	}
-	else if (leftVariable.type == TokenType::Float && rightVariable.type == TokenType::Float)
-	{
-		resultVariable.type = TokenType::Float;
 
-		if (n->GetOperant() == TokenType::Plus)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) + std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::Minus)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) - std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::Multiply)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) * std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::Divide)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) / std::any_cast<float>(rightVariable.value);
-		}
-	}
-	else if (leftVariable.type == TokenType::String && rightVariable.type == TokenType::String)
+	if (operation != nullptr)
 	{
-		resultVariable.type = TokenType::String;
-			
-		if (n->GetOperant() == TokenType::Plus)
-		{
-			resultVariable.value = std::any_cast<std::string>(leftVariable.value) + std::any_cast<std::string>(rightVariable.value);
-		}
-		else
-		{
-			Exit(n->GetFileName(), n->GetLine(), "Invalid arithmetic string operator '%s'", Helper::ToString(n->GetOperant()).c_str());
-		}
+		operation(leftVariable, this->currentVariable, this->currentVariable);
+		return;
 	}
 
-	this->currentVariable = std::move(resultVariable);
-}
+	Value rightVariable = std::move(this->currentVariable);
 
-void Interpreter::Visit(const Ref<BooleanNode>& n)
-{
-	n->GetLeft()->Accept(shared_from_this());
+	Value resultVariable;
 
-	VariableType leftVariable = this->currentVariable;
-
-	n->GetRight()->Accept(shared_from_this());
-
-	VariableType rightVariable = this->currentVariable;
-
-	VariableType resultVariable;
-	resultVariable.type = TokenType::Bool;
-
-	if (leftVariable.type == TokenType::Int && rightVariable.type == TokenType::Int)
-	{
-		if (n->GetOperant() == TokenType::Equals)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) == std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::NotEquals)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) != std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::LessThan)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) < std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::GreaterThan)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) > std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::LessEqualThan)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) <= std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::GreaterEqualThan)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) >= std::any_cast<int>(rightVariable.value);
-		}
-	}
-	else if (leftVariable.type == TokenType::Float && rightVariable.type == TokenType::Float)
-	{
-		if (n->GetOperant() == TokenType::Equals)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) == std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::NotEquals)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) != std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::LessThan)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) < std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::GreaterThan)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) > std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::LessEqualThan)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) <= std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::GreaterEqualThan)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) >= std::any_cast<float>(rightVariable.value);
-		}
-	}
-	else if (leftVariable.type == TokenType::Int && rightVariable.type == TokenType::Float)
-	{
-		if (n->GetOperant() == TokenType::Equals)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) == std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::NotEquals)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) != std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::LessThan)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) < std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::GreaterThan)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) > std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::LessEqualThan)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) <= std::any_cast<float>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::GreaterEqualThan)
-		{
-			resultVariable.value = std::any_cast<int>(leftVariable.value) >= std::any_cast<float>(rightVariable.value);
-		}
-	}
-	else if (leftVariable.type == TokenType::Float && rightVariable.type == TokenType::Int)
-	{
-		if (n->GetOperant() == TokenType::Equals)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) == std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::NotEquals)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) != std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::LessThan)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) < std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::GreaterThan)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) > std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::LessEqualThan)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) <= std::any_cast<int>(rightVariable.value);
-		}
-		else if (n->GetOperant() == TokenType::GreaterEqualThan)
-		{
-			resultVariable.value = std::any_cast<float>(leftVariable.value) >= std::any_cast<int>(rightVariable.value);
-		}
-	}
-	else if (leftVariable.type == TokenType::String && rightVariable.type == TokenType::String)
+	if (leftVariable.GetType() == TokenType::String && rightVariable.GetType() == TokenType::String)
 	{
-		if (n->GetOperant() == TokenType::Equals)
+		if (n.GetOperant() == TokenType::Plus)
 		{
-			resultVariable.value = std::any_cast<std::string>(leftVariable.value) == std::any_cast<std::string>(rightVariable.value);
+			resultVariable = Value(leftVariable.GetString() + rightVariable.GetString());
 		}
-		else if (n->GetOperant() == TokenType::NotEquals)
+		else
 		{
-			resultVariable.value = std::any_cast<std::string>(leftVariable.value) != std::any_cast<std::string>(rightVariable.value);
+			Exit(n.GetFileName(), n.GetLine(), "Invalid arithmetic string operator '%s'", Helper::ToString(n.GetOperant()).c_str());
 		}
 	}
 	else
 	{
-		resultVariable.value = false;
+		// Mixed types do not have a result
+		resultVariable = leftVariable.Arithmetic(n.GetOperant(), rightVariable);
 	}
 
 	this->currentVariable = std::move(resultVariable);
 }
 
-void Interpreter::Visit(const Ref<VariableArrayDeclarationAssignNode>& n)
+void Interpreter::Visit(BooleanNode& n)
 {
-	std::vector<VariableType> values;
+	n.GetLeft()->Accept(*this);
 
-	for (auto& value : n->GetValues())
-	{
-		value->Accept(shared_from_this());
+	Value leftVariable = std::move(this->currentVariable);
 
-		VariableType variable;
+	n.GetRight()->Accept(*this);
 
-		if (n->GetArrayType() == TokenType::IntArray)
-		{
-			variable.type = TokenType::Int;
-			variable.value = this->currentVariable.value;
-		}
-		else if (n->GetArrayType() == TokenType::FloatArray)
-		{
-			variable.type = TokenType::Float;
-			variable.value = this->currentVariable.value;
-		}
-		else if (n->GetArrayType() == TokenType::StringArray)
-		{
-			variable.type = TokenType::String;
-			variable.value = this->currentVariable.value;
-		}
-		else if (n->GetArrayType() == TokenType::BoolArray)
-		{
-			variable.type = TokenType::Bool;
-			variable.value = this->currentVariable.value;
-		}
+	BinaryOperation operation = n.GetTypedOperation();
+	if (operation == nullptr)
+	{
+		operation = Quicken(n.GetInlineCache(), n.GetOperant(), leftVariable, this->currentVariable, SpecializeComparison);
+	}
 
-		values.push_back(variable);
+	if (operation != nullptr)
+	{
+		operation(leftVariable, this->currentVariable, this->currentVariable);
+		return;
 	}
 
-	this->scopes.back()->DeclareVariable(n->GetName(), n->GetArrayType(), values);
+	Value rightVariable = std::move(this->currentVariable);
+
+	this->currentVariable = Value(leftVariable.Compare(n.GetOperant(), rightVariable));
 }
 
-void Interpreter::Visit(const Ref<VariableArrayUsageNode>& n)
+void Interpreter::Visit(VariableArrayDeclarationAssignNode& n)
 {
-	auto scope = FindScopeOfVariable(n->GetName());
+	std::vector<Value> values;
+	TokenType elementType = GetArrayElementType(n.GetArrayType());
 
-	if (scope != nullptr)
+	for (auto& value : n.GetValues())
 	{
-		auto a = scope->GetVariable(n->GetName());
+		value->Accept(*this);
 
-		auto arrayVar = std::any_cast<std::vector<VariableType>>(scope->GetVariable(n->GetName())->value);
-		if (n->GetIndex() > arrayVar.size() - 1)
+		if (this->currentVariable.GetType() != elementType)
 		{
-			Exit(n->GetFileName(), n->GetLine(), "Array index %i is higher than the max array index of %i", n->GetIndex(), arrayVar.size() - 1);
+			Exit(n.GetFileName(), n.GetLine(), "Values of array variable '%s' need to be of type '%s', but one is '%s'",
+				n.GetName().c_str(), Helper::ToString(elementType).c_str(), Helper::ToString(this->currentVariable.GetType()).c_str());
 		}
 
-		this->currentVariable = std::move(arrayVar.at(n->GetIndex()));
+		values.push_back(std::move(this->currentVariable));
 	}
-	else
+
+	DeclareVariable(n.GetSlot(), Value(n.GetArrayType(), std::move(values)));
+}
+
+void Interpreter::Visit(VariableArrayUsageNode& n)
+{
+	const Value& arrayVar = GetVariable(n);
+	if (n.GetIndex() >= arrayVar.GetArraySize())
 	{
-		Exit(n->GetFileName(), n->GetLine(), "Variable '%s' not declared", n->GetName().c_str());
+		Exit(n.GetFileName(), n.GetLine(), "Array index %i is higher than the max array index of %i", n.GetIndex(), arrayVar.GetArraySize() - 1);
 	}
+
+	this->currentVariable = arrayVar.GetArrayElement(n.GetIndex());
 }
 
-void Interpreter::Visit(const Ref<VariableArrayAssignNode>& n)
+void Interpreter::Visit(VariableArrayAssignNode& n)
 {
-	auto innerScope = FindScopeOfVariable(n->GetName());
-
-	n->GetExpression()->Accept(shared_from_this());
+	n.GetExpression()->Accept(*this);
 
-	auto variable = innerScope->GetVariable(n->GetName());
+	Value& variable = GetVariable(n);
 
-	auto arrayValues = std::any_cast<std::vector<VariableType>>(variable->value);
-	// TODO: Acces at zero without check is ok at the moment, because 
-	// we cannot have empty arrays -> but this might change
-	if (this->currentVariable.type != arrayValues.at(0).type)
+	if (this->currentVariable.GetType() != GetArrayElementType(variable.GetType()))
 	{
-		Exit(n->GetFileName(), n->GetLine(), "New value of array variable '%s' needs to be of type '%s', but is '%s'",
-			n->GetName().c_str(), Helper::ToString(variable->type).c_str(), Helper::ToString(this->currentVariable.type).c_str());
+		Exit(n.GetFileName(), n.GetLine(), "New value of array variable '%s' needs to be of type '%s', but is '%s'",
+			n.GetName().c_str(), Helper::ToString(variable.GetType()).c_str(), Helper::ToString(this->currentVariable.GetType()).c_str());
 	}
 
-	if (n->GetIndex() > arrayValues.size() - 1)
+	if (n.GetIndex() >= variable.GetArraySize())
 	{
-		Exit(n->GetFileName(), n->GetLine(), "Array index %i is higher than the max array index of %i", n->GetIndex(), arrayValues.size() - 1);
+		Exit(n.GetFileName(), n.GetLine(), "Array index %i is higher than the max array index of %i", n.GetIndex(), variable.GetArraySize() - 1);
 	}
 
-	innerScope->UpdateVariable(n->GetName(), n->GetIndex(), this->currentVariable);
+	// Write the element in place instead of copying the whole array
+	variable.SetArrayElement(n.GetIndex(), this->currentVariable);
 }
 
-void Interpreter::Visit(const Ref<IfNode>& n)
+void Interpreter::Visit(IfNode& n)
 {
-	n->GetExpression()->Accept(shared_from_this());
+	n.GetExpression()->Accept(*this);
 
-	if (this->currentVariable.type != TokenType::Bool)
+	if (this->currentVariable.GetType() != TokenType::Bool)
 	{
-		Exit(n->GetFileName(), n->GetLine(), "Expression from an if needs to be a boolean result");
+		Exit(n.GetFileName(), n.GetLine(), "Expression from an if needs to be a boolean result");
 	}
 
-	if (std::any_cast<bool>(this->currentVariable.value))
+	if (this->currentVariable.GetBool())
 	{
-		n->GetTrueBlock()->Accept(shared_from_this());
+		n.GetTrueBlock()->Accept(*this);
 	}
 	else
 	{
 		bool elseIfBlockExecuted = false;
-		for (const auto& [expression, block] : n->GetElseIfBlocks())
+		for (const auto& [expression, block] : n.GetElseIfBlocks())
 		{
-			expression->Accept(shared_from_this());
+			expression->Accept(*this);
 
-			if (std::any_cast<bool>(this->currentVariable.value))
+			if (this->currentVariable.GetBool())
 			{
-				block->Accept(shared_from_this());
+				block->Accept(*this);
 
 				elseIfBlockExecuted = true;
 				break;
 			}
 		}
 
-		if (!elseIfBlockExecuted && n->GetElseBlock() != nullptr)
+		if (!elseIfBlockExecuted && n.GetElseBlock() != nullptr)
 		{
-			n->GetElseBlock()->Accept(shared_from_this());
+			n.GetElseBlock()->Accept(*this);
 		}
 	}
 }
 
-void Interpreter::Visit(const Ref<WhileNode>& n)
+void Interpreter::Visit(WhileNode& n)
 {
-	n->GetExpression()->Accept(shared_from_this());
+	n.GetExpression()->Accept(*this);
 
-	if (this->currentVariable.type != TokenType::Bool)
+	if (this->currentVariable.GetType() != TokenType::Bool)
 	{
-		Exit(n->GetFileName(), n->GetLine(), "Expression from a while needs to be a boolean result");
+		Exit(n.GetFileName(), n.GetLine(), "Expression from a while needs to be a boolean result");
 	}
 
-	this->scopes.push_back(std::make_shared<InterpreterScope>());
-
-	while (std::any_cast<bool>(this->currentVariable.value))
+	while (this->currentVariable.GetBool())
 	{
-		n->GetBlock()->Accept(shared_from_this());
+		n.GetBlock()->Accept(*this);
 
-		n->GetExpression()->Accept(shared_from_this());
-	}
+		if (this->returning)
+		{
+			return;
+		}
 
-	this->scopes.pop_back();
+		n.GetExpression()->Accept(*this);
+	}
 }
 
-void Interpreter::Visit(const Ref<DoWhileNode>& n)
+void Interpreter::Visit(DoWhileNode& n)
 {
 	do
 	{
-		n->GetBlock()->Accept(shared_from_this());
+		n.GetBlock()->Accept(*this);
 
-		n->GetExpression()->Accept(shared_from_this());
+		if (this->returning)
+		{
+			return;
+		}
+
+		n.GetExpression()->Accept(*this);
 
-		if (this->currentVariable.type != TokenType::Bool)
+		if (this->currentVariable.GetType() != TokenType::Bool)
 		{
-			Exit(n->GetFileName(), n->GetLine(), "Expression from a do while needs to be a boolean result");
+			Exit(n.GetFileName(), n.GetLine(), "Expression from a do while needs to be a boolean result");
 		}
-	} while (std::any_cast<bool>(this->currentVariable.value));
+	} while (this->currentVariable.GetBool());
 }
 
-void Interpreter::Visit(const Ref<ReturnNode>& n)
+void Interpreter::Visit(ReturnNode& n)
 {
-	n->GetExpression()->Accept(shared_from_this());
-}
+	if (FunctionCallNode* call = n.GetTailCall())
+	{
+		// The call is executed by the caller of this function after the blocks and loops are left.
+		// Calls inside the arguments return normally, so the tail call is only set once they are evaluated.
+		size_t arguments = PushArguments(*call, *call->GetFunction());
+		this->tailCall = call->GetFunction();
+		this->tailCallArguments = arguments;
+		this->returning = true;
+		return;
+	}
+
+	n.GetExpression()->Accept(*this);
+
+	// The value stays in the current variable while the enclosing blocks and loops are left
+	this->returning = true;
+}
\ No newline at end of file
@@ -7,84 +7,150 @@
 
 #include "Lexer.h"
 
-#include <iostream>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <limits>
 #include <Core.h>
+#include "FileTable.h"
+#include "Scanner.h"
 
-Lexer::Lexer(std::string  input, std::string  fileName)
-	: input(std::move(input)), fileName(std::move(fileName)), pos(0), line(1)
+struct Keyword
 {
-	this->currentChar = this->input.at(this->pos);
-	this->reservedKeywords.insert(std::pair<std::string, Token>("func", Token(Function, "func", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("return", Token(Return, "return", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("int", Token(Int, "int", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("var", Token(Var, "var", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("true", Token(Bool, "true", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("false", Token(Bool, "false", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("for", Token(For, "for", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("in", Token(In, "in", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("step", Token(Step, "step", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("while", Token(While, "while", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("do", Token(Do, "do", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("if", Token(If, "if", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("else", Token(Else, "else", this->fileName)));
-	this->reservedKeywords.insert(std::pair<std::string, Token>("when", Token(When, "when", this->fileName)));
+	std::string_view name;
+	TokenType tokenType = None;
+};
+
+static constexpr Keyword Keywords[] = {
+	{ "func", Function }, { "return", Return }, { "int", Int }, { "var", Var }, { "true", Bool }, { "false", Bool },
+	{ "for", For }, { "in", In }, { "step", Step }, { "while", While }, { "do", Do }, { "if", If }, { "else", Else },
+	{ "when", When }
+};
+
+// Keywords are found with a perfect hash of the length, the first and the last character of a name.
+// The table is built at compile time, a keyword which would share a slot with another one fails the build.
+static constexpr size_t KeywordSlots = 32;
+
+static constexpr size_t KeywordHash(std::string_view name)
+{
+	return (name.size() + (unsigned char) name.front() + (unsigned char) name.back()) & (KeywordSlots - 1);
 }
 
-void Lexer::Advance()
+static constexpr std::array<Keyword, KeywordSlots> BuildKeywordTable()
 {
-	this->pos++;
-	if (this->pos > this->input.length() - 1)
+	std::array<Keyword, KeywordSlots> table = { };
+	for (const auto& keyword : Keywords)
 	{
-		this->currentChar = EOF;
+		table[KeywordHash(keyword.name)] = keyword;
 	}
-	else
+
+	return table;
+}
+
+static constexpr std::array<Keyword, KeywordSlots> KeywordTable = BuildKeywordTable();
+
+static constexpr bool IsPerfectKeywordHash()
+{
+	for (const auto& keyword : Keywords)
 	{
-		this->currentChar = this->input.at(this->pos);
+		if (KeywordTable[KeywordHash(keyword.name)].name != keyword.name)
+		{
+			return false;
+		}
 	}
+
+	return true;
+}
+
+static_assert(IsPerfectKeywordHash(), "Two keywords have the same hash, change KeywordHash or KeywordSlots");
+
+// The character classes of the source are ascii only, unlike the ones of <cctype> they do not depend on the locale.
+// They only check the first char of a token, the Scanner finds where its run ends.
+static bool IsAlpha(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static bool IsDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static bool IsSpace(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+Lexer::Lexer(std::string_view input, const std::string& fileName)
+	: Lexer(input, FileTable::Intern(fileName))
+{
+}
+
+Lexer::Lexer(std::string_view input, uint32_t fileId, int line)
+	: input(input), fileId(fileId), pos(0), line(line)
+{
+	this->currentChar = this->input.empty() ? EOF : this->input[0];
+}
+
+const std::string& Lexer::GetFileName() const
+{
+	return FileTable::GetName(this->fileId);
 }
 
-char Lexer::Peek()
+void Lexer::Advance()
+{
+	this->pos++;
+	this->currentChar = this->pos < this->input.size() ? this->input[this->pos] : EOF;
+}
+
+void Lexer::Seek(size_t position)
 {
-	int peekPos = pos + 1;
-	if (peekPos > this->input.length() - 1)
+	this->pos = position;
+	this->currentChar = this->pos < this->input.size() ? this->input[this->pos] : EOF;
+}
+
+char Lexer::Peek() const
+{
+	return this->pos + 1 < this->input.size() ? this->input[this->pos + 1] : EOF;
+}
+
+size_t Lexer::SkipBlockComment(size_t position)
+{
+	size_t end = Scanner::Find(this->input, position + 2, '*');
+	while (end + 1 < this->input.size() && this->input[end + 1] != '/')
 	{
-		return EOF;
+		end = Scanner::Find(this->input, end + 1, '*');
 	}
-	else
+
+	if (end + 1 >= this->input.size())
 	{
-		return this->input.at(peekPos);
+		Exit(GetFileName(), this->line, "Block comment is not closed");
 	}
+
+	size_t commentEnd = end + 2;
+	this->line += (int) std::count(this->input.begin() + position, this->input.begin() + commentEnd, '\n');
+
+	return commentEnd;
 }
 
 Token Lexer::HandleReserved()
 {
-	std::stringstream result;
-
-	while (this->currentChar != EOF && (std::isalpha(this->currentChar) || this->currentChar == '_'))
-	{
-		result << this->currentChar;
-		Advance();
-	}
+	size_t start = this->pos;
+	size_t end = Scanner::Skip(this->input, start, CharRun::Name);
+	Seek(end);
 
-	std::string possibleKeywordString = result.str();
+	std::string_view name = this->input.substr(start, end - start);
 
-	auto possibleKeyword = this->reservedKeywords.find(possibleKeywordString);
-	if (possibleKeyword == this->reservedKeywords.end())
+	const Keyword& keyword = KeywordTable[KeywordHash(name)];
+	if (keyword.name == name)
 	{
-		// Check if we got a function call (also used for function declaration)
-		if (this->currentChar == '(')
-		{
-			return Token(Call, possibleKeywordString, this->fileName, this->line);
-		}
-		else
-		{
-			return Token(Name, possibleKeywordString, this->fileName, this->line);
-		}
+		return Token(keyword.tokenType, name, this->fileId, this->line);
 	}
 
-	possibleKeyword->second.SetLine(this->line);
-
-	return possibleKeyword->second;
+	// Check if we got a function call (also used for function declaration)
+	return Token(this->currentChar == '(' ? Call : Name, name, this->fileId, this->line);
 }
 
 Token Lexer::NextToken()
@@ -93,41 +159,22 @@ Token Lexer::NextToken()
 	{
 		if (this->currentChar == '/' && Peek() == '/')
 		{
-			Advance();
-			Advance();
+			Seek(Scanner::Find(this->input, this->pos + 2, '\n'));
 
-			while (this->currentChar != EOF && this->currentChar != '\n')
-			{
-				Advance();
-			}
+			// The comment may end the input, which has no new line at its end
+			continue;
 		}
 
 		if (this->currentChar == '/' && Peek() == '*')
 		{
-			Advance();
-			Advance();
-
-			while (this->currentChar != EOF && (this->currentChar != '*' && Peek() != '/'))
-			{
-				Advance();
-			}
-
-			Advance();
-			Advance();
+			Seek(SkipBlockComment(this->pos));
+			continue;
 		}
 
 		// Whitespace
-		if (std::isspace(this->currentChar))
+		if (IsSpace(this->currentChar))
 		{
-			while (this->currentChar != EOF && std::isspace(this->currentChar))
-			{
-                if (this->currentChar == '\n')
-                {
-                    line++;
-                }
-
-				Advance();
-			}
+			Seek(Scanner::SkipSpaces(this->input, this->pos, this->line));
 
 			// Go to top checks so comments etc. are detected after spaces/new lines
 			continue;
@@ -137,177 +184,261 @@ Token Lexer::NextToken()
 		if (this->currentChar == ';')
 		{
 			Advance();
+			continue;
 		}
 
-		if (std::isalpha(this->currentChar))
+		if (IsAlpha(this->currentChar))
 		{
 			return HandleReserved();
 		}
 
-		if (std::isdigit(this->currentChar) || (this->currentChar == '-' && std::isdigit(this->Peek())))
+		if (IsDigit(this->currentChar) || (this->currentChar == '-' && IsDigit(this->Peek())))
 		{
-			std::stringstream number;
+			size_t start = this->pos;
 			bool hasFloatPoint = false;
 
 			if (this->currentChar == '-')
 			{
-				number << this->currentChar;
+				Advance();
+			}
+
+			Seek(Scanner::Skip(this->input, this->pos, CharRun::Digits));
 
+			// A point followed by another one is a range (eg. 0..10) and not part of the number
+			if (this->currentChar == '.' && this->Peek() != '.')
+			{
+				hasFloatPoint = true;
 				Advance();
+				Seek(Scanner::Skip(this->input, this->pos, CharRun::Digits));
 			}
 
-			while (this->currentChar != EOF && (std::isdigit(this->currentChar) || this->currentChar == '.'))
+			size_t end = this->pos;
+
+			// Longs and doubles are written with a suffix (eg. 5L or 0.1D)
+			char suffix = 0;
+			if ((this->currentChar == 'L' || this->currentChar == 'D') && !IsAlpha(this->Peek()))
 			{
-				number << this->currentChar;
+				suffix = this->currentChar;
 				Advance();
+			}
 
-				if (this->currentChar == '.' && !hasFloatPoint)
-				{
-					if (this->Peek() == '.')
-					{
-						break;
-					}
+			std::string_view number = this->input.substr(start, end - start);
+			std::string_view text = this->input.substr(start, end - start + (suffix != 0));
 
-					hasFloatPoint = true;
-				}
-				else if (this->currentChar == '.' && hasFloatPoint)
+			// A second point (eg. 1.2.3) is a mistake and not silently dropped, two are still a range
+			if (this->currentChar == '.' && hasFloatPoint && this->Peek() != '.')
+			{
+				Exit(GetFileName(), this->line, "Float literal %s. has more than one point", std::string(text).c_str());
+			}
+			if (!hasFloatPoint && suffix != 'D')
+			{
+				int64_t value = 0;
+				if (std::from_chars(number.data(), number.data() + number.size(), value).ec != std::errc())
 				{
-					// TODO: Show an error message or just remove it silently?
-					Advance();
-					break;
+					Exit(GetFileName(), this->line, "Int literal %s does not fit into 64 bits", std::string(text).c_str());
 				}
+
+				// Ints which do not fit into 32 bits are longs
+				bool isLong = suffix == 'L' || value < std::numeric_limits<int32_t>::min() || value > std::numeric_limits<int32_t>::max();
+
+				return Token(isLong ? Long : Int, text, value, this->fileId, this->line);
+			}
+
+			if (suffix == 'L')
+			{
+				Exit(GetFileName(), this->line, "Float literal %s can not be a long", std::string(text).c_str());
+			}
+
+			double value = 0;
+			if (std::from_chars(number.data(), number.data() + number.size(), value).ec != std::errc())
+			{
+				Exit(GetFileName(), this->line, "Float literal %s does not fit into 64 bits", std::string(text).c_str());
 			}
 
-			TokenType intOrFloat = !hasFloatPoint ? TokenType::Int : TokenType::Float;
+			// Floats which are out of the range of 32 bits are doubles
+			bool isDouble = suffix == 'D' || std::abs(value) > std::numeric_limits<float>::max();
 
-			return Token(intOrFloat, number.str(), this->fileName, this->line);
+			return Token(isDouble ? Double : Float, text, value, this->fileId, this->line);
 		}
 
 		switch (this->currentChar)
 		{
 			case '.':
 				Advance();
-				return Token(Point, ".", this->fileName, this->line);
+				return Token(Point, ".", this->fileId, this->line);
 			case ':':
 				Advance();
-				return Token(Colon, ":", this->fileName, this->line);
+				return Token(Colon, ":", this->fileId, this->line);
 			case '(':
 				Advance();
-				return Token(ParanLeft, "(", this->fileName, this->line);
+				return Token(ParanLeft, "(", this->fileId, this->line);
 			case ')':
 				Advance();
-				return Token(ParanRight, ")", this->fileName, this->line);
+				return Token(ParanRight, ")", this->fileId, this->line);
 			case '{':
 				Advance();
-				return Token(CurlyLeft, "{", this->fileName, this->line);
+				return Token(CurlyLeft, "{", this->fileId, this->line);
 			case '}':
 				Advance();
-				return Token(CurlyRight, "}", this->fileName, this->line);
+				return Token(CurlyRight, "}", this->fileId, this->line);
 			case '[':
 				Advance();
-				return Token(SquareLeft, "[", this->fileName, this->line);
+				return Token(SquareLeft, "[", this->fileId, this->line);
 			case ']':
 				Advance();
-				return Token(SquareRight, "]", this->fileName, this->line);
+				return Token(SquareRight, "]", this->fileId, this->line);
 			case '>':
 				if (Peek() != '=')
 				{
 					Advance();
-					return Token(GreaterThan, ">", this->fileName, this->line);
+					return Token(GreaterThan, ">", this->fileId, this->line);
 				}
 
 				Advance();
 				Advance();
 
-				return Token(GreaterEqualThan, ">=", this->fileName, this->line);
+				return Token(GreaterEqualThan, ">=", this->fileId, this->line);
 			case '<':
 				if (Peek() != '=')
 				{
 					Advance();
-					return Token(LessThan, "<", this->fileName, this->line);
+					return Token(LessThan, "<", this->fileId, this->line);
 				}
 
 				Advance();
 				Advance();
 
-				return Token(LessEqualThan, "<=", this->fileName, this->line);
+				return Token(LessEqualThan, "<=", this->fileId, this->line);
 			case '=':
 				if (Peek() == '>')
 				{
 					Advance();
 					Advance();
-					return Token(Arrow, "=>", this->fileName, this->line);
+					return Token(Arrow, "=>", this->fileId, this->line);
 				}
 				else if (Peek() != '=')
 				{
 					Advance();
-					return Token(Assign, "=", this->fileName, this->line);
+					return Token(Assign, "=", this->fileId, this->line);
 				}
 
 				Advance();
 				Advance();
 
-				return Token(Equals, "==", this->fileName, this->line);
+				return Token(Equals, "==", this->fileId, this->line);
 			case '!':
 				if (Peek() == '=')
 				{
 					Advance();
 					Advance();
-					return Token(NotEquals, "!=", this->fileName, this->line);
+					return Token(NotEquals, "!=", this->fileId, this->line);
 				}
 
 				Advance();
 
-				return Token(ExclamationMark, "!", this->fileName, this->line);
+				return Token(ExclamationMark, "!", this->fileId, this->line);
 			case '+':
 				if (Peek() == '+')
 				{
 					Advance();
 					Advance();
-					return Token(PlusPlus, "++", this->fileName, this->line);
+					return Token(PlusPlus, "++", this->fileId, this->line);
 				}
 
 				Advance();
-				return Token(Plus, "+", this->fileName, this->line);
+				return Token(Plus, "+", this->fileId, this->line);
 			case '-':
 				if (Peek() == '-')
 				{
 					Advance();
 					Advance();
-					return Token(MinusMinus, "--", this->fileName, this->line);
+					return Token(MinusMinus, "--", this->fileId, this->line);
 				}
 
 				Advance();
-				return Token(Minus, "-", this->fileName, this->line);
+				return Token(Minus, "-", this->fileId, this->line);
 			case '*':
 				Advance();
-				return Token(Multiply, "*", this->fileName, this->line);
+				return Token(Multiply, "*", this->fileId, this->line);
 			case '/':
 				Advance();
-				return Token(Divide, "/", this->fileName, this->line);
+				return Token(Divide, "/", this->fileId, this->line);
 			case ',':
 				Advance();
-				return Token(Comma, ",", this->fileName, this->line);
+				return Token(Comma, ",", this->fileId, this->line);
 			case '"':
 			{
 				Advance();
 
-				std::stringstream string;
-				while (this->currentChar != EOF && this->currentChar != '"')
-				{
-					string << this->currentChar;
-					Advance();
-				}
+				size_t start = this->pos;
+				Seek(Scanner::Find(this->input, start, '"'));
+
+				std::string_view string = this->input.substr(start, this->pos - start);
 
 				Advance();
 
-				return Token(String, string.str(), this->fileName, this->line);
+				return Token(String, string, this->fileId, this->line);
 			}
 			default:
-				Exit(this->fileName, this->line, "Invalid character '%c'", this->currentChar);
+				Exit(GetFileName(), this->line, "Invalid character '%c'", this->currentChar);
+				break;
+		}
+	}
+
+	return Token(None, "NONE", this->fileId, this->line);
+}
+
+bool Lexer::SkipBlock()
+{
+	size_t position = this->pos;
+	int depth = 1;
+
+	while (position < this->input.size())
+	{
+		switch (this->input[position])
+		{
+			case '\n':
+				this->line++;
+				position++;
+				break;
+			case '{':
+				depth++;
+				position++;
+				break;
+			case '}':
+				position++;
+
+				if (--depth == 0)
+				{
+					Seek(position);
+					return true;
+				}
+				break;
+			case '"':
+				// Like string tokens, which do not count the new lines in them
+				position = Scanner::Find(this->input, position + 1, '"') + 1;
+				break;
+			case '/':
+				if (position + 1 < this->input.size() && this->input[position + 1] == '/')
+				{
+					position = Scanner::Find(this->input, position + 2, '\n');
+				}
+				else if (position + 1 < this->input.size() && this->input[position + 1] == '*')
+				{
+					position = SkipBlockComment(position);
+				}
+				else
+				{
+					position++;
+				}
+				break;
+			default:
+				position++;
 				break;
 		}
 	}
 
-	return Token(None, "NONE", this->fileName, this->line);
-}
\ No newline at end of file
+	Seek(this->input.size());
+
+	return false;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "MappedFile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define IONA_MMAP_SUPPORTED
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+MappedFile::MappedFile(const std::string& fileName)
+{
+#ifdef IONA_MMAP_SUPPORTED
+	int descriptor = open(fileName.c_str(), O_RDONLY);
+	if (descriptor == -1)
+	{
+		return;
+	}
+
+	struct stat status = { };
+	if (fstat(descriptor, &status) == 0)
+	{
+		// Empty files can not be mapped
+		this->size = (size_t) status.st_size;
+		if (this->size == 0)
+		{
+			this->valid = true;
+		}
+		else
+		{
+			void* mapped = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (mapped != MAP_FAILED)
+			{
+				this->address = mapped;
+				this->valid = true;
+			}
+		}
+	}
+	close(descriptor);
+#else
+	std::ifstream file(fileName, std::ios::binary);
+	if (file)
+	{
+		this->buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		this->size = this->buffer.size();
+		this->valid = !file.bad();
+	}
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef IONA_MMAP_SUPPORTED
+	if (this->address != nullptr)
+	{
+		munmap(this->address, this->size);
+	}
+#endif
+}
+
+std::string_view MappedFile::GetContent() const
+{
+	if (this->address != nullptr)
+	{
+		return std::string_view(static_cast<const char*>(this->address), this->size);
+	}
+
+	return this->buffer;
+}
@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "Optimizer.h"
+#include "Standard.h"
+#include <chrono>
+#include <limits>
+
+// Integer divisions by zero and of the minimum by -1 trap
+template <typename T>
+static bool IsTrappingDivision(T left, T right)
+{
+	return right == 0 || (left == std::numeric_limits<T>::min() && right == -1);
+}
+
+// Ints and longs wrap around at runtime, the optimizer leaves overflowing expressions to it
+template <typename T>
+static bool IsOverflowing(TokenType operant, T left, T right)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	T result;
+	switch (operant)
+	{
+		case TokenType::Plus:
+			return __builtin_add_overflow(left, right, &result);
+		case TokenType::Minus:
+			return __builtin_sub_overflow(left, right, &result);
+		case TokenType::Multiply:
+			return __builtin_mul_overflow(left, right, &result);
+		default:
+			return false;
+	}
+#else
+	// Without the overflow builtins only divisions are folded
+	return operant != TokenType::Divide;
+#endif
+}
+
+Optimizer::Optimizer(const Ref<Node>& astRoot, const Ref<AstArena>& arena)
+	: Visitor(astRoot), arena(arena)
+{
+}
+
+void Optimizer::Optimize()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	this->astRoot->Accept(*this);
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	IONA_LOG("\n\nOptimizing took %llims (%llius)\n",
+		(long long) std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(),
+		(long long) std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+}
+
+void Optimizer::OptimizeFunction(FunctionNode& function)
+{
+	Fold(&function);
+}
+
+Node* Optimizer::Fold(Node* node)
+{
+	node->Accept(*this);
+
+	return this->replacement;
+}
+
+bool Optimizer::IsConstant(Node* node, Value& value)
+{
+	if (auto intNode = dynamic_cast<IntNode*>(node))
+	{
+		value = Value(intNode->GetValue());
+	}
+	else if (auto floatNode = dynamic_cast<FloatNode*>(node))
+	{
+		value = Value(floatNode->GetValue());
+	}
+	else if (auto longNode = dynamic_cast<LongNode*>(node))
+	{
+		value = Value(longNode->GetValue());
+	}
+	else if (auto doubleNode = dynamic_cast<DoubleNode*>(node))
+	{
+		value = Value(doubleNode->GetValue());
+	}
+	else if (auto boolNode = dynamic_cast<BoolNode*>(node))
+	{
+		value = Value(boolNode->GetValue());
+	}
+	// Strings are only constant without interpolated expressions
+	else if (auto stringNode = dynamic_cast<StringNode*>(node); stringNode != nullptr && stringNode->GetExpressions().empty())
+	{
+		value = Value(stringNode->GetValue());
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+Node* Optimizer::NewLiteral(const Node& origin, const Value& value)
+{
+	switch (value.GetType())
+	{
+		case TokenType::Int:
+			return this->arena->New<IntNode>(value.GetInt());
+		case TokenType::Float:
+			return this->arena->New<FloatNode>(value.GetFloat());
+		case TokenType::Long:
+			return this->arena->New<LongNode>(value.GetLong());
+		case TokenType::Double:
+			return this->arena->New<DoubleNode>(value.GetDouble());
+		case TokenType::Bool:
+			return this->arena->New<BoolNode>(value.GetBool());
+		case TokenType::String:
+			return this->arena->New<StringNode>(origin.GetFileId(), origin.GetLine(), value.GetString(), NodeList<Node*>());
+		default:
+			// Arrays and missing values have no literal
+			return nullptr;
+	}
+}
+
+void Optimizer::Visit(MainNode& n)
+{
+	for (const auto& globalVariable : n.GetGlobalVariables())
+	{
+		Fold(globalVariable);
+	}
+
+	for (const auto& globalFunction : n.GetGlobalFunctions())
+	{
+		Fold(globalFunction);
+	}
+
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(VariableDeclarationAssignNode& n)
+{
+	n.SetExpression(Fold(n.GetExpression()));
+
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(VariableArrayDeclarationAssignNode& n)
+{
+	for (auto& value : n.GetValues())
+	{
+		value = Fold(value);
+	}
+
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(FunctionNode& n)
+{
+	// The body of a lazily parsed function is optimized once it is analyzed
+	if (n.IsParsed())
+	{
+		Fold(n.GetBlock());
+	}
+
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(FunctionCallNode& n)
+{
+	std::vector<Value> in;
+	in.reserve(n.GetParameters().size());
+	bool constant = true;
+
+	for (auto& parameter : n.GetParameters())
+	{
+		parameter = Fold(parameter);
+
+		Value value;
+		constant = constant && IsConstant(parameter, value);
+		in.push_back(std::move(value));
+	}
+
+	this->replacement = &n;
+
+	// Calls of functions of the program are never bound to an internal function
+	const FunctionEntry* entry = n.GetInternalFunction();
+	if (!constant || entry == nullptr)
+	{
+		return;
+	}
+
+	// Calls with wrong parameters are kept, so they still fail at runtime
+	if (!entry->pure || !FunctionRegistry::Accepts(*entry, in))
+	{
+		return;
+	}
+
+	Value out;
+	entry->function(in, out);
+
+	if (Node* literal = NewLiteral(n, out))
+	{
+		this->replacement = literal;
+	}
+}
+
+void Optimizer::Visit(ForEachNode& n)
+{
+	n.SetExpression(Fold(n.GetExpression()));
+	Fold(n.GetBlock());
+
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(ForINode& n)
+{
+	Fold(n.GetBlock());
+
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(BlockNode& n)
+{
+	std::vector<Node*> statements;
+	statements.reserve(n.GetStatements().size());
+	bool changed = false;
+
+	for (const auto& statement : n.GetStatements())
+	{
+		Node* folded = Fold(statement);
+
+		if (folded != nullptr)
+		{
+			statements.push_back(folded);
+		}
+
+		changed = changed || folded != statement;
+	}
+
+	if (changed)
+	{
+		n.SetStatements(this->arena->NewList(statements));
+	}
+
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(BinaryNode& n)
+{
+	n.SetLeft(Fold(n.GetLeft()));
+	n.SetRight(Fold(n.GetRight()));
+
+	this->replacement = &n;
+
+	Value left;
+	Value right;
+	if (!IsConstant(n.GetLeft(), left) || !IsConstant(n.GetRight(), right))
+	{
+		return;
+	}
+
+	// Would trap at runtime, so leave it there
+	if (n.GetOperant() == TokenType::Divide && left.GetType() == right.GetType()
+		&& ((left.GetType() == TokenType::Int && IsTrappingDivision(left.GetInt(), right.GetInt()))
+			|| (left.GetType() == TokenType::Long && IsTrappingDivision(left.GetLong(), right.GetLong()))))
+	{
+		return;
+	}
+
+	if (left.GetType() == right.GetType()
+		&& ((left.GetType() == TokenType::Int && IsOverflowing(n.GetOperant(), left.GetInt(), right.GetInt()))
+			|| (left.GetType() == TokenType::Long && IsOverflowing(n.GetOperant(), left.GetLong(), right.GetLong()))))
+	{
+		return;
+	}
+
+	Value result;
+
+	if (left.GetType() == TokenType::String && right.GetType() == TokenType::String && n.GetOperant() == TokenType::Plus)
+	{
+		result = Value(left.GetString() + right.GetString());
+	}
+	else
+	{
+		result = left.Arithmetic(n.GetOperant(), right);
+	}
+
+	// Mixed types and invalid string operators have no result here, the interpreter handles them
+	if (Node* literal = NewLiteral(n, result))
+	{
+		this->replacement = literal;
+	}
+}
+
+void Optimizer::Visit(BooleanNode& n)
+{
+	n.SetLeft(Fold(n.GetLeft()));
+	n.SetRight(Fold(n.GetRight()));
+
+	this->replacement = &n;
+
+	Value left;
+	Value right;
+	if (IsConstant(n.GetLeft(), left) && IsConstant(n.GetRight(), right))
+	{
+		this->replacement = NewLiteral(n, Value(left.Compare(n.GetOperant(), right)));
+	}
+}
+
+void Optimizer::Visit(IfNode& n)
+{
+	n.SetExpression(Fold(n.GetExpression()));
+	Fold(n.GetTrueBlock());
+
+	for (auto& [expression, block] : n.GetElseIfBlocks())
+	{
+		expression = Fold(expression);
+		Fold(block);
+	}
+
+	if (n.GetElseBlock() != nullptr)
+	{
+		Fold(n.GetElseBlock());
+	}
+
+	// Only bool constants decide a branch, other types are an error at runtime
+	auto isConstantBool = [](Node* expression, bool& result)
+	{
+		Value value;
+		if (IsConstant(expression, value) && value.GetType() == TokenType::Bool)
+		{
+			result = value.GetBool();
+			return true;
+		}
+
+		return false;
+	};
+
+	bool result = false;
+	std::vector<std::pair<Node*, Node*>> branches;
+	Node* elseBlock = n.GetElseBlock();
+
+	if (isConstantBool(n.GetExpression(), result))
+	{
+		if (result)
+		{
+			this->replacement = n.GetTrueBlock();
+			return;
+		}
+	}
+	else
+	{
+		branches.emplace_back(n.GetExpression(), n.GetTrueBlock());
+	}
+
+	for (const auto& [expression, block] : n.GetElseIfBlocks())
+	{
+		if (!isConstantBool(expression, result))
+		{
+			branches.emplace_back(expression, block);
+		}
+		// All following branches are unreachable
+		else if (result)
+		{
+			elseBlock = block;
+			break;
+		}
+	}
+
+	if (branches.empty())
+	{
+		// Without an else block the whole statement is removed
+		this->replacement = elseBlock;
+	}
+	else if (branches.size() == n.GetElseIfBlocks().size() + 1 && elseBlock == n.GetElseBlock())
+	{
+		this->replacement = &n;
+	}
+	else
+	{
+		Node* expression = branches.front().first;
+		Node* trueBlock = branches.front().second;
+		branches.erase(branches.begin());
+
+		this->replacement = this->arena->New<IfNode>(n.GetFileId(), n.GetLine(), expression, trueBlock, this->arena->NewList(branches), elseBlock);
+	}
+}
+
+void Optimizer::Visit(WhileNode& n)
+{
+	n.SetExpression(Fold(n.GetExpression()));
+	Fold(n.GetBlock());
+
+	this->replacement = &n;
+
+	Value value;
+	if (IsConstant(n.GetExpression(), value) && value.GetType() == TokenType::Bool && !value.GetBool())
+	{
+		this->replacement = nullptr;
+	}
+}
+
+void Optimizer::Visit(DoWhileNode& n)
+{
+	Fold(n.GetBlock());
+	n.SetExpression(Fold(n.GetExpression()));
+
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(StringNode& n)
+{
+	const std::string& value = n.GetValue();
+	std::string folded;
+	std::vector<Node*> expressions;
+	size_t position = 0;
+
+	// Constant expressions are written into the string, the others keep their placeholder
+	for (auto& expression : n.GetExpressions())
+	{
+		expression = Fold(expression);
+
+		size_t index = value.find("$R$", position);
+
+		Value constant;
+		if (IsConstant(expression, constant))
+		{
+			folded.append(value, position, index - position).append(Iona::ToStringInternal(constant));
+		}
+		else
+		{
+			folded.append(value, position, index + 3 - position);
+			expressions.push_back(expression);
+		}
+
+		position = index + 3;
+	}
+
+	if (expressions.size() == n.GetExpressions().size())
+	{
+		this->replacement = &n;
+		return;
+	}
+
+	folded.append(value, position, std::string::npos);
+
+	this->replacement = this->arena->New<StringNode>(n.GetFileId(), n.GetLine(), folded, this->arena->NewList(expressions));
+}
+
+void Optimizer::Visit(IntNode& n)
+{
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(FloatNode& n)
+{
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(LongNode& n)
+{
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(DoubleNode& n)
+{
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(BoolNode& n)
+{
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(VariableUsageNode& n)
+{
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(VariableAssignNode& n)
+{
+	n.SetExpression(Fold(n.GetExpression()));
+
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(VariableArrayUsageNode& n)
+{
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(VariableArrayAssignNode& n)
+{
+	n.SetExpression(Fold(n.GetExpression()));
+
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(VariableIncrementDecrementNode& n)
+{
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(VariableCompoundAssignNode& n)
+{
+	n.SetExpression(Fold(n.GetExpression()));
+
+	this->replacement = &n;
+}
+
+void Optimizer::Visit(ReturnNode& n)
+{
+	n.SetExpression(Fold(n.GetExpression()));
+
+	this->replacement = &n;
+}
@@ -6,6 +6,7 @@
  */
 
 #include "Parser.h"
+#include "FileTable.h"
 #include "Ast/MainNode.h"
 #include "Ast/VariableDeclarationAssignNode.h"
 #include "Ast/FunctionNode.h"
@@ -16,6 +17,8 @@
 #include "Ast/VariableUsageNode.h"
 #include "Ast/VariableAssignNode.h"
 #include "Ast/Literal/FloatNode.h"
+#include "Ast/Literal/LongNode.h"
+#include "Ast/Literal/DoubleNode.h"
 #include "Ast/Literal/BoolNode.h"
 #include "Ast/VariableArrayDeclarationAssignNode.h"
 #include "Ast/VariableArrayUsageNode.h"
@@ -31,7 +34,13 @@
 #include <Ast/DoWhileNode.h>
 
 Parser::Parser(Lexer& lexer)
-	: lexer(lexer), currentToken(lexer.NextToken())
+	: Parser(lexer, std::make_shared<AstArena>())
+{
+
+}
+
+Parser::Parser(Lexer& lexer, const Ref<AstArena>& arena)
+	: lexer(lexer), currentToken(lexer.NextToken()), arena(arena), fileId(lexer.GetFileId())
 {
 
 }
@@ -49,15 +58,37 @@ void Parser::Advance(TokenType tokenType)
 	}
 }
 
+int Parser::ParseInt()
+{
+	Token token = this->currentToken;
+	Advance(TokenType::Int);
+
+	return (int) token.GetInt();
+}
+
+float Parser::ParseFloat()
+{
+	Token token = this->currentToken;
+	Advance(TokenType::Float);
+
+	return (float) token.GetFloat();
+}
+
 Ref<Node> Parser::Parse()
 {
-	return ParseMainFile();
+	// The root shares the ownership of the arena, which keeps all other nodes alive
+	return Ref<Node>(this->arena, ParseMainFile());
 }
 
-Ref<Node> Parser::ParseMainFile()
+Ref<Node> Parser::Statement()
 {
-	std::vector<Ref<Node>> globalVariables;
-	std::vector<Ref<Node>> globalFunctions;
+	return Ref<Node>(this->arena, ParseStatement());
+}
+
+Node* Parser::ParseMainFile()
+{
+	std::vector<Node*> globalVariables;
+	std::vector<Node*> globalFunctions;
 
 	while (this->currentToken.GetTokenType() == TokenType::Var)
 	{
@@ -76,32 +107,32 @@ Ref<Node> Parser::ParseMainFile()
 	}
 
 	// Make sure a Main function exists and it's the first one
-	size_t mainFunctionIndex = -1;
+	size_t mainFunctionIndex = globalFunctions.size();
 	for (size_t i = 0; i < globalFunctions.size(); i++)
 	{
-		Ref<FunctionNode> fun = std::dynamic_pointer_cast<FunctionNode>(globalFunctions[i]);
+		FunctionNode* fun = static_cast<FunctionNode*>(globalFunctions[i]);
 		if (fun->GetName() == MainFunctionName)
 		{
 			mainFunctionIndex = i;
 		}
 	}
 
-	if (mainFunctionIndex == -1)
+	if (mainFunctionIndex == globalFunctions.size())
 	{
 		Exit(this->currentToken.GetFileName(), -1, "No 'Main' method found. Cannot execute program");
 	}
 
 	std::swap(globalFunctions[0], globalFunctions[mainFunctionIndex]);
 
-	return std::make_shared<MainNode>(globalVariables, globalFunctions);
+	return this->arena->New<MainNode>(this->arena->NewList(globalVariables), this->arena->NewList(globalFunctions));
 }
 
-Ref<Node> Parser::ParseGlobalVariables()
+Node* Parser::ParseGlobalVariables()
 {
 	int varLine = this->currentToken.GetLine();
 	Advance(TokenType::Var);
 
-	std::string variableName = this->currentToken.GetValue();
+	std::string variableName(this->currentToken.GetValue());
 	Advance(TokenType::Name);
 
 	Advance(TokenType::Assign);
@@ -109,12 +140,12 @@ Ref<Node> Parser::ParseGlobalVariables()
 	// First check for non array declaration
 	if (this->currentToken.GetTokenType() != SquareLeft)
 	{
-		Ref<Node> expression = Expression();
+		Node* expression = Expression();
 
-		return std::make_shared<VariableDeclarationAssignNode>(this->lexer.GetFileName(), varLine, variableName, expression);
+		return this->arena->New<VariableDeclarationAssignNode>(this->fileId, varLine, variableName, expression);
 	}
 
-	auto arrayValues = std::vector<Ref<Node>>();
+	auto arrayValues = std::vector<Node*>();
 	TokenType arrayType;
 
 	Advance(SquareLeft);
@@ -157,16 +188,16 @@ Ref<Node> Parser::ParseGlobalVariables()
 
 	Advance(SquareRight);
 
-	return std::make_shared<VariableArrayDeclarationAssignNode>(this->lexer.GetFileName(), varLine, variableName, arrayType, arrayValues);
+	return this->arena->New<VariableArrayDeclarationAssignNode>(this->fileId, varLine, variableName, arrayType, this->arena->NewList(arrayValues));
 }
 
-Ref<Node> Parser::ParseFunction()
+Node* Parser::ParseFunction()
 {
 	Advance(TokenType::Function);
 
     int functionLine = this->currentToken.GetLine();
 
-	std::string functionName = currentToken.GetValue();
+	std::string functionName(currentToken.GetValue());
 	// "Call", because it is used when the next char is "(", which is when calling a function (possible parameters etc.)
 	Advance(Call);
 
@@ -174,7 +205,7 @@ Ref<Node> Parser::ParseFunction()
 	std::vector<std::string> parameters;
 	while (this->currentToken.GetTokenType() != TokenType::ParanRight)
 	{
-		std::string paramName = this->currentToken.GetValue();
+		std::string paramName(this->currentToken.GetValue());
 		Advance(TokenType::Name);
 
 		parameters.push_back(paramName);
@@ -186,19 +217,44 @@ Ref<Node> Parser::ParseFunction()
 	}
 	Advance(TokenType::ParanRight);
 
-	Ref<Node> block = ParseBlock();
+	if (this->lazyFunctions && this->currentToken.GetTokenType() == TokenType::CurlyLeft)
+	{
+		// The lexer is right behind the curly bracket
+		size_t start = this->lexer.GetPosition() - 1;
+		int bodyLine = this->currentToken.GetLine();
+
+		if (!this->lexer.SkipBlock())
+		{
+			Exit(this->currentToken, "Body of function '%s' is not closed", functionName.c_str());
+		}
+
+		std::string_view body = this->lexer.GetInput().substr(start, this->lexer.GetPosition() - start);
+		this->currentToken = this->lexer.NextToken();
+
+		return this->arena->New<FunctionNode>(this->fileId, functionLine, functionName, body, bodyLine, parameters);
+	}
+
+	Node* block = ParseBlock();
+
+	return this->arena->New<FunctionNode>(this->fileId, functionLine, functionName, block, parameters);
+}
 
-	return std::make_shared<FunctionNode>(this->lexer.GetFileName(), functionLine, functionName, block, parameters);
+Node* Parser::ParseFunctionBody(const FunctionNode& function, const Ref<AstArena>& arena)
+{
+	Lexer lexer(function.GetBody(), function.GetFileId(), function.GetBodyLine());
+	Parser parser(lexer, arena);
+
+	return parser.ParseBlock();
 }
 
-Ref<Node> Parser::ParseFunctionCall()
+Node* Parser::ParseFunctionCall()
 {
 	auto line = this->currentToken.GetLine();
-	std::string functionName = this->currentToken.GetValue();
+	std::string functionName(this->currentToken.GetValue());
 	Advance(Call);
 
 	Advance(ParanLeft);
-	std::vector<Ref<Node>> parameters;
+	std::vector<Node*> parameters;
 	while (this->currentToken.GetTokenType() != TokenType::ParanRight)
 	{
 		parameters.push_back(Factor());
@@ -212,44 +268,44 @@ Ref<Node> Parser::ParseFunctionCall()
 	}
 	Advance(ParanRight);
 
-	return std::make_shared<FunctionCallNode>(this->lexer.GetFileName(), line, functionName, parameters);
+	return this->arena->New<FunctionCallNode>(this->fileId, line, functionName, this->arena->NewList(parameters));
 }
 
-Ref<Node> Parser::ParseBlock()
+Node* Parser::ParseBlock()
 {
 	// Support one line statement blocks without curly brackets
 	if (this->currentToken.GetTokenType() != TokenType::CurlyLeft)
 	{
-		std::vector<Ref<Node>> statements;
-		statements.push_back(Statement());
-		return std::make_shared<BlockNode>(statements);
+		std::vector<Node*> statements;
+		statements.push_back(ParseStatement());
+		return this->arena->New<BlockNode>(this->arena->NewList(statements));
 	}
 
 	Advance(CurlyLeft);
-	std::vector<Ref<Node>> statements = ParseStatements();
+	std::vector<Node*> statements = ParseStatements();
 	Advance(CurlyRight);
 
-	return std::make_shared<BlockNode>(statements);
+	return this->arena->New<BlockNode>(this->arena->NewList(statements));
 }
 
-std::vector<Ref<Node>> Parser::ParseStatements()
+std::vector<Node*> Parser::ParseStatements()
 {
-	std::vector<Ref<Node>> statements;
+	std::vector<Node*> statements;
 
 	while (this->currentToken.GetTokenType() != TokenType::CurlyRight)
 	{
-		statements.push_back(Statement());
+		statements.push_back(ParseStatement());
 	}
 
 	return statements;
 }
 
-Ref<Node> Parser::ParseFor()
+Node* Parser::ParseFor()
 {
 	auto line = this->currentToken.GetLine();
 	Advance(TokenType::For);
 
-	std::string variableName = this->currentToken.GetValue();
+	std::string variableName(this->currentToken.GetValue());
 	Advance(TokenType::Name);
 
 	Advance(TokenType::In);
@@ -258,22 +314,20 @@ Ref<Node> Parser::ParseFor()
 	// for i in Range(4)
 	if (this->currentToken.GetTokenType() != TokenType::Int)
 	{
-		Ref<Node> expression = Expression();
-		Ref<Node> block = ParseBlock();
+		Node* expression = Expression();
+		Node* block = ParseBlock();
 
-		return std::make_shared<ForEachNode>(this->lexer.GetFileName(), line, variableName, expression, block);
+		return this->arena->New<ForEachNode>(this->fileId, line, variableName, expression, block);
 	}
 	// for i in 0..5
 	else 
 	{
-		int from = std::stoi(this->currentToken.GetValue());
-		Advance(TokenType::Int);
+		int from = ParseInt();
 
 		Advance(TokenType::Point);
 		Advance(TokenType::Point);
 
-		int to = std::stoi(this->currentToken.GetValue());
-		Advance(TokenType::Int);
+		int to = ParseInt();
 
 		int step = 1;
 
@@ -281,52 +335,51 @@ Ref<Node> Parser::ParseFor()
 		{
 			Advance(TokenType::Step);
 
-			step = std::stoi(this->currentToken.GetValue());
-			Advance(TokenType::Int);
+			step = ParseInt();
 		}
 
-		Ref<Node> block = ParseBlock();
+		Node* block = ParseBlock();
 
-		return std::make_shared<ForINode>(this->lexer.GetFileName(), line, variableName, from, to, step, block);
+		return this->arena->New<ForINode>(this->fileId, line, variableName, from, to, step, block);
 	}
 }
 
-Ref<Node> Parser::ParseWhile()
+Node* Parser::ParseWhile()
 {
 	auto line = this->currentToken.GetLine();
 	Advance(TokenType::While);
 
-	Ref<Node> expression = Expression();
+	Node* expression = Expression();
 
-	Ref<Node> block = ParseBlock();
+	Node* block = ParseBlock();
 
-	return std::make_shared<WhileNode>(this->lexer.GetFileName(), line, expression, block);
+	return this->arena->New<WhileNode>(this->fileId, line, expression, block);
 }
 
-Ref<Node> Parser::ParseDoWhile()
+Node* Parser::ParseDoWhile()
 {
 	auto line = this->currentToken.GetLine();
 	Advance(TokenType::Do);
 
-	Ref<Node> block = ParseBlock();
+	Node* block = ParseBlock();
 
 	Advance(TokenType::While);
 
-	Ref<Node> expression = Expression();
+	Node* expression = Expression();
 
-	return std::make_shared<DoWhileNode>(this->lexer.GetFileName(), line, expression, block);
+	return this->arena->New<DoWhileNode>(this->fileId, line, expression, block);
 }
 
-Ref<Node> Parser::ParseIf()
+Node* Parser::ParseIf()
 {
 	int line = this->currentToken.GetLine();
 	Advance(TokenType::If);
 
-	Ref<Node> expression = Expression();
+	Node* expression = Expression();
 
-	Ref<Node> trueBlock = ParseBlock();
-	std::map<Ref<Node>, Ref<Node>> elseIfBlocks;
-	Ref<Node> elseBlock = nullptr;
+	Node* trueBlock = ParseBlock();
+	std::vector<std::pair<Node*, Node*>> elseIfBlocks;
+	Node* elseBlock = nullptr;
 
 	if (this->currentToken.GetTokenType() == TokenType::Else)
 	{
@@ -342,7 +395,7 @@ Ref<Node> Parser::ParseIf()
 
 			auto elseIfExpression = Expression();
 			auto elseIfBlock = ParseBlock();
-			elseIfBlocks.insert(std::pair<Ref<Node>, Ref<Node>>(elseIfExpression, elseIfBlock));
+			elseIfBlocks.emplace_back(elseIfExpression, elseIfBlock);
 
 			while (this->currentToken.GetTokenType() == TokenType::Else)
 			{
@@ -355,7 +408,7 @@ Ref<Node> Parser::ParseIf()
 					auto innerElseIfExpression = Expression();
 					auto innerElseIfBlock = ParseBlock();
 
-					elseIfBlocks.insert(std::pair<Ref<Node>, Ref<Node>>(innerElseIfExpression, innerElseIfBlock));
+					elseIfBlocks.emplace_back(innerElseIfExpression, innerElseIfBlock);
 				}
 				else
 				{
@@ -367,18 +420,18 @@ Ref<Node> Parser::ParseIf()
 		}
 	}
 
-	return std::make_shared<IfNode>(this->lexer.GetFileName(), line, expression, trueBlock, elseIfBlocks, elseBlock);
+	return this->arena->New<IfNode>(this->fileId, line, expression, trueBlock, this->arena->NewList(elseIfBlocks), elseBlock);
 }
 
-Ref<Node> Parser::ParseWhen()
+Node* Parser::ParseWhen()
 {
 	int line = this->currentToken.GetLine();
 	Advance(TokenType::When);
-	Ref<Node> whenFactor = Factor();
+	Node* whenFactor = Factor();
 	Advance(TokenType::CurlyLeft);
 
-	std::map<Ref<Node>, Ref<Node>> cases;
-	Ref<Node> elseBlock = nullptr;
+	std::vector<std::pair<Node*, Node*>> cases;
+	Node* elseBlock = nullptr;
 	while (this->currentToken.GetTokenType() != TokenType::CurlyRight)
 	{
 		// Handle default (else) case, if only the arrow symbol is used with a block
@@ -389,12 +442,12 @@ Ref<Node> Parser::ParseWhen()
 			break;
 		}
 
-		Ref<Node> value = Factor();
+		Node* value = Factor();
 		Advance(TokenType::Arrow);
-		Ref<Node> block = ParseBlock();
+		Node* block = ParseBlock();
 
-		Ref<Node> expression = std::make_shared<BooleanNode>(whenFactor, TokenType::Equals, value);
-		cases.insert(std::pair<Ref<Node>, Ref<Node>>(expression, block));
+		Node* expression = this->arena->New<BooleanNode>(whenFactor, TokenType::Equals, value);
+		cases.emplace_back(expression, block);
 	}
 
 	Advance(TokenType::CurlyRight);
@@ -404,29 +457,29 @@ Ref<Node> Parser::ParseWhen()
 		Exit(this->currentToken, "'when' statement needs to have at least one case expression and block");
 	}
 
-	Ref<Node> firstExpression = cases.begin()->first;
-	Ref<Node> firstBlock = cases.begin()->second;
+	Node* firstExpression = cases.begin()->first;
+	Node* firstBlock = cases.begin()->second;
 
 	cases.erase(cases.begin());
 
-	return std::make_shared<IfNode>(this->lexer.GetFileName(), line, firstExpression, firstBlock, cases, elseBlock);
+	return this->arena->New<IfNode>(this->fileId, line, firstExpression, firstBlock, this->arena->NewList(cases), elseBlock);
 }
 
-Ref<Node> Parser::ParseReturn()
+Node* Parser::ParseReturn()
 {
 	Advance(TokenType::Return);
 
-	Ref<Node> expression = Expression();
+	Node* expression = Expression();
 
-	return std::make_shared<ReturnNode>(expression);
+	return this->arena->New<ReturnNode>(expression);
 }
 
-Ref<Node> Parser::Factor()
+Node* Parser::Factor()
 {
 	Token tmp = this->currentToken;
 	if (tmp.GetTokenType() == Name)
 	{
-		std::string varName = this->currentToken.GetValue();
+		std::string varName(this->currentToken.GetValue());
 		Advance(Name);
 
 		int line = this->currentToken.GetLine();
@@ -435,17 +488,17 @@ Ref<Node> Parser::Factor()
 		{
 			Advance(PlusPlus);
 
-			return std::make_shared<VariableIncrementDecrementNode>(this->lexer.GetFileName(), line, varName, 1);
+			return this->arena->New<VariableIncrementDecrementNode>(this->fileId, line, varName, 1);
 		}
 		else if (this->currentToken.GetTokenType() == MinusMinus)
 		{
 			Advance(MinusMinus);
 
-			return std::make_shared<VariableIncrementDecrementNode>(this->lexer.GetFileName(), line, varName, -1);
+			return this->arena->New<VariableIncrementDecrementNode>(this->fileId, line, varName, -1);
 		}
 		else if (this->currentToken.GetTokenType() != SquareLeft)
 		{
-			return std::make_shared<VariableUsageNode>(this->lexer.GetFileName(), line, varName);
+			return this->arena->New<VariableUsageNode>(this->fileId, line, varName);
 		}
 		else
 		{
@@ -457,16 +510,16 @@ Ref<Node> Parser::Factor()
 					varName.c_str());
 			}
 
-			int arrayIndex = std::stoi(this->currentToken.GetValue());
+			Token indexToken = this->currentToken;
+			int arrayIndex = ParseInt();
 			if (arrayIndex < 0)
 			{
-				Exit(this->currentToken, "Array index for '%s' cannot be negative", varName.c_str());
+				Exit(indexToken, "Array index for '%s' cannot be negative", varName.c_str());
 			}
-			Advance(Int);
 
 			Advance(SquareRight);
 
-			return std::make_shared<VariableArrayUsageNode>(this->lexer.GetFileName(), line, varName, arrayIndex);
+			return this->arena->New<VariableArrayUsageNode>(this->fileId, line, varName, arrayIndex);
 		}
 	}
 	else if (tmp.GetTokenType() == Call)
@@ -475,34 +528,40 @@ Ref<Node> Parser::Factor()
 	}
 	else if (tmp.GetTokenType() == Int)
 	{
-		std::string value = this->currentToken.GetValue();
-		Advance(Int);
-
-		return std::make_shared<IntNode>(value);
+		return this->arena->New<IntNode>(ParseInt());
 	}
 	else if (tmp.GetTokenType() == Float)
 	{
-		std::string value = this->currentToken.GetValue();
-		Advance(Float);
+		return this->arena->New<FloatNode>(ParseFloat());
+	}
+	else if (tmp.GetTokenType() == Long)
+	{
+		Advance(Long);
 
-		return std::make_shared<FloatNode>(value);
+		return this->arena->New<LongNode>(tmp.GetInt());
+	}
+	else if (tmp.GetTokenType() == Double)
+	{
+		Advance(Double);
+
+		return this->arena->New<DoubleNode>(tmp.GetFloat());
 	}
 	else if (tmp.GetTokenType() == String)
 	{
-		std::string value = this->currentToken.GetValue();
+		std::string value(this->currentToken.GetValue());
 		Advance(String);
 
-		std::vector<Ref<Node>> expressions;
+		std::vector<Node*> expressions;
 
 		size_t indexOfCurlyOpen = value.find('{');
-		while (indexOfCurlyOpen != -1)
+		while (indexOfCurlyOpen != std::string::npos)
 		{
 			size_t indexOfCurlyClose = value.find('}', indexOfCurlyOpen);
 
 			std::string varName = value.substr(indexOfCurlyOpen + 1, indexOfCurlyClose - indexOfCurlyOpen - 1);
 
-			Lexer innerLexer(varName, this->lexer.GetFileName());
-			Parser innerParser(innerLexer);
+			Lexer innerLexer(varName, this->lexer.GetFileId());
+			Parser innerParser(innerLexer, this->arena);
 
 			try
 			{
@@ -519,25 +578,25 @@ Ref<Node> Parser::Factor()
 			indexOfCurlyOpen = value.find('{');
 		}
 
-		return std::make_shared<StringNode>(this->lexer.GetFileName(), this->currentToken.GetLine(), value, expressions);
+		return this->arena->New<StringNode>(this->fileId, this->currentToken.GetLine(), value, this->arena->NewList(expressions));
 	}
 	else if (tmp.GetTokenType() == Bool)
 	{
-		std::string value = this->currentToken.GetValue();
+		std::string value(this->currentToken.GetValue());
 		Advance(Bool);
 
-		return std::make_shared<BoolNode>(value);
+		return this->arena->New<BoolNode>(value);
 	}
 
 	Exit(this->currentToken, "Unexpected token '%s' ('%s')",
-		Helper::ToString(this->currentToken.GetTokenType()).c_str(), this->currentToken.GetValue().c_str());
+		Helper::ToString(this->currentToken.GetTokenType()).c_str(), std::string(this->currentToken.GetValue()).c_str());
 
 	return nullptr;
 }
 
-Ref<Node> Parser::Term()
+Node* Parser::Term()
 {
-	Ref<Node> result = Factor();
+	Node* result = Factor();
 
 	while (currentToken.GetTokenType() == Multiply || currentToken.GetTokenType() == Divide || 
 		currentToken.GetTokenType() == Equals || currentToken.GetTokenType() == NotEquals || currentToken.GetTokenType() == LessThan || 
@@ -548,24 +607,24 @@ Ref<Node> Parser::Term()
 		{
 			Advance(tmp.GetTokenType());
 
-			Ref<Node> right = Factor();
-			result = std::make_shared<BinaryNode>(result, tmp.GetTokenType(), right);
+			Node* right = Factor();
+			result = this->arena->New<BinaryNode>(result, tmp.GetTokenType(), right);
 		}
 		else if (tmp.GetTokenType() == Equals || tmp.GetTokenType() == NotEquals || currentToken.GetTokenType() == LessThan || 
 			currentToken.GetTokenType() == GreaterThan || currentToken.GetTokenType() == GreaterEqualThan || currentToken.GetTokenType() == LessEqualThan)
 		{
 			Advance(tmp.GetTokenType());
 
-			Ref<Node> right = Expression();
-			//Ref<Node> right = Term();
-			result = std::make_shared<BooleanNode>(result, tmp.GetTokenType(), right);
+			Node* right = Expression();
+			//Node* right = Term();
+			result = this->arena->New<BooleanNode>(result, tmp.GetTokenType(), right);
 		}
 	}
 
 	return result;
 }
 
-Ref<Node> Parser::Statement()
+Node* Parser::ParseStatement()
 {
 	if (this->currentToken.GetTokenType() == Call)
 	{
@@ -573,7 +632,7 @@ Ref<Node> Parser::Statement()
 	}
 	else if (this->currentToken.GetTokenType() == Name)
 	{
-		std::string varName = this->currentToken.GetValue();
+		std::string varName(this->currentToken.GetValue());
 		Advance(Name);
 
 		int line = this->currentToken.GetLine();
@@ -582,26 +641,26 @@ Ref<Node> Parser::Statement()
 		{
 			Advance(Assign);
 
-			return std::make_shared<VariableAssignNode>(this->lexer.GetFileName(), line, varName, Expression());
+			return this->arena->New<VariableAssignNode>(this->fileId, line, varName, Expression());
 		}
 		else if (this->currentToken.GetTokenType() == PlusPlus)
 		{
 			Advance(PlusPlus);
 
-			return std::make_shared<VariableIncrementDecrementNode>(this->lexer.GetFileName(), line, varName, 1);
+			return this->arena->New<VariableIncrementDecrementNode>(this->fileId, line, varName, 1);
 		}
 		else if (this->currentToken.GetTokenType() == Plus)
 		{
 			Advance(Plus);
 			Advance(Assign);
 
-			return std::make_shared<VariableCompoundAssignNode>(this->lexer.GetFileName(), line, varName, Expression(), TokenType::Plus);
+			return this->arena->New<VariableCompoundAssignNode>(this->fileId, line, varName, Expression(), TokenType::Plus);
 		}
 		else if (this->currentToken.GetTokenType() == MinusMinus)
 		{
 			Advance(MinusMinus);
 
-			return std::make_shared<VariableIncrementDecrementNode>(this->lexer.GetFileName(), line, varName, -1);
+			return this->arena->New<VariableIncrementDecrementNode>(this->fileId, line, varName, -1);
 		}
 		else if (this->currentToken.GetTokenType() == Minus)
 		{
@@ -610,7 +669,7 @@ Ref<Node> Parser::Statement()
 			Advance(Minus);
 			Advance(Assign);
 
-			return std::make_shared<VariableCompoundAssignNode>(this->lexer.GetFileName(), lineNumber, varName, Expression(), TokenType::Minus);
+			return this->arena->New<VariableCompoundAssignNode>(this->fileId, lineNumber, varName, Expression(), TokenType::Minus);
 		}
 		else if (this->currentToken.GetTokenType() == Multiply)
 		{
@@ -619,7 +678,7 @@ Ref<Node> Parser::Statement()
 			Advance(Multiply);
 			Advance(Assign);
 
-			return std::make_shared<VariableCompoundAssignNode>(this->lexer.GetFileName(), lineNumber, varName, Expression(), TokenType::Multiply);
+			return this->arena->New<VariableCompoundAssignNode>(this->fileId, lineNumber, varName, Expression(), TokenType::Multiply);
 		}
 		else if (this->currentToken.GetTokenType() == Divide)
 		{
@@ -628,7 +687,7 @@ Ref<Node> Parser::Statement()
 			Advance(Divide);
 			Advance(Assign);
 
-			return std::make_shared<VariableCompoundAssignNode>(this->lexer.GetFileName(), lineNumber, varName, Expression(), TokenType::Divide);
+			return this->arena->New<VariableCompoundAssignNode>(this->fileId, lineNumber, varName, Expression(), TokenType::Divide);
 		}
 		else if (this->currentToken.GetTokenType() == SquareLeft)
 		{
@@ -639,22 +698,22 @@ Ref<Node> Parser::Statement()
 				Exit(this->currentToken, "Array access index for '%s' can only be an int", varName.c_str());
 			}
 
-			int arrayIndex = std::stoi(this->currentToken.GetValue());
+			Token indexToken = this->currentToken;
+			int arrayIndex = ParseInt();
 			if (arrayIndex < 0)
 			{
-				Exit(this->currentToken, "Array index for '%s' cannot be negative", varName.c_str());
+				Exit(indexToken, "Array index for '%s' cannot be negative", varName.c_str());
 			}
-			Advance(TokenType::Int);
 
 			Advance(TokenType::SquareRight);
 
 			Advance(TokenType::Assign);
 
-			return std::make_unique<VariableArrayAssignNode>(this->lexer.GetFileName(), line, varName, arrayIndex, Expression());
+			return this->arena->New<VariableArrayAssignNode>(this->fileId, line, varName, arrayIndex, Expression());
 		}
 		else
 		{
-			return std::make_unique<VariableUsageNode>(this->lexer.GetFileName(), line, varName);
+			return this->arena->New<VariableUsageNode>(this->fileId, line, varName);
 		}
 	}
 	else if (this->currentToken.GetTokenType() == For)
@@ -687,14 +746,14 @@ Ref<Node> Parser::Statement()
 	}
 
 	Exit(this->currentToken, "Unexpected token '%s' ('%s')",
-		Helper::ToString(this->currentToken.GetTokenType()).c_str(), this->currentToken.GetValue().c_str());
+		Helper::ToString(this->currentToken.GetTokenType()).c_str(), std::string(this->currentToken.GetValue()).c_str());
 
 	return nullptr;
 }
 
-Ref<Node> Parser::Expression()
+Node* Parser::Expression()
 {
-	Ref<Node> result = Term();
+	Node* result = Term();
 
 	while (currentToken.GetTokenType() == Plus || currentToken.GetTokenType() == Minus || 
 		currentToken.GetTokenType() == Multiply || currentToken.GetTokenType() == Divide)
@@ -717,8 +776,8 @@ Ref<Node> Parser::Expression()
 			Advance(Divide);
 		}
 
-		Ref<Node> right = Term();
-		result = std::make_shared<BinaryNode>(result, tmp.GetTokenType(), right);
+		Node* right = Term();
+		result = this->arena->New<BinaryNode>(result, tmp.GetTokenType(), right);
 	}
 
 	return result;
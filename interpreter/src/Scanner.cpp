@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "Scanner.h"
+#include <cstdint>
+
+// The vector implementations need the target attribute for AVX2 and the cpu detection builtins
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define IONA_SCANNER_SIMD
+#define IONA_AVX2 __attribute__((target("avx2")))
+#endif
+
+struct ScannerFunctions
+{
+	const char* name;
+	size_t (*skip)(std::string_view input, size_t position, CharRun run, int& lines);
+	size_t (*find)(std::string_view input, size_t position, char c);
+};
+
+static bool IsPartOfRun(char c, CharRun run)
+{
+	switch (run)
+	{
+		case CharRun::Spaces:
+			return c == ' ' || (c >= '\t' && c <= '\r');
+		case CharRun::Name:
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+		case CharRun::Digits:
+			return c >= '0' && c <= '9';
+	}
+
+	return false;
+}
+
+static size_t SkipScalar(std::string_view input, size_t position, CharRun run, int& lines)
+{
+	while (position < input.size() && IsPartOfRun(input[position], run))
+	{
+		if (input[position] == '\n')
+		{
+			lines++;
+		}
+
+		position++;
+	}
+
+	return position;
+}
+
+static size_t FindScalar(std::string_view input, size_t position, char c)
+{
+	while (position < input.size() && input[position] != c)
+	{
+		position++;
+	}
+
+	return position;
+}
+
+#ifdef IONA_SCANNER_SIMD
+
+// The ranges only contain ascii, bytes above 127 are negative as signed chars and never match
+static __m128i InRange16(__m128i block, char low, char high)
+{
+	return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(low - 1)), _mm_cmplt_epi8(block, _mm_set1_epi8(high + 1)));
+}
+
+// Bit i is set if byte i of the block is part of the run
+static uint32_t RunMask16(__m128i block, CharRun run)
+{
+	__m128i matches;
+	switch (run)
+	{
+		case CharRun::Spaces:
+			matches = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')), InRange16(block, '\t', '\r'));
+			break;
+		case CharRun::Name:
+			// Setting 0x20 turns upper into lower case letters and '_' into 0x7F, which is no letter
+			matches = _mm_or_si128(InRange16(_mm_or_si128(block, _mm_set1_epi8(0x20)), 'a', 'z'), _mm_cmpeq_epi8(block, _mm_set1_epi8('_')));
+			break;
+		default:
+			matches = InRange16(block, '0', '9');
+			break;
+	}
+
+	return (uint32_t) _mm_movemask_epi8(matches);
+}
+
+static size_t SkipSse2(std::string_view input, size_t position, CharRun run, int& lines)
+{
+	const __m128i newLine = _mm_set1_epi8('\n');
+
+	while (position + 16 <= input.size())
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + position));
+		uint32_t others = ~RunMask16(block, run) & 0xFFFF;
+		uint32_t length = others != 0 ? (uint32_t) __builtin_ctz(others) : 16;
+
+		if (run == CharRun::Spaces)
+		{
+			uint32_t newLines = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(block, newLine));
+			lines += __builtin_popcount(newLines & ((1u << length) - 1));
+		}
+
+		position += length;
+		if (others != 0)
+		{
+			return position;
+		}
+	}
+
+	return SkipScalar(input, position, run, lines);
+}
+
+static size_t FindSse2(std::string_view input, size_t position, char c)
+{
+	const __m128i pattern = _mm_set1_epi8(c);
+
+	while (position + 16 <= input.size())
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + position));
+		uint32_t matches = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern));
+		if (matches != 0)
+		{
+			return position + __builtin_ctz(matches);
+		}
+
+		position += 16;
+	}
+
+	return FindScalar(input, position, c);
+}
+
+IONA_AVX2 static __m256i InRange32(__m256i block, char low, char high)
+{
+	return _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8(low - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), block));
+}
+
+IONA_AVX2 static uint32_t RunMask32(__m256i block, CharRun run)
+{
+	__m256i matches;
+	switch (run)
+	{
+		case CharRun::Spaces:
+			matches = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')), InRange32(block, '\t', '\r'));
+			break;
+		case CharRun::Name:
+			matches = _mm256_or_si256(InRange32(_mm256_or_si256(block, _mm256_set1_epi8(0x20)), 'a', 'z'), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_')));
+			break;
+		default:
+			matches = InRange32(block, '0', '9');
+			break;
+	}
+
+	return (uint32_t) _mm256_movemask_epi8(matches);
+}
+
+IONA_AVX2 static size_t SkipAvx2(std::string_view input, size_t position, CharRun run, int& lines)
+{
+	const __m256i newLine = _mm256_set1_epi8('\n');
+
+	while (position + 32 <= input.size())
+	{
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input.data() + position));
+		uint32_t others = ~RunMask32(block, run);
+		uint32_t length = others != 0 ? (uint32_t) __builtin_ctz(others) : 32;
+
+		if (run == CharRun::Spaces)
+		{
+			uint64_t newLines = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newLine));
+			lines += __builtin_popcountll(newLines & ((1ull << length) - 1));
+		}
+
+		position += length;
+		if (others != 0)
+		{
+			return position;
+		}
+	}
+
+	// The rest is shorter than a 32 byte block, but may still fill a 16 byte one
+	return SkipSse2(input, position, run, lines);
+}
+
+IONA_AVX2 static size_t FindAvx2(std::string_view input, size_t position, char c)
+{
+	const __m256i pattern = _mm256_set1_epi8(c);
+
+	while (position + 32 <= input.size())
+	{
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input.data() + position));
+		uint32_t matches = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, pattern));
+		if (matches != 0)
+		{
+			return position + __builtin_ctz(matches);
+		}
+
+		position += 32;
+	}
+
+	return FindSse2(input, position, c);
+}
+
+#endif
+
+static const ScannerFunctions Implementations[] = {
+#ifdef IONA_SCANNER_SIMD
+	{ "avx2", SkipAvx2, FindAvx2 },
+	{ "sse2", SkipSse2, FindSse2 },
+#endif
+	{ "scalar", SkipScalar, FindScalar }
+};
+
+static bool IsSupported(const ScannerFunctions& functions)
+{
+#ifdef IONA_SCANNER_SIMD
+	if (functions.skip == SkipAvx2)
+	{
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+	}
+#endif
+
+	// SSE2 is part of every x86-64 cpu
+	return true;
+}
+
+static const ScannerFunctions* SelectImplementation()
+{
+	for (const auto& functions : Implementations)
+	{
+		if (IsSupported(functions))
+		{
+			return &functions;
+		}
+	}
+
+	return &Implementations[0];
+}
+
+static const ScannerFunctions* implementation = SelectImplementation();
+
+size_t Scanner::Skip(std::string_view input, size_t position, CharRun run)
+{
+	int lines = 0;
+	return implementation->skip(input, position, run, lines);
+}
+
+size_t Scanner::SkipSpaces(std::string_view input, size_t position, int& lines)
+{
+	return implementation->skip(input, position, CharRun::Spaces, lines);
+}
+
+size_t Scanner::Find(std::string_view input, size_t position, char c)
+{
+	return implementation->find(input, position, c);
+}
+
+const char* Scanner::GetImplementation()
+{
+	return implementation->name;
+}
+
+std::vector<std::string> Scanner::GetImplementations()
+{
+	std::vector<std::string> names;
+	for (const auto& functions : Implementations)
+	{
+		if (IsSupported(functions))
+		{
+			names.emplace_back(functions.name);
+		}
+	}
+
+	return names;
+}
+
+bool Scanner::SetImplementation(const std::string& name)
+{
+	for (const auto& functions : Implementations)
+	{
+		if (functions.name == name && IsSupported(functions))
+		{
+			implementation = &functions;
+			return true;
+		}
+	}
+
+	return false;
+}
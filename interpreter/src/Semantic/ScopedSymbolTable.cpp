@@ -7,8 +7,8 @@
 
 #include "ScopedSymbolTable.h"
 
-ScopedSymbolTable::ScopedSymbolTable(std::string name, int level, Ref<ScopedSymbolTable> parent)
-    : name(std::move(name)), level(level), parent(std::move(parent))
+ScopedSymbolTable::ScopedSymbolTable(std::string name, int level, Ref<ScopedSymbolTable> parent, bool frame)
+    : name(std::move(name)), level(level), parent(std::move(parent)), frame(frame || this->parent == nullptr)
 {
 
 }
@@ -35,6 +35,43 @@ std::optional<Symbol> ScopedSymbolTable::Find(const std::string& symbolName)
     return std::make_optional(iterator->second);
 }
 
+std::optional<Symbol> ScopedSymbolTable::Resolve(const std::string& symbolName, int& depth)
+{
+    depth = 0;
+
+    for (ScopedSymbolTable* table = this; table != nullptr; table = table->parent.get())
+    {
+        auto iterator = table->symbols.find(symbolName);
+        if (iterator != table->symbols.end())
+        {
+            return std::make_optional(iterator->second);
+        }
+
+        if (table->frame)
+        {
+            depth++;
+        }
+    }
+
+    return std::nullopt;
+}
+
+int ScopedSymbolTable::AllocateSlot()
+{
+    ScopedSymbolTable* table = this;
+    while (!table->frame)
+    {
+        table = table->parent.get();
+    }
+
+    return table->frameSize++;
+}
+
+int ScopedSymbolTable::GetFrameSize() const
+{
+    return this->frameSize;
+}
+
 int ScopedSymbolTable::GetLevel() const
 {
     return this->level;
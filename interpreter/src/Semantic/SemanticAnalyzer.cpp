@@ -9,14 +9,15 @@
 #include <chrono>
 #include <VariableSymbol.h>
 #include <FunctionSymbol.h>
+#include "Standard.h"
 
-SemanticAnalyzer::SemanticAnalyzer(const std::vector<std::string>& args, const Ref<Node>& astRoot)
-    : SemanticAnalyzer(args, astRoot, std::make_shared<ScopedSymbolTable>("global", 1, nullptr))
+SemanticAnalyzer::SemanticAnalyzer(const Ref<Node>& astRoot)
+    : SemanticAnalyzer(astRoot, std::make_shared<ScopedSymbolTable>("global", 1, nullptr))
 {
 
 }
 
-SemanticAnalyzer::SemanticAnalyzer(const std::vector<std::string>& args, const Ref<Node>& astRoot, const Ref<ScopedSymbolTable>& scope)
+SemanticAnalyzer::SemanticAnalyzer(const Ref<Node>& astRoot, const Ref<ScopedSymbolTable>& scope)
     : Visitor(astRoot), currentScope(scope)
 {
     this->RegisterBuiltInSymbols();
@@ -51,21 +52,28 @@ void SemanticAnalyzer::RegisterBuiltInSymbols()
     this->currentScope->Add(FunctionSymbol("FileWriteLines"));
     this->currentScope->Add(FunctionSymbol("FileList"));
 
-    this->currentScope->Add(VariableSymbol("PI"));
-    this->currentScope->Add(VariableSymbol("INT_MIN"));
-    this->currentScope->Add(VariableSymbol("INT_MAX"));
-    this->currentScope->Add(VariableSymbol("FLOAT_MIN"));
-    this->currentScope->Add(VariableSymbol("FLOAT_MAX"));
+    // Internal variables get the first slots of the global frame, in the same order as in the interpreter.
+    // The global scope is reused in the interactive mode, so they could already be declared.
+    if (!this->currentScope->Find("ARGS"))
+    {
+        for (const auto& [name, value] : Iona::InternalVariables())
+        {
+            this->currentScope->Add(VariableSymbol(name, this->currentScope->AllocateSlot(), value.GetType()));
+        }
+        this->currentScope->Add(VariableSymbol("ARGS", this->currentScope->AllocateSlot(), TokenType::StringArray));
+    }
 }
 
 void SemanticAnalyzer::PushScope(const std::string& name)
 {
-    this->currentScope = std::make_shared<ScopedSymbolTable>(name, this->currentScope->GetLevel() + 1, this->currentScope);
+    // Named scopes are the ones of functions, which own a frame
+    this->currentScope = std::make_shared<ScopedSymbolTable>(name, this->currentScope->GetLevel() + 1, this->currentScope, true);
 }
 
 void SemanticAnalyzer::PushScope()
 {
-    this->PushScope(std::to_string(this->currentScope->GetLevel() + 1));
+    int level = this->currentScope->GetLevel() + 1;
+    this->currentScope = std::make_shared<ScopedSymbolTable>(std::to_string(level), level, this->currentScope);
 }
 
 void SemanticAnalyzer::PopScope()
@@ -73,39 +81,54 @@ void SemanticAnalyzer::PopScope()
     this->currentScope = this->currentScope->GetParent();
 }
 
-void SemanticAnalyzer::EnsureVariableDeclaration(const Ref<Node>& node, const std::string& name)
+int SemanticAnalyzer::DeclareVariable(const Node& node, const std::string& name, TokenType type)
 {
-    std::optional<Symbol> symbol = this->currentScope->Find(name);
-    if (!symbol)
+    this->EnsureVariableUniqueness(node, name);
+
+    int slot = this->currentScope->AllocateSlot();
+    this->currentScope->Add(VariableSymbol(name, slot, IsVariableType(type) ? type : TokenType::None));
+
+    return slot;
+}
+
+TokenType SemanticAnalyzer::ResolveVariable(const Node& node, const std::string& name, ResolvedVariable& variable)
+{
+    int depth;
+    std::optional<Symbol> symbol = this->currentScope->Resolve(name, depth);
+    if (!symbol || symbol->GetSlot() < 0)
     {
-        Exit(node->GetFileName(), node->GetLine(), "Variable '%s' is not declared in this scope", name.c_str());
+        Exit(node.GetFileName(), node.GetLine(), "Variable '%s' is not declared in this scope", name.c_str());
     }
+
+    variable.Resolve(depth, symbol->GetSlot());
+
+    return symbol->GetType();
 }
 
-void SemanticAnalyzer::EnsureFunctionDeclaration(const Ref<Node>& node, const std::string& name)
+void SemanticAnalyzer::EnsureFunctionDeclaration(const Node& node, const std::string& name)
 {
     auto symbol = this->currentScope->Find(name);
     if (!symbol)
     {
-        Exit(node->GetFileName(), node->GetLine(), "Function '%s' is not declared", name.c_str());
+        Exit(node.GetFileName(), node.GetLine(), "Function '%s' is not declared", name.c_str());
     }
 }
 
-void SemanticAnalyzer::EnsureVariableUniqueness(const Ref<Node>& node, const std::string& name)
+void SemanticAnalyzer::EnsureVariableUniqueness(const Node& node, const std::string& name)
 {
     std::optional<Symbol> symbol = this->currentScope->Find(name);
     if (symbol)
     {
-        Exit(node->GetFileName(), node->GetLine(), "Variable '%s' is already declared in this scope", name.c_str());
+        Exit(node.GetFileName(), node.GetLine(), "Variable '%s' is already declared in this scope", name.c_str());
     }
 }
 
-void SemanticAnalyzer::EnsureFunctionUniqueness(const Ref<Node>& node, const std::string& name)
+void SemanticAnalyzer::EnsureFunctionUniqueness(const Node& node, const std::string& name)
 {
     std::optional<Symbol> symbol = this->currentScope->Find(name);
     if (symbol)
     {
-        Exit(node->GetFileName(), node->GetLine(), "Function '%s' is already declared in this scope", name.c_str());
+        Exit(node.GetFileName(), node.GetLine(), "Function '%s' is already declared in this scope", name.c_str());
     }
 }
 
@@ -113,7 +136,7 @@ void SemanticAnalyzer::Analyze()
 {
     auto start = std::chrono::high_resolution_clock::now();
 
-    this->astRoot->Accept(shared_from_this());
+    this->astRoot->Accept(*this);
 
     auto end = std::chrono::high_resolution_clock::now();
 
@@ -122,190 +145,292 @@ void SemanticAnalyzer::Analyze()
              std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
 }
 
-void SemanticAnalyzer::Visit(const Ref<MainNode>& n)
+void SemanticAnalyzer::AnalyzeFunction(FunctionNode& function)
 {
-    for (const auto& globalVariable : n->GetGlobalVariables())
+    function.Accept(*this);
+}
+
+void SemanticAnalyzer::Visit(MainNode& n)
+{
+    for (const auto& globalVariable : n.GetGlobalVariables())
     {
-        globalVariable->Accept(shared_from_this());
+        globalVariable->Accept(*this);
     }
 
     // Pre register all function symbols before visiting the function block,
     // so that all function names are known inside those blocks
-    for (const auto& globalFunction : n->GetGlobalFunctions())
+    for (const auto& globalFunction : n.GetGlobalFunctions())
     {
-        Ref<FunctionNode> fun = std::dynamic_pointer_cast<FunctionNode>(globalFunction);
+        FunctionNode* fun = static_cast<FunctionNode*>(globalFunction);
 
         this->EnsureFunctionUniqueness(n, fun->GetName());
 
         this->currentScope->Add(FunctionSymbol(fun->GetName()));
+        this->globalFunctions.insert(std::pair<std::string, FunctionNode*>(fun->GetName(), fun));
     }
 
-    for (const auto& globalFunction : n->GetGlobalFunctions())
+    for (const auto& globalFunction : n.GetGlobalFunctions())
     {
-        globalFunction->Accept(shared_from_this());
+        globalFunction->Accept(*this);
     }
 }
 
-void SemanticAnalyzer::Visit(const Ref<VariableDeclarationAssignNode>& n)
+void SemanticAnalyzer::Visit(VariableDeclarationAssignNode& n)
 {
-    this->EnsureVariableUniqueness(n, n->GetName());
+    n.GetExpression()->Accept(*this);
+
+    n.Resolve(0, this->DeclareVariable(n, n.GetName(), this->currentType));
+}
 
-    this->currentScope->Add(VariableSymbol(n->GetName()));
+void SemanticAnalyzer::Visit(VariableArrayDeclarationAssignNode& n)
+{
+    for (auto& value : n.GetValues())
+    {
+        value->Accept(*this);
+    }
 
-    n->GetExpression()->Accept(shared_from_this());
+    n.Resolve(0, this->DeclareVariable(n, n.GetName(), n.GetArrayType()));
 }
 
-void SemanticAnalyzer::Visit(const Ref<VariableArrayDeclarationAssignNode>& n)
+void SemanticAnalyzer::Visit(FunctionNode& n)
 {
-    this->EnsureVariableUniqueness(n, n->GetName());
+    // The body of a lazily parsed function is analyzed once it is parsed
+    if (!n.IsParsed())
+    {
+        return;
+    }
 
-    this->currentScope->Add(VariableSymbol(n->GetName()));
+    this->PushScope(n.GetName());
 
-    for (auto& value : n->GetValues())
+    // Parameters are passed in the first slots of the frame
+    for (const auto& parameter : n.GetParameters())
     {
-        value->Accept(shared_from_this());
+        this->currentScope->Add(VariableSymbol(parameter, this->currentScope->AllocateSlot()));
     }
-}
 
-void SemanticAnalyzer::Visit(const Ref<FunctionNode>& n)
-{
-    this->PushScope(n->GetName());
-    n->GetBlock()->Accept(shared_from_this());
+    n.GetBlock()->Accept(*this);
+
+    n.SetFrameSize(this->currentScope->GetFrameSize());
     this->PopScope();
 }
 
-void SemanticAnalyzer::Visit(const Ref<FunctionCallNode>& n)
+void SemanticAnalyzer::Visit(FunctionCallNode& n)
 {
-    this->EnsureFunctionDeclaration(n, n->GetName());
+    this->EnsureFunctionDeclaration(n, n.GetName());
+
+    std::vector<TokenType> types;
+    types.reserve(n.GetParameters().size());
+
+    for (auto& functionCall : n.GetParameters())
+    {
+        functionCall->Accept(*this);
 
-    for (auto& functionCall : n->GetParameters())
+        types.push_back(this->currentType);
+    }
+
+    // Bind the call to its function, so it is not looked up by name while executing
+    auto function = this->globalFunctions.find(n.GetName());
+    if (function != this->globalFunctions.end())
+    {
+        n.Resolve(function->second);
+    }
+    else
     {
-        functionCall->Accept(shared_from_this());
+        const FunctionEntry* entry = FunctionRegistry::Internal().Find(n.GetName());
+        if (entry == nullptr)
+        {
+            Exit(n.GetFileName(), n.GetLine(), "Function '%s' is not declared", n.GetName().c_str());
+        }
+
+        // Arguments of unknown type (eg. parameters of a function) are still checked at runtime
+        bool typesChecked = types.size() == entry->parameterCount;
+        for (size_t i = 0; typesChecked && i < types.size(); i++)
+        {
+            typesChecked = entry->Accepts(i, types[i]);
+        }
+
+        n.Resolve(entry, typesChecked);
     }
+
+    // Return types of functions are not known
+    this->currentType = TokenType::None;
 }
 
-void SemanticAnalyzer::Visit(const Ref<ForEachNode>& n)
+void SemanticAnalyzer::Visit(ForEachNode& n)
 {
-    this->EnsureVariableUniqueness(n, n->GetVariableName());
+    n.GetExpression()->Accept(*this);
+
+    TokenType elementType = IsVariableArrayType(this->currentType) ? GetArrayElementType(this->currentType) : TokenType::None;
 
     this->PushScope();
 
-    this->currentScope->Add(VariableSymbol(n->GetVariableName()));
+    n.Resolve(0, this->DeclareVariable(n, n.GetVariableName(), elementType));
 
-    n->GetExpression()->Accept(shared_from_this());
-    n->GetBlock()->Accept(shared_from_this());
+    n.GetBlock()->Accept(*this);
 
     this->PopScope();
 }
 
-void SemanticAnalyzer::Visit(const Ref<ForINode>& n)
+void SemanticAnalyzer::Visit(ForINode& n)
 {
-    this->EnsureVariableUniqueness(n, n->GetVariableName());
-
     this->PushScope();
 
-    this->currentScope->Add(VariableSymbol(n->GetVariableName()));
+    n.Resolve(0, this->DeclareVariable(n, n.GetVariableName(), TokenType::Int));
 
-    n->GetBlock()->Accept(shared_from_this());
+    n.GetBlock()->Accept(*this);
 
     this->PopScope();
 }
 
-void SemanticAnalyzer::Visit(const Ref<BlockNode>& n)
+void SemanticAnalyzer::Visit(BlockNode& n)
 {
-    for (auto& statement : n->GetStatements())
+    for (auto& statement : n.GetStatements())
     {
-        statement->Accept(shared_from_this());
+        statement->Accept(*this);
     }
 }
 
-void SemanticAnalyzer::Visit(const Ref<BinaryNode>& n)
+void SemanticAnalyzer::Visit(BinaryNode& n)
 {
-    n->GetLeft()->Accept(shared_from_this());
-    n->GetRight()->Accept(shared_from_this());
+    n.GetLeft()->Accept(*this);
+    TokenType leftType = this->currentType;
+
+    n.GetRight()->Accept(*this);
+    TokenType rightType = this->currentType;
+
+    // Only operands of the same type have a result, strings can only be concatenated
+    n.SetTypedOperation(SpecializeArithmetic(n.GetOperant(), leftType, rightType));
+    if (n.GetTypedOperation() == nullptr)
+    {
+        this->currentType = TokenType::None;
+    }
 }
 
-void SemanticAnalyzer::Visit(const Ref<BooleanNode>& n)
+void SemanticAnalyzer::Visit(BooleanNode& n)
 {
-    n->GetLeft()->Accept(shared_from_this());
-    n->GetRight()->Accept(shared_from_this());
+    n.GetLeft()->Accept(*this);
+    TokenType leftType = this->currentType;
+
+    n.GetRight()->Accept(*this);
+    TokenType rightType = this->currentType;
+
+    n.SetTypedOperation(SpecializeComparison(n.GetOperant(), leftType, rightType));
+
+    this->currentType = TokenType::Bool;
 }
 
-void SemanticAnalyzer::Visit(const Ref<IfNode>& n)
+void SemanticAnalyzer::Visit(IfNode& n)
 {
-    n->GetExpression()->Accept(shared_from_this());
+    n.GetExpression()->Accept(*this);
 
     this->PushScope();
-    n->GetTrueBlock()->Accept(shared_from_this());
+    n.GetTrueBlock()->Accept(*this);
     this->PopScope();
 
-    for (const auto& [expression, block] : n->GetElseIfBlocks())
+    for (const auto& [expression, block] : n.GetElseIfBlocks())
     {
+        expression->Accept(*this);
+
         this->PushScope();
-        block->Accept(shared_from_this());
+        block->Accept(*this);
         this->PopScope();
     }
 
-    if (n->GetElseBlock() != nullptr)
+    if (n.GetElseBlock() != nullptr)
     {
         this->PushScope();
-        n->GetElseBlock()->Accept(shared_from_this());
+        n.GetElseBlock()->Accept(*this);
         this->PopScope();
     }
 }
 
-void SemanticAnalyzer::Visit(const Ref<WhileNode>& n)
+void SemanticAnalyzer::Visit(WhileNode& n)
 {
     this->PushScope();
 
-    n->GetExpression()->Accept(shared_from_this());
-    n->GetBlock()->Accept(shared_from_this());
+    n.GetExpression()->Accept(*this);
+    n.GetBlock()->Accept(*this);
 
     this->PopScope();
 }
 
-void SemanticAnalyzer::Visit(const Ref<DoWhileNode>& n)
+void SemanticAnalyzer::Visit(DoWhileNode& n)
 {
     this->PushScope();
 
-    n->GetExpression()->Accept(shared_from_this());
-    n->GetBlock()->Accept(shared_from_this());
+    // The expression is evaluated after the block
+    n.GetBlock()->Accept(*this);
+    n.GetExpression()->Accept(*this);
 
     this->PopScope();
 }
 
-void SemanticAnalyzer::Visit(const Ref<VariableUsageNode>& n)
+void SemanticAnalyzer::Visit(VariableUsageNode& n)
+{
+    this->currentType = this->ResolveVariable(n, n.GetName(), n);
+}
+
+void SemanticAnalyzer::Visit(VariableAssignNode& n)
 {
-    this->EnsureVariableDeclaration(n, n->GetName());
+    this->ResolveVariable(n, n.GetName(), n);
+
+    n.GetExpression()->Accept(*this);
 }
 
-void SemanticAnalyzer::Visit(const Ref<VariableAssignNode>& n)
+void SemanticAnalyzer::Visit(VariableArrayUsageNode& n)
 {
-    this->EnsureVariableDeclaration(n, n->GetName());
+    TokenType type = this->ResolveVariable(n, n.GetName(), n);
 
-    n->GetExpression()->Accept(shared_from_this());
+    this->currentType = IsVariableArrayType(type) ? GetArrayElementType(type) : TokenType::None;
 }
 
-void SemanticAnalyzer::Visit(const Ref<VariableArrayUsageNode>& n)
+void SemanticAnalyzer::Visit(VariableArrayAssignNode& n)
 {
-    this->EnsureVariableDeclaration(n, n->GetName());
+    this->ResolveVariable(n, n.GetName(), n);
+
+    n.GetExpression()->Accept(*this);
 }
 
-void SemanticAnalyzer::Visit(const Ref<VariableArrayAssignNode>& n)
+void SemanticAnalyzer::Visit(VariableIncrementDecrementNode& n)
 {
-    this->EnsureVariableDeclaration(n, n->GetName());
+    TokenType type = this->ResolveVariable(n, n.GetName(), n);
 
-    n->GetExpression()->Accept(shared_from_this());
+    n.SetTypedOperation(SpecializeIncrementDecrement(type));
 
-    this->currentScope->Add(VariableSymbol(n->GetName()));
+    this->currentType = n.GetTypedOperation() != nullptr ? type : TokenType::None;
 }
 
-void SemanticAnalyzer::Visit(const Ref<VariableIncrementDecrementNode>& n)
+void SemanticAnalyzer::Visit(VariableCompoundAssignNode& n)
 {
-    this->EnsureVariableDeclaration(n, n->GetName());
+    TokenType type = this->ResolveVariable(n, n.GetName(), n);
+
+    n.GetExpression()->Accept(*this);
+
+    // Strings can not be compound assigned, the interpreter reports them
+    if (IsNumberType(type))
+    {
+        n.SetTypedOperation(SpecializeArithmetic(n.GetOperation(), type, this->currentType));
+    }
 }
 
-void SemanticAnalyzer::Visit(const Ref<VariableCompoundAssignNode>& n)
+void SemanticAnalyzer::Visit(ReturnNode& n)
 {
-    this->EnsureVariableDeclaration(n, n->GetName());
+    n.GetExpression()->Accept(*this);
+
+    // Nothing is left to do in the function after the called one returns
+    FunctionCallNode* call = dynamic_cast<FunctionCallNode*>(n.GetExpression());
+    if (call != nullptr && call->GetFunction() != nullptr)
+    {
+        n.SetTailCall(call);
+    }
+}
+
+void SemanticAnalyzer::Visit(StringNode& n)
+{
+    for (auto& expression : n.GetExpressions())
+    {
+        expression->Accept(*this);
+    }
+
+    this->currentType = TokenType::String;
 }
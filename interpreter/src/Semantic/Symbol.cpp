@@ -7,8 +7,8 @@
 
 #include "Symbol.h"
 
-Symbol::Symbol(std::string  name)
-    : name(std::move(name))
+Symbol::Symbol(std::string  name, int slot, TokenType type)
+    : name(std::move(name)), slot(slot), type(type)
 {
 
 }
@@ -17,3 +17,13 @@ std::string Symbol::GetName() const
 {
     return this->name;
 }
+
+int Symbol::GetSlot() const
+{
+    return this->slot;
+}
+
+TokenType Symbol::GetType() const
+{
+    return this->type;
+}
@@ -7,8 +7,8 @@
 
 #include "VariableSymbol.h"
 
-VariableSymbol::VariableSymbol(std::string name)
-    : Symbol(std::move(name))
+VariableSymbol::VariableSymbol(std::string name, int slot, TokenType type)
+    : Symbol(std::move(name), slot, type)
 {
 
 }
@@ -6,24 +6,9 @@
  */
 
 #include "Token.h"
+#include "FileTable.h"
 
-Token::Token() 
-	: tokenType(TokenType::None), line(0)
+const std::string& Token::GetFileName() const
 {
-
+	return FileTable::GetName(this->fileId);
 }
-
-Token::Token(const TokenType& tokenType, std::string  value, std::string fileName, const int line)
-	: tokenType(tokenType), value(std::move(value)), fileName(std::move(fileName)), line(line)
-{
-}
-
-TokenType Token::GetTokenType() const
-{
-	return this->tokenType;
-}
-
-std::string Token::GetValue() const
-{
-	return this->value;
-}
\ No newline at end of file
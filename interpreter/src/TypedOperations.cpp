@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "TypedOperations.h"
+
+template <typename T>
+static BinaryOperation SpecializeArithmetic(TokenType operant)
+{
+	switch (operant)
+	{
+		case TokenType::Plus:
+			return Arithmetic<WrappingPlus<T>, T>;
+		case TokenType::Minus:
+			return Arithmetic<WrappingMinus<T>, T>;
+		case TokenType::Multiply:
+			return Arithmetic<WrappingMultiplies<T>, T>;
+		case TokenType::Divide:
+			return Arithmetic<std::divides<T>, T>;
+		default:
+			return nullptr;
+	}
+}
+
+template <typename L, typename R>
+static BinaryOperation SpecializeComparison(TokenType operant)
+{
+	switch (operant)
+	{
+		case TokenType::Equals:
+			return Comparison<std::equal_to<>, L, R>;
+		case TokenType::NotEquals:
+			return Comparison<std::not_equal_to<>, L, R>;
+		case TokenType::LessThan:
+			return Comparison<std::less<>, L, R>;
+		case TokenType::GreaterThan:
+			return Comparison<std::greater<>, L, R>;
+		case TokenType::LessEqualThan:
+			return Comparison<std::less_equal<>, L, R>;
+		case TokenType::GreaterEqualThan:
+			return Comparison<std::greater_equal<>, L, R>;
+		default:
+			return nullptr;
+	}
+}
+
+BinaryOperation SpecializeArithmetic(TokenType operant, TokenType left, TokenType right)
+{
+	if (left != right)
+	{
+		return nullptr;
+	}
+
+	switch (left)
+	{
+		case TokenType::Int:
+			return SpecializeArithmetic<int>(operant);
+		case TokenType::Float:
+			return SpecializeArithmetic<float>(operant);
+		case TokenType::Long:
+			return SpecializeArithmetic<int64_t>(operant);
+		case TokenType::Double:
+			return SpecializeArithmetic<double>(operant);
+		case TokenType::String:
+			// Other string operators are an error at runtime
+			return operant == TokenType::Plus ? StringConcat : nullptr;
+		default:
+			return nullptr;
+	}
+}
+
+template <typename L>
+static BinaryOperation SpecializeComparison(TokenType operant, TokenType right)
+{
+	switch (right)
+	{
+		case TokenType::Int:
+			return SpecializeComparison<L, int>(operant);
+		case TokenType::Float:
+			return SpecializeComparison<L, float>(operant);
+		case TokenType::Long:
+			return SpecializeComparison<L, int64_t>(operant);
+		case TokenType::Double:
+			return SpecializeComparison<L, double>(operant);
+		default:
+			return nullptr;
+	}
+}
+
+BinaryOperation SpecializeComparison(TokenType operant, TokenType left, TokenType right)
+{
+	if (left == TokenType::Int)
+	{
+		return SpecializeComparison<int>(operant, right);
+	}
+	else if (left == TokenType::Float)
+	{
+		return SpecializeComparison<float>(operant, right);
+	}
+	else if (left == TokenType::Long)
+	{
+		return SpecializeComparison<int64_t>(operant, right);
+	}
+	else if (left == TokenType::Double)
+	{
+		return SpecializeComparison<double>(operant, right);
+	}
+	else if (left == TokenType::String && right == TokenType::String)
+	{
+		if (operant == TokenType::Equals)
+		{
+			return StringComparison<std::equal_to<>>;
+		}
+		else if (operant == TokenType::NotEquals)
+		{
+			return StringComparison<std::not_equal_to<>>;
+		}
+	}
+
+	// Other types are never equal (and bools are not comparable), Value::Compare handles them
+	return nullptr;
+}
+
+IncrementOperation SpecializeIncrementDecrement(TokenType type)
+{
+	switch (type)
+	{
+		case TokenType::Int:
+			return IntIncrementDecrement;
+		case TokenType::Float:
+			return FloatIncrementDecrement;
+		case TokenType::Long:
+			return IncrementDecrement<int64_t>;
+		case TokenType::Double:
+			return IncrementDecrement<double>;
+		default:
+			return nullptr;
+	}
+}
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "Value.h"
+
+Value::Value(std::string value)
+	: type(TokenType::String), stringObject(new StringObject(std::move(value)))
+{
+
+}
+
+Value::Value(const char* value)
+	: Value(std::string(value))
+{
+
+}
+
+Value::Value(std::vector<int32_t> values)
+	: type(TokenType::IntArray), intArrayObject(new IntArrayObject(std::move(values)))
+{
+
+}
+
+Value::Value(std::vector<float> values)
+	: type(TokenType::FloatArray), floatArrayObject(new FloatArrayObject(std::move(values)))
+{
+
+}
+
+Value::Value(std::vector<bool> values)
+	: type(TokenType::BoolArray), boolArrayObject(new BoolArrayObject(std::move(values)))
+{
+
+}
+
+Value::Value(TokenType arrayType, std::vector<Value> values)
+	: type(TokenType::None), intValue(0)
+{
+	// Convert the element values into the dense storage of the array type
+	switch (arrayType)
+	{
+		case TokenType::IntArray:
+		{
+			std::vector<int32_t> ints;
+			ints.reserve(values.size());
+			for (const auto& value : values)
+			{
+				ints.push_back(value.GetInt());
+			}
+			*this = Value(std::move(ints));
+			break;
+		}
+		case TokenType::FloatArray:
+		{
+			std::vector<float> floats;
+			floats.reserve(values.size());
+			for (const auto& value : values)
+			{
+				floats.push_back(value.GetFloat());
+			}
+			*this = Value(std::move(floats));
+			break;
+		}
+		case TokenType::BoolArray:
+		{
+			std::vector<bool> bools;
+			bools.reserve(values.size());
+			for (const auto& value : values)
+			{
+				bools.push_back(value.GetBool());
+			}
+			*this = Value(std::move(bools));
+			break;
+		}
+		case TokenType::StringArray:
+		{
+			this->type = TokenType::StringArray;
+			this->stringArrayObject = new StringArrayObject(std::move(values));
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+template<typename L, typename R>
+static bool Compare(TokenType operant, L left, R right)
+{
+	switch (operant)
+	{
+		case TokenType::Equals:
+			return left == right;
+		case TokenType::NotEquals:
+			return left != right;
+		case TokenType::LessThan:
+			return left < right;
+		case TokenType::GreaterThan:
+			return left > right;
+		case TokenType::LessEqualThan:
+			return left <= right;
+		case TokenType::GreaterEqualThan:
+			return left >= right;
+		default:
+			return false;
+	}
+}
+
+// Numbers of all types are compared with the usual arithmetic conversions
+template<typename L>
+static bool CompareNumber(TokenType operant, L left, const Value& right)
+{
+	switch (right.GetType())
+	{
+		case TokenType::Int:
+			return ::Compare(operant, left, right.GetInt());
+		case TokenType::Float:
+			return ::Compare(operant, left, right.GetFloat());
+		case TokenType::Long:
+			return ::Compare(operant, left, right.GetLong());
+		case TokenType::Double:
+			return ::Compare(operant, left, right.GetDouble());
+		default:
+			return false;
+	}
+}
+
+bool Value::Compare(TokenType operant, const Value& other) const
+{
+	switch (this->type)
+	{
+		case TokenType::Int:
+			return CompareNumber(operant, this->intValue, other);
+		case TokenType::Float:
+			return CompareNumber(operant, this->floatValue, other);
+		case TokenType::Long:
+			return CompareNumber(operant, this->longValue, other);
+		case TokenType::Double:
+			return CompareNumber(operant, this->doubleValue, other);
+		case TokenType::String:
+			if (other.type != TokenType::String)
+			{
+				return false;
+			}
+			else if (operant == TokenType::Equals)
+			{
+				return GetString() == other.GetString();
+			}
+			else if (operant == TokenType::NotEquals)
+			{
+				return GetString() != other.GetString();
+			}
+			return false;
+		default:
+			return false;
+	}
+}
+
+template<typename T>
+static Value Arithmetic(TokenType operant, T left, T right)
+{
+	switch (operant)
+	{
+		case TokenType::Plus:
+			return Value(WrappingPlus<T>()(left, right));
+		case TokenType::Minus:
+			return Value(WrappingMinus<T>()(left, right));
+		case TokenType::Multiply:
+			return Value(WrappingMultiplies<T>()(left, right));
+		case TokenType::Divide:
+			return Value(left / right);
+		default:
+			return Value();
+	}
+}
+
+Value Value::Arithmetic(TokenType operant, const Value& other) const
+{
+	if (this->type != other.type)
+	{
+		return Value();
+	}
+
+	switch (this->type)
+	{
+		case TokenType::Int:
+			return ::Arithmetic(operant, this->intValue, other.intValue);
+		case TokenType::Float:
+			return ::Arithmetic(operant, this->floatValue, other.floatValue);
+		case TokenType::Long:
+			return ::Arithmetic(operant, this->longValue, other.longValue);
+		case TokenType::Double:
+			return ::Arithmetic(operant, this->doubleValue, other.doubleValue);
+		default:
+			return Value();
+	}
+}
+
+size_t Value::GetArraySize() const
+{
+	switch (this->type)
+	{
+		case TokenType::IntArray:
+			return this->intArrayObject->values.size();
+		case TokenType::FloatArray:
+			return this->floatArrayObject->values.size();
+		case TokenType::BoolArray:
+			return this->boolArrayObject->values.size();
+		case TokenType::StringArray:
+			return this->stringArrayObject->values.size();
+		default:
+			return 0;
+	}
+}
+
+Value Value::GetArrayElement(size_t index) const
+{
+	switch (this->type)
+	{
+		case TokenType::IntArray:
+			return Value(this->intArrayObject->values[index]);
+		case TokenType::FloatArray:
+			return Value(this->floatArrayObject->values[index]);
+		case TokenType::BoolArray:
+			return Value((bool) this->boolArrayObject->values[index]);
+		case TokenType::StringArray:
+			return this->stringArrayObject->values[index];
+		default:
+			return Value();
+	}
+}
+
+void Value::SetArrayElement(size_t index, const Value& value)
+{
+	if (this->heapObject->refCount > 1)
+	{
+		Detach();
+	}
+
+	switch (this->type)
+	{
+		case TokenType::IntArray:
+			this->intArrayObject->values[index] = value.GetInt();
+			break;
+		case TokenType::FloatArray:
+			this->floatArrayObject->values[index] = value.GetFloat();
+			break;
+		case TokenType::BoolArray:
+			this->boolArrayObject->values[index] = value.GetBool();
+			break;
+		case TokenType::StringArray:
+			this->stringArrayObject->values[index] = value;
+			break;
+		default:
+			break;
+	}
+}
+
+void Value::Detach()
+{
+	HeapObject* shared = this->heapObject;
+
+	switch (this->type)
+	{
+		case TokenType::String:
+			this->stringObject = new StringObject(this->stringObject->value);
+			break;
+		case TokenType::IntArray:
+			this->intArrayObject = new IntArrayObject(this->intArrayObject->values);
+			break;
+		case TokenType::FloatArray:
+			this->floatArrayObject = new FloatArrayObject(this->floatArrayObject->values);
+			break;
+		case TokenType::BoolArray:
+			this->boolArrayObject = new BoolArrayObject(this->boolArrayObject->values);
+			break;
+		case TokenType::StringArray:
+			this->stringArrayObject = new StringArrayObject(this->stringArrayObject->values);
+			break;
+		default:
+			return;
+	}
+
+	// The old storage is still referenced by other values
+	shared->refCount--;
+}
+
+void Value::Free()
+{
+	switch (this->type)
+	{
+		case TokenType::String:
+			delete this->stringObject;
+			break;
+		case TokenType::IntArray:
+			delete this->intArrayObject;
+			break;
+		case TokenType::FloatArray:
+			delete this->floatArrayObject;
+			break;
+		case TokenType::BoolArray:
+			delete this->boolArrayObject;
+			break;
+		case TokenType::StringArray:
+			delete this->stringArrayObject;
+			break;
+		default:
+			break;
+	}
+}
@@ -0,0 +1,756 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "Vm/BytecodeCompiler.h"
+#include "Standard.h"
+#include <chrono>
+
+BytecodeCompiler::BytecodeCompiler(const Ref<Node>& astRoot)
+	: Visitor(astRoot), program(std::make_shared<BytecodeProgram>())
+{
+	// Name zero is used by instructions which do not report a name
+	this->program->names.emplace_back();
+}
+
+Ref<BytecodeProgram> BytecodeCompiler::Compile()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	this->astRoot->Accept(*this);
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	IONA_LOG("\nCompiling took %llims (%llius)\n\n",
+		(long long) std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(),
+		(long long) std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+
+	return this->program;
+}
+
+size_t BytecodeCompiler::Emit(const Node& node, OpCode opCode, uint16_t a, uint16_t b, uint16_t c, uint8_t extra, uint32_t name)
+{
+	BytecodeFunction& function = GetFunction();
+
+	function.code.push_back({ opCode, extra, a, b, c });
+	function.infos.push_back({ node.GetLine(), name });
+
+	return function.code.size() - 1;
+}
+
+size_t BytecodeCompiler::EmitBx(const Node& node, OpCode opCode, uint16_t a, uint32_t bx, uint8_t extra, uint32_t name)
+{
+	size_t index = Emit(node, opCode, a, 0, 0, extra, name);
+	GetFunction().code[index].SetBx(bx);
+
+	return index;
+}
+
+void BytecodeCompiler::PatchJump(size_t index, size_t target)
+{
+	GetFunction().code[index].SetBx((uint32_t) target);
+}
+
+uint32_t BytecodeCompiler::AddConstant(Value value)
+{
+	this->program->constants.push_back(std::move(value));
+
+	return (uint32_t) this->program->constants.size() - 1;
+}
+
+uint32_t BytecodeCompiler::AddName(const std::string& name)
+{
+	auto result = this->nameIndices.find(name);
+	if (result != this->nameIndices.end())
+	{
+		return result->second;
+	}
+
+	this->program->names.push_back(name);
+	this->nameIndices.insert(std::pair<std::string, uint32_t>(name, this->program->names.size() - 1));
+
+	return (uint32_t) this->program->names.size() - 1;
+}
+
+uint32_t BytecodeCompiler::AddGlobal(const Node& node, const std::string& name)
+{
+	// Global element instructions address globals with a 16 bit operand
+	if (this->program->globals.size() >= UINT16_MAX)
+	{
+		Exit(node.GetFileName(), node.GetLine(), "Too many global variables, the maximum is %i", UINT16_MAX);
+	}
+
+	this->program->globals.push_back(name);
+	this->globalIndices.insert(std::pair<std::string, uint32_t>(name, this->program->globals.size() - 1));
+
+	return (uint32_t) this->program->globals.size() - 1;
+}
+
+uint32_t BytecodeCompiler::AddInternalFunction(const std::string& name)
+{
+	auto result = this->internalFunctionIndices.find(name);
+	if (result != this->internalFunctionIndices.end())
+	{
+		return result->second;
+	}
+
+	this->program->internalFunctions.push_back(name);
+	this->internalFunctionIndices.insert(std::pair<std::string, uint32_t>(name, this->program->internalFunctions.size() - 1));
+
+	return (uint32_t) this->program->internalFunctions.size() - 1;
+}
+
+void BytecodeCompiler::PushScope()
+{
+	this->scopes.emplace_back();
+	this->scopeLocalTops.push_back(this->localTop);
+}
+
+void BytecodeCompiler::PopScope()
+{
+	this->scopes.pop_back();
+
+	this->localTop = this->scopeLocalTops.back();
+	this->nextRegister = this->localTop;
+	this->scopeLocalTops.pop_back();
+}
+
+uint16_t BytecodeCompiler::DeclareLocal(const std::string& name, uint16_t reg)
+{
+	this->scopes.back()[name] = reg;
+	this->localTop = std::max(this->localTop, (uint16_t) (reg + 1));
+
+	return reg;
+}
+
+bool BytecodeCompiler::FindLocal(const std::string& name, uint16_t& reg) const
+{
+	for (size_t i = this->scopes.size(); i-- > 0; )
+	{
+		auto result = this->scopes[i].find(name);
+		if (result != this->scopes[i].end())
+		{
+			reg = result->second;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+uint16_t BytecodeCompiler::AllocateRegisters(const Node& node, size_t count)
+{
+	if (this->nextRegister + count >= NoRegister)
+	{
+		Exit(node.GetFileName(), node.GetLine(), "Function '%s' needs too many registers", GetFunction().name.c_str());
+	}
+
+	uint16_t first = this->nextRegister;
+	this->nextRegister += (uint16_t) count;
+
+	BytecodeFunction& function = GetFunction();
+	function.registerCount = std::max(function.registerCount, this->nextRegister);
+
+	return first;
+}
+
+uint16_t BytecodeCompiler::Target(const Node& node, uint16_t target)
+{
+	return target != NoRegister ? target : AllocateRegisters(node, 1);
+}
+
+bool BytecodeCompiler::IsTemporary(uint16_t reg) const
+{
+	return reg >= this->localTop;
+}
+
+uint16_t BytecodeCompiler::CompileExpression(Node* node, uint16_t target)
+{
+	this->destination = target;
+	node->Accept(*this);
+	this->destination = NoRegister;
+
+	return this->currentRegister;
+}
+
+void BytecodeCompiler::CompileExpressionInto(Node* node, uint16_t target)
+{
+	uint16_t reg = CompileExpression(node, target);
+
+	if (reg != target)
+	{
+		Emit(*node, OpCode::Move, target, reg, 0, IsTemporary(reg));
+	}
+}
+
+void BytecodeCompiler::CompileStatement(Node* node)
+{
+	CompileExpression(node);
+
+	// Temporary registers of the statement are not needed anymore
+	this->nextRegister = this->localTop;
+}
+
+void BytecodeCompiler::CompileScopedBlock(Node* block)
+{
+	PushScope();
+	block->Accept(*this);
+	PopScope();
+}
+
+void BytecodeCompiler::Visit(MainNode& n)
+{
+	auto& globalFunctions = n.GetGlobalFunctions();
+
+	// Function zero initializes the global variables and calls the main function
+	this->program->functions.emplace_back();
+	this->program->functions.back().name = "<global>";
+	this->program->fileName = globalFunctions[0]->GetFileName();
+
+	for (const auto& globalFunction : globalFunctions)
+	{
+		const FunctionNode& function = static_cast<const FunctionNode&>(*globalFunction);
+
+		this->functionIndices.insert(std::pair<std::string, uint32_t>(function.GetName(), this->program->functions.size()));
+		this->program->functions.emplace_back();
+		this->program->functions.back().name = function.GetName();
+		this->program->functions.back().parameterCount = (uint16_t) function.GetParameters().size();
+	}
+
+	AddGlobal(n, "ARGS");
+
+	for (auto& [name, value] : Iona::InternalVariables())
+	{
+		uint16_t reg = AllocateRegisters(n, 1);
+		EmitBx(n, OpCode::LoadConstant, reg, AddConstant(std::move(value)));
+		EmitBx(n, OpCode::SetGlobal, reg, AddGlobal(n, name), 1);
+
+		this->nextRegister = this->localTop;
+	}
+
+	for (const auto& globalVariable : n.GetGlobalVariables())
+	{
+		CompileStatement(globalVariable);
+	}
+
+	// Parser has ensured that there is a main function at index zero, so it is function one
+	const Node& main = *globalFunctions[0];
+	Emit(main, OpCode::Call, AllocateRegisters(main, 1), 1, 0);
+	Emit(main, OpCode::ReturnNone);
+
+	for (const auto& globalFunction : globalFunctions)
+	{
+		globalFunction->Accept(*this);
+	}
+}
+
+void BytecodeCompiler::Visit(FunctionNode& n)
+{
+	this->currentFunction = this->functionIndices.at(n.GetName());
+	this->localTop = 0;
+	this->nextRegister = 0;
+
+	PushScope();
+
+	// Parameters are passed in the first registers of the function
+	for (const auto& parameter : n.GetParameters())
+	{
+		DeclareLocal(parameter, AllocateRegisters(n, 1));
+	}
+
+	n.GetBlock()->Accept(*this);
+
+	Emit(n, OpCode::ReturnNone);
+
+	PopScope();
+}
+
+void BytecodeCompiler::Visit(BlockNode& n)
+{
+	for (auto& statement : n.GetStatements())
+	{
+		// Blocks are statements themselves where the optimizer removed the surrounding if
+		if (dynamic_cast<BlockNode*>(statement) != nullptr)
+		{
+			CompileScopedBlock(statement);
+		}
+		else
+		{
+			CompileStatement(statement);
+		}
+	}
+}
+
+void BytecodeCompiler::Visit(VariableDeclarationAssignNode& n)
+{
+	uint32_t name = AddName(n.GetName());
+
+	if (this->scopes.empty())
+	{
+		uint16_t reg = CompileExpression(n.GetExpression());
+
+		EmitBx(n, OpCode::DeclareGlobal, reg, AddGlobal(n, n.GetName()), IsTemporary(reg), name);
+		return;
+	}
+
+	uint16_t variable = AllocateRegisters(n, 1);
+	uint16_t reg = CompileExpression(n.GetExpression(), variable);
+
+	// Also emitted if the value is already in place, it still needs to be checked
+	Emit(n, OpCode::Declare, variable, reg, 0, reg != variable && IsTemporary(reg), name);
+
+	this->currentRegister = DeclareLocal(n.GetName(), variable);
+}
+
+void BytecodeCompiler::Visit(VariableArrayDeclarationAssignNode& n)
+{
+	uint32_t name = AddName(n.GetName());
+	const NodeList<Node*>& values = n.GetValues();
+
+	if (values.size() >= UINT16_MAX)
+	{
+		Exit(n.GetFileName(), n.GetLine(), "Array variable '%s' has too many values", n.GetName().c_str());
+	}
+
+	uint16_t variable = AllocateRegisters(n, 1);
+	uint16_t first = AllocateRegisters(n, values.size());
+
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		CompileExpressionInto(values[i], first + i);
+
+		// Literals of the element type do not need to be checked at runtime
+		bool literal = false;
+		switch (n.GetArrayType())
+		{
+			case TokenType::IntArray:
+				literal = dynamic_cast<IntNode*>(values[i]) != nullptr;
+				break;
+			case TokenType::FloatArray:
+				literal = dynamic_cast<FloatNode*>(values[i]) != nullptr;
+				break;
+			case TokenType::BoolArray:
+				literal = dynamic_cast<BoolNode*>(values[i]) != nullptr;
+				break;
+			case TokenType::StringArray:
+				literal = dynamic_cast<StringNode*>(values[i]) != nullptr;
+				break;
+			default:
+				break;
+		}
+
+		if (!literal)
+		{
+			Emit(n, OpCode::CheckElementType, first + i, 0, 0, n.GetArrayType(), name);
+		}
+	}
+
+	Emit(n, OpCode::NewArray, variable, first, (uint16_t) values.size(), n.GetArrayType());
+
+	if (this->scopes.empty())
+	{
+		EmitBx(n, OpCode::SetGlobal, variable, AddGlobal(n, n.GetName()), 1);
+		return;
+	}
+
+	this->currentRegister = DeclareLocal(n.GetName(), variable);
+}
+
+void BytecodeCompiler::Visit(FunctionCallNode& n)
+{
+	uint16_t target = this->destination;
+	const NodeList<Node*>& parameters = n.GetParameters();
+
+	// Arguments are evaluated into consecutive registers, which become the first registers of the called
+	// function. The result is returned in the first one.
+	uint16_t first = AllocateRegisters(n, std::max(parameters.size(), (size_t) 1));
+
+	for (size_t i = 0; i < parameters.size(); i++)
+	{
+		CompileExpressionInto(parameters[i], first + i);
+	}
+
+	auto result = this->functionIndices.find(n.GetName());
+	if (result != this->functionIndices.end())
+	{
+		Emit(n, OpCode::Call, first, (uint16_t) result->second, (uint16_t) parameters.size(), 0, AddName(n.GetName()));
+	}
+	else
+	{
+		Emit(n, OpCode::CallInternal, first, (uint16_t) AddInternalFunction(n.GetName()), (uint16_t) parameters.size(), n.AreTypesChecked());
+	}
+
+	this->currentRegister = first;
+
+	if (target != NoRegister)
+	{
+		Emit(n, OpCode::Move, target, first, 0, 1);
+		this->currentRegister = target;
+	}
+}
+
+void BytecodeCompiler::Visit(ForEachNode& n)
+{
+	uint16_t array = CompileExpression(n.GetExpression());
+
+	PushScope();
+
+	// The array is kept in a hidden register while looping, followed by the index and the loop variable
+	uint16_t first = AllocateRegisters(n, 3);
+	DeclareLocal(n.GetVariableName(), first + 2);
+
+	Emit(n, OpCode::Move, first, array, 0, IsTemporary(array));
+	size_t prepare = EmitBx(n, OpCode::ForEachPrepare, first, 0);
+	size_t body = GetFunction().code.size();
+
+	n.GetBlock()->Accept(*this);
+
+	EmitBx(n, OpCode::ForEachLoop, first, (uint32_t) body);
+	PatchJump(prepare, GetFunction().code.size());
+
+	PopScope();
+}
+
+void BytecodeCompiler::Visit(ForINode& n)
+{
+	PushScope();
+
+	// The counter, the end and the step are kept in hidden registers, followed by the loop variable
+	uint16_t first = AllocateRegisters(n, 4);
+	DeclareLocal(n.GetVariableName(), first + 3);
+
+	EmitBx(n, OpCode::LoadConstant, first, AddConstant(Value(n.GetFrom())));
+	EmitBx(n, OpCode::LoadConstant, first + 1, AddConstant(Value(n.GetTo())));
+	EmitBx(n, OpCode::LoadConstant, first + 2, AddConstant(Value(n.GetStep())));
+	size_t prepare = EmitBx(n, OpCode::ForIPrepare, first, 0);
+	size_t body = GetFunction().code.size();
+
+	n.GetBlock()->Accept(*this);
+
+	EmitBx(n, OpCode::ForILoop, first, (uint32_t) body);
+	PatchJump(prepare, GetFunction().code.size());
+
+	PopScope();
+}
+
+void BytecodeCompiler::Visit(StringNode& n)
+{
+	uint16_t target = Target(n, this->destination);
+	const NodeList<Node*>& expressions = n.GetExpressions();
+
+	EmitBx(n, OpCode::LoadConstant, target, AddConstant(Value(n.GetValue())));
+
+	if (!expressions.empty())
+	{
+		uint16_t first = AllocateRegisters(n, expressions.size());
+
+		for (size_t i = 0; i < expressions.size(); i++)
+		{
+			CompileExpressionInto(expressions[i], first + i);
+		}
+
+		Emit(n, OpCode::Interpolate, target, first, (uint16_t) expressions.size());
+	}
+
+	this->currentRegister = target;
+}
+
+void BytecodeCompiler::Visit(IntNode& n)
+{
+	this->currentRegister = Target(n, this->destination);
+	EmitBx(n, OpCode::LoadConstant, this->currentRegister, AddConstant(Value(n.GetValue())));
+}
+
+void BytecodeCompiler::Visit(FloatNode& n)
+{
+	this->currentRegister = Target(n, this->destination);
+	EmitBx(n, OpCode::LoadConstant, this->currentRegister, AddConstant(Value(n.GetValue())));
+}
+
+void BytecodeCompiler::Visit(LongNode& n)
+{
+	this->currentRegister = Target(n, this->destination);
+	EmitBx(n, OpCode::LoadConstant, this->currentRegister, AddConstant(Value(n.GetValue())));
+}
+
+void BytecodeCompiler::Visit(DoubleNode& n)
+{
+	this->currentRegister = Target(n, this->destination);
+	EmitBx(n, OpCode::LoadConstant, this->currentRegister, AddConstant(Value(n.GetValue())));
+}
+
+void BytecodeCompiler::Visit(BoolNode& n)
+{
+	this->currentRegister = Target(n, this->destination);
+	EmitBx(n, OpCode::LoadConstant, this->currentRegister, AddConstant(Value(n.GetValue())));
+}
+
+void BytecodeCompiler::Visit(VariableUsageNode& n)
+{
+	uint16_t reg;
+	if (FindLocal(n.GetName(), reg))
+	{
+		// Locals are used directly from their register
+		this->currentRegister = reg;
+		return;
+	}
+
+	this->currentRegister = Target(n, this->destination);
+	EmitBx(n, OpCode::GetGlobal, this->currentRegister, this->globalIndices.at(n.GetName()));
+}
+
+void BytecodeCompiler::Visit(VariableIncrementDecrementNode& n)
+{
+	uint32_t name = AddName(n.GetName());
+
+	uint16_t reg;
+	if (FindLocal(n.GetName(), reg))
+	{
+		Emit(n, OpCode::Increment, reg, (uint16_t) (int16_t) n.GetValue(), 0, 0, name);
+		this->currentRegister = reg;
+		return;
+	}
+
+	uint32_t global = this->globalIndices.at(n.GetName());
+
+	this->currentRegister = Target(n, this->destination);
+	EmitBx(n, OpCode::GetGlobal, this->currentRegister, global);
+	Emit(n, OpCode::Increment, this->currentRegister, (uint16_t) (int16_t) n.GetValue(), 0, 0, name);
+	EmitBx(n, OpCode::SetGlobal, this->currentRegister, global);
+}
+
+void BytecodeCompiler::Visit(VariableAssignNode& n)
+{
+	uint32_t name = AddName(n.GetName());
+	uint16_t value = CompileExpression(n.GetExpression());
+
+	uint16_t reg;
+	if (FindLocal(n.GetName(), reg))
+	{
+		Emit(n, OpCode::Assign, reg, value, 0, IsTemporary(value), name);
+		this->currentRegister = reg;
+		return;
+	}
+
+	EmitBx(n, OpCode::AssignGlobal, value, this->globalIndices.at(n.GetName()), IsTemporary(value), name);
+}
+
+void BytecodeCompiler::Visit(VariableCompoundAssignNode& n)
+{
+	uint32_t name = AddName(n.GetName());
+	uint16_t value = CompileExpression(n.GetExpression());
+
+	uint16_t reg;
+	if (FindLocal(n.GetName(), reg))
+	{
+		Emit(n, OpCode::CompoundAssign, reg, value, 0, n.GetOperation(), name);
+		this->currentRegister = reg;
+		return;
+	}
+
+	uint32_t global = this->globalIndices.at(n.GetName());
+
+	this->currentRegister = AllocateRegisters(n, 1);
+	EmitBx(n, OpCode::GetGlobal, this->currentRegister, global);
+	Emit(n, OpCode::CompoundAssign, this->currentRegister, value, 0, n.GetOperation(), name);
+	EmitBx(n, OpCode::SetGlobal, this->currentRegister, global);
+}
+
+void BytecodeCompiler::Visit(BinaryNode& n)
+{
+	uint16_t target = this->destination;
+
+	uint16_t left = CompileExpression(n.GetLeft());
+
+	// The right side could change the variable of the left side (eg. a + a++), so its value is copied before
+	if (!IsTemporary(left) && dynamic_cast<VariableUsageNode*>(n.GetRight()) == nullptr
+		&& dynamic_cast<IntNode*>(n.GetRight()) == nullptr
+		&& dynamic_cast<FloatNode*>(n.GetRight()) == nullptr
+		&& dynamic_cast<LongNode*>(n.GetRight()) == nullptr
+		&& dynamic_cast<DoubleNode*>(n.GetRight()) == nullptr)
+	{
+		uint16_t copy = AllocateRegisters(n, 1);
+		Emit(n, OpCode::Move, copy, left);
+		left = copy;
+	}
+
+	uint16_t right = CompileExpression(n.GetRight());
+
+	OpCode opCode;
+	switch (n.GetOperant())
+	{
+		case TokenType::Plus:
+			opCode = OpCode::Add;
+			break;
+		case TokenType::Minus:
+			opCode = OpCode::Subtract;
+			break;
+		case TokenType::Multiply:
+			opCode = OpCode::Multiply;
+			break;
+		default:
+			opCode = OpCode::Divide;
+			break;
+	}
+
+	this->currentRegister = Target(n, target);
+	Emit(n, opCode, this->currentRegister, left, right);
+}
+
+void BytecodeCompiler::Visit(BooleanNode& n)
+{
+	uint16_t target = this->destination;
+
+	uint16_t left = CompileExpression(n.GetLeft());
+
+	if (!IsTemporary(left) && dynamic_cast<VariableUsageNode*>(n.GetRight()) == nullptr
+		&& dynamic_cast<IntNode*>(n.GetRight()) == nullptr
+		&& dynamic_cast<FloatNode*>(n.GetRight()) == nullptr
+		&& dynamic_cast<LongNode*>(n.GetRight()) == nullptr
+		&& dynamic_cast<DoubleNode*>(n.GetRight()) == nullptr)
+	{
+		uint16_t copy = AllocateRegisters(n, 1);
+		Emit(n, OpCode::Move, copy, left);
+		left = copy;
+	}
+
+	uint16_t right = CompileExpression(n.GetRight());
+
+	this->currentRegister = Target(n, target);
+	Emit(n, OpCode::Compare, this->currentRegister, left, right, n.GetOperant());
+}
+
+void BytecodeCompiler::Visit(VariableArrayUsageNode& n)
+{
+	uint16_t target = Target(n, this->destination);
+	uint16_t index = AllocateRegisters(n, 1);
+
+	EmitBx(n, OpCode::LoadConstant, index, AddConstant(Value((int) n.GetIndex())));
+
+	uint16_t reg;
+	if (FindLocal(n.GetName(), reg))
+	{
+		Emit(n, OpCode::GetElement, target, reg, index);
+	}
+	else
+	{
+		Emit(n, OpCode::GetGlobalElement, target, (uint16_t) this->globalIndices.at(n.GetName()), index);
+	}
+
+	this->currentRegister = target;
+}
+
+void BytecodeCompiler::Visit(VariableArrayAssignNode& n)
+{
+	uint32_t name = AddName(n.GetName());
+	uint16_t value = CompileExpression(n.GetExpression());
+	uint16_t index = AllocateRegisters(n, 1);
+
+	EmitBx(n, OpCode::LoadConstant, index, AddConstant(Value((int) n.GetIndex())));
+
+	uint16_t reg;
+	if (FindLocal(n.GetName(), reg))
+	{
+		Emit(n, OpCode::SetElement, reg, index, value, 0, name);
+	}
+	else
+	{
+		Emit(n, OpCode::SetGlobalElement, (uint16_t) this->globalIndices.at(n.GetName()), index, value, 0, name);
+	}
+}
+
+void BytecodeCompiler::Visit(IfNode& n)
+{
+	std::vector<size_t> jumpsToEnd;
+
+	uint16_t condition = CompileExpression(n.GetExpression());
+	size_t jumpToNext = EmitBx(n, OpCode::JumpIfFalse, condition, 0, 1);
+
+	CompileScopedBlock(n.GetTrueBlock());
+
+	for (const auto& [expression, block] : n.GetElseIfBlocks())
+	{
+		jumpsToEnd.push_back(EmitBx(n, OpCode::Jump, 0, 0));
+		PatchJump(jumpToNext, GetFunction().code.size());
+
+		condition = CompileExpression(expression);
+		jumpToNext = EmitBx(*expression, OpCode::JumpIfFalse, condition, 0);
+
+		CompileScopedBlock(block);
+	}
+
+	if (n.GetElseBlock() != nullptr)
+	{
+		jumpsToEnd.push_back(EmitBx(n, OpCode::Jump, 0, 0));
+		PatchJump(jumpToNext, GetFunction().code.size());
+
+		CompileScopedBlock(n.GetElseBlock());
+	}
+	else
+	{
+		PatchJump(jumpToNext, GetFunction().code.size());
+	}
+
+	for (size_t jump : jumpsToEnd)
+	{
+		PatchJump(jump, GetFunction().code.size());
+	}
+}
+
+void BytecodeCompiler::Visit(WhileNode& n)
+{
+	PushScope();
+
+	size_t start = GetFunction().code.size();
+
+	uint16_t condition = CompileExpression(n.GetExpression());
+	size_t jumpToEnd = EmitBx(n, OpCode::JumpIfFalse, condition, 0, 2);
+
+	n.GetBlock()->Accept(*this);
+
+	EmitBx(n, OpCode::Jump, 0, (uint32_t) start);
+	PatchJump(jumpToEnd, GetFunction().code.size());
+
+	PopScope();
+}
+
+void BytecodeCompiler::Visit(DoWhileNode& n)
+{
+	PushScope();
+
+	size_t start = GetFunction().code.size();
+
+	n.GetBlock()->Accept(*this);
+
+	uint16_t condition = CompileExpression(n.GetExpression());
+	size_t jumpToEnd = EmitBx(n, OpCode::JumpIfFalse, condition, 0, 3);
+
+	EmitBx(n, OpCode::Jump, 0, (uint32_t) start);
+	PatchJump(jumpToEnd, GetFunction().code.size());
+
+	PopScope();
+}
+
+void BytecodeCompiler::Visit(ReturnNode& n)
+{
+	if (FunctionCallNode* call = n.GetTailCall())
+	{
+		const NodeList<Node*>& parameters = call->GetParameters();
+		uint16_t first = AllocateRegisters(n, std::max(parameters.size(), (size_t) 1));
+
+		for (size_t i = 0; i < parameters.size(); i++)
+		{
+			CompileExpressionInto(parameters[i], first + i);
+		}
+
+		Emit(*call, OpCode::TailCall, first, (uint16_t) this->functionIndices.at(call->GetName()), (uint16_t) parameters.size(), 0, AddName(call->GetName()));
+		return;
+	}
+
+	uint16_t value = CompileExpression(n.GetExpression());
+
+	Emit(n, OpCode::Return, value);
+}
@@ -0,0 +1,758 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "Vm/Jit.h"
+#include "Vm/X64Assembler.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#define IONA_JIT_SUPPORTED
+#endif
+
+// Types of the registers at an instruction, None if the register has no type the machine code can use
+using RegisterTypes = std::vector<TokenType>;
+
+static bool IsArithmeticType(TokenType type)
+{
+	return type == TokenType::Int || type == TokenType::Float;
+}
+
+static bool IsScalarType(TokenType type)
+{
+	return type == TokenType::Int || type == TokenType::Float || type == TokenType::Bool;
+}
+
+static bool IsJitArrayType(TokenType type)
+{
+	return type == TokenType::IntArray || type == TokenType::FloatArray;
+}
+
+static bool IsComparison(TokenType operant)
+{
+	switch (operant)
+	{
+		case TokenType::Equals:
+		case TokenType::NotEquals:
+		case TokenType::LessThan:
+		case TokenType::GreaterThan:
+		case TokenType::LessEqualThan:
+		case TokenType::GreaterEqualThan:
+			return true;
+		default:
+			return false;
+	}
+}
+
+static TokenType GetArithmeticOperant(const Instruction& instruction)
+{
+	switch (instruction.opCode)
+	{
+		case OpCode::Add:
+			return TokenType::Plus;
+		case OpCode::Subtract:
+			return TokenType::Minus;
+		case OpCode::Multiply:
+			return TokenType::Multiply;
+		case OpCode::Divide:
+			return TokenType::Divide;
+		default:
+			return (TokenType) instruction.extra;
+	}
+}
+
+// Writes the type of a register. Arrays are never overwritten, the machine code keeps pointers to their elements.
+static bool Write(RegisterTypes& types, uint16_t reg, TokenType type)
+{
+	if (IsJitArrayType(types[reg]))
+	{
+		return false;
+	}
+
+	types[reg] = type;
+	return true;
+}
+
+// Computes the types after the instruction, the false branch of conditional jumps and the fall
+// through of loops get the types in jumpTypes. Returns false if the instruction can not be compiled.
+static bool Propagate(const Instruction& instruction, const Value* constants, RegisterTypes& types, RegisterTypes& jumpTypes)
+{
+	uint16_t a = instruction.a;
+	uint16_t b = instruction.b;
+	uint16_t c = instruction.c;
+
+	switch (instruction.opCode)
+	{
+		case OpCode::LoadConstant:
+		{
+			TokenType type = constants[instruction.GetBx()].GetType();
+			return IsScalarType(type) && Write(types, a, type);
+		}
+		case OpCode::Move:
+		case OpCode::Declare:
+		case OpCode::Assign:
+		{
+			TokenType type = types[b];
+			// Assignments of other types are an error the virtual machine reports
+			if (!IsScalarType(type) || (instruction.opCode == OpCode::Assign && types[a] != type) || !Write(types, a, type))
+			{
+				return false;
+			}
+
+			if (instruction.extra && a != b)
+			{
+				types[b] = TokenType::None;
+			}
+			return true;
+		}
+		case OpCode::Add:
+		case OpCode::Subtract:
+		case OpCode::Multiply:
+		case OpCode::Divide:
+			return IsArithmeticType(types[b]) && types[b] == types[c] && Write(types, a, types[b]);
+		case OpCode::Compare:
+			return IsArithmeticType(types[b]) && types[b] == types[c] && IsComparison((TokenType) instruction.extra)
+				&& Write(types, a, TokenType::Bool);
+		case OpCode::Increment:
+			return IsArithmeticType(types[a]);
+		case OpCode::CompoundAssign:
+		{
+			TokenType operant = (TokenType) instruction.extra;
+			return IsArithmeticType(types[a]) && types[a] == types[b] && (operant == TokenType::Plus
+				|| operant == TokenType::Minus || operant == TokenType::Multiply || operant == TokenType::Divide);
+		}
+		case OpCode::Jump:
+			return true;
+		case OpCode::JumpIfFalse:
+			jumpTypes = types;
+			return types[a] == TokenType::Bool;
+		case OpCode::GetElement:
+			return IsJitArrayType(types[b]) && types[c] == TokenType::Int && Write(types, a, GetArrayElementType(types[b]));
+		case OpCode::SetElement:
+			return IsJitArrayType(types[a]) && types[b] == TokenType::Int && types[c] == GetArrayElementType(types[a]);
+		case OpCode::ForIPrepare:
+			jumpTypes = types;
+			return types[a] == TokenType::Int && types[a + 1] == TokenType::Int && Write(types, a + 3, TokenType::Int);
+		case OpCode::ForILoop:
+			jumpTypes = types;
+			return types[a] == TokenType::Int && types[a + 1] == TokenType::Int && types[a + 2] == TokenType::Int
+				&& Write(types, a + 3, TokenType::Int);
+		default:
+			return false;
+	}
+}
+
+// Registers an instruction reads or writes
+static void Touch(const Instruction& instruction, std::vector<bool>& touched)
+{
+	switch (instruction.opCode)
+	{
+		case OpCode::LoadConstant:
+		case OpCode::Increment:
+		case OpCode::JumpIfFalse:
+			touched[instruction.a] = true;
+			break;
+		case OpCode::Move:
+		case OpCode::Declare:
+		case OpCode::Assign:
+		case OpCode::CompoundAssign:
+			touched[instruction.a] = true;
+			touched[instruction.b] = true;
+			break;
+		case OpCode::ForIPrepare:
+		case OpCode::ForILoop:
+			for (uint16_t i = 0; i < 4; i++)
+			{
+				touched[instruction.a + i] = true;
+			}
+			break;
+		case OpCode::Jump:
+			break;
+		default:
+			touched[instruction.a] = true;
+			touched[instruction.b] = true;
+			touched[instruction.c] = true;
+			break;
+	}
+}
+
+Jit::Jit(const Ref<BytecodeProgram>& program)
+	: program(program), functions(program->functions.size())
+{
+}
+
+Jit::~Jit()
+{
+#ifdef IONA_JIT_SUPPORTED
+	for (const auto& [address, size] : this->memory)
+	{
+		munmap(address, size);
+	}
+#endif
+}
+
+bool Jit::IsSupported()
+{
+#ifdef IONA_JIT_SUPPORTED
+	return true;
+#else
+	return false;
+#endif
+}
+
+int32_t Jit::TypeOffset(uint16_t reg)
+{
+	return (int32_t) (reg * sizeof(Value) + offsetof(Value, type));
+}
+
+int32_t Jit::PayloadOffset(uint16_t reg)
+{
+	return (int32_t) (reg * sizeof(Value) + offsetof(Value, intValue));
+}
+
+uint32_t Jit::BackEdge(uint32_t function, uint32_t header, uint32_t backEdge, Value* registers)
+{
+	FunctionCounters& counters = this->functions[function];
+	JitLoop& loop = counters.loops[header];
+
+	if (loop.function == nullptr)
+	{
+		if (loop.failed || (++loop.backEdges < LoopThreshold && counters.invocations < FunctionThreshold))
+		{
+			return header;
+		}
+
+		loop.compilations++;
+		if (!Compile(this->program->functions[function], loop, header, backEdge, registers))
+		{
+			loop.failed = true;
+			return header;
+		}
+
+		this->compiledLoops++;
+	}
+
+	if (!Enter(loop, registers))
+	{
+		this->deoptimizations++;
+
+		// The types changed, the loop gets compiled again for them once it is hot again
+		if (++loop.guardFailures >= MaxGuardFailures)
+		{
+			loop.function = nullptr;
+			loop.backEdges = 0;
+			loop.guardFailures = 0;
+			loop.failed = loop.compilations >= MaxCompilations;
+		}
+		return header;
+	}
+
+	this->entries++;
+	loop.entries++;
+
+	uint32_t next = loop.function(registers, this->arrays.data());
+	if (next & Deoptimized)
+	{
+		this->deoptimizations++;
+		loop.deoptimizations++;
+		next &= ~Deoptimized;
+
+		// Leaving in the middle of most iterations costs more than the compiled part saves
+		if (loop.entries >= MinEntries && loop.deoptimizations * 2 > loop.entries)
+		{
+			loop.function = nullptr;
+			loop.failed = true;
+		}
+	}
+
+	return next;
+}
+
+bool Jit::Enter(JitLoop& loop, Value* registers)
+{
+	for (const auto& [reg, type] : loop.guards)
+	{
+		if (registers[reg].type != type)
+		{
+			return false;
+		}
+	}
+
+	// Overwriting them with numbers must not leak a string or an array
+	for (uint16_t reg : loop.scalars)
+	{
+		if (registers[reg].IsHeapType())
+		{
+			return false;
+		}
+	}
+
+	this->arrays.clear();
+	for (const auto& [reg, written] : loop.arrays)
+	{
+		const Value& array = registers[reg];
+
+		// Shared arrays get copied on write, the virtual machine handles that
+		if (written && array.heapObject->refCount > 1)
+		{
+			return false;
+		}
+
+		if (array.type == TokenType::IntArray)
+		{
+			std::vector<int32_t>& values = array.intArrayObject->values;
+			this->arrays.push_back({ values.data(), std::min(values.size(), (size_t) UINT32_MAX) });
+		}
+		else
+		{
+			std::vector<float>& values = array.floatArrayObject->values;
+			this->arrays.push_back({ values.data(), std::min(values.size(), (size_t) UINT32_MAX) });
+		}
+	}
+
+	return true;
+}
+
+JitLoopFunction Jit::Install(const std::vector<uint8_t>& code)
+{
+#ifdef IONA_JIT_SUPPORTED
+	void* address = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (address == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	std::memcpy(address, code.data(), code.size());
+	if (mprotect(address, code.size(), PROT_READ | PROT_EXEC) != 0)
+	{
+		munmap(address, code.size());
+		return nullptr;
+	}
+
+	this->memory.emplace_back(address, code.size());
+	return reinterpret_cast<JitLoopFunction>(address);
+#else
+	return nullptr;
+#endif
+}
+
+bool Jit::Compile(const BytecodeFunction& function, JitLoop& loop, uint32_t header, uint32_t backEdge, const Value* registers)
+{
+	if (!IsSupported())
+	{
+		return false;
+	}
+
+	const Value* constants = this->program->constants.data();
+	const Instruction* code = function.code.data();
+	uint32_t count = backEdge - header + 1;
+
+	// The types of the registers at each instruction of the loop, starting with the current ones at the header
+	std::vector<RegisterTypes> states(count);
+	std::vector<bool> reached(count);
+	std::vector<bool> sideExits(count);
+	std::vector<bool> touched(function.registerCount);
+
+	RegisterTypes& entry = states[0];
+	for (uint16_t i = 0; i < function.registerCount; i++)
+	{
+		TokenType type = registers[i].GetType();
+		entry.push_back(IsScalarType(type) || IsJitArrayType(type) ? type : TokenType::None);
+	}
+	reached[0] = true;
+
+	std::vector<uint32_t> worklist { header };
+	while (!worklist.empty())
+	{
+		uint32_t index = worklist.back();
+		worklist.pop_back();
+
+		const Instruction& instruction = code[index];
+		RegisterTypes types = states[index - header];
+		RegisterTypes jumpTypes;
+		if (!Propagate(instruction, constants, types, jumpTypes))
+		{
+			// The virtual machine executes the instruction and the rest of the iteration
+			sideExits[index - header] = true;
+			continue;
+		}
+
+		auto merge = [&](uint32_t target, const RegisterTypes& targetTypes)
+		{
+			// Leaving the loop continues in the virtual machine
+			if (target < header || target > backEdge)
+			{
+				return;
+			}
+
+			RegisterTypes& state = states[target - header];
+			if (!reached[target - header])
+			{
+				reached[target - header] = true;
+				state = targetTypes;
+				worklist.push_back(target);
+				return;
+			}
+
+			bool changed = false;
+			for (size_t i = 0; i < state.size(); i++)
+			{
+				if (state[i] != targetTypes[i] && state[i] != TokenType::None)
+				{
+					state[i] = TokenType::None;
+					changed = true;
+				}
+			}
+
+			if (changed)
+			{
+				worklist.push_back(target);
+			}
+		};
+
+		switch (instruction.opCode)
+		{
+			case OpCode::Jump:
+				merge(instruction.GetBx(), types);
+				break;
+			case OpCode::JumpIfFalse:
+			case OpCode::ForIPrepare:
+				merge(index + 1, types);
+				merge(instruction.GetBx(), jumpTypes);
+				break;
+			case OpCode::ForILoop:
+				merge(instruction.GetBx(), types);
+				merge(index + 1, jumpTypes);
+				break;
+			default:
+				merge(index + 1, types);
+				break;
+		}
+	}
+
+	if (sideExits[0])
+	{
+		return false;
+	}
+
+	for (uint32_t i = header; i <= backEdge; i++)
+	{
+		if (reached[i - header] && !sideExits[i - header])
+		{
+			Touch(code[i], touched);
+		}
+	}
+
+	loop.guards.clear();
+	loop.scalars.clear();
+	loop.arrays.clear();
+
+	// The header has the types the loop was compiled for, they are checked when it is entered
+	for (uint16_t i = 0; i < function.registerCount; i++)
+	{
+		if (!touched[i])
+		{
+			continue;
+		}
+
+		if (states[0][i] != TokenType::None)
+		{
+			loop.guards.emplace_back(i, states[0][i]);
+		}
+		else
+		{
+			loop.scalars.push_back(i);
+		}
+	}
+
+	X64Assembler assembler;
+	std::vector<size_t> labels(count);
+	// Positions of jumps and the instruction they go to, with the deoptimization flag if they leave the loop to fail
+	std::vector<std::pair<size_t, uint32_t>> jumps;
+	std::vector<int> arrayIndices(function.registerCount, -1);
+
+	auto getArray = [&](uint16_t reg, bool written)
+	{
+		if (arrayIndices[reg] == -1)
+		{
+			arrayIndices[reg] = (int) loop.arrays.size();
+			loop.arrays.emplace_back(reg, written);
+		}
+
+		loop.arrays[arrayIndices[reg]].second |= written;
+		return (int32_t) (arrayIndices[reg] * sizeof(JitArray));
+	};
+
+	const X64Register rax = X64Register::Rax;
+	const X64Register rcx = X64Register::Rcx;
+	const X64Register rdx = X64Register::Rdx;
+	const X64Register arrays = X64Register::Rsi;
+	const X64Register values = X64Register::Rdi;
+	const int32_t arraySize = (int32_t) offsetof(JitArray, size);
+
+	for (uint32_t index = header; index <= backEdge; index++)
+	{
+		labels[index - header] = assembler.GetSize();
+		if (!reached[index - header])
+		{
+			continue;
+		}
+
+		if (sideExits[index - header])
+		{
+			jumps.emplace_back(assembler.Jump(), index | Deoptimized);
+			continue;
+		}
+
+		const Instruction& instruction = code[index];
+		const RegisterTypes& types = states[index - header];
+		uint16_t a = instruction.a;
+		uint16_t b = instruction.b;
+		uint16_t c = instruction.c;
+
+		// Only the type of a register which could have another one needs to be written
+		auto setType = [&](uint16_t reg, TokenType type)
+		{
+			if (types[reg] != type)
+			{
+				assembler.StoreImmediate8(values, TypeOffset(reg), (uint8_t) type);
+			}
+		};
+
+		auto arithmetic = [&](TokenType operant, TokenType type, uint16_t destination, uint16_t left, uint16_t right)
+		{
+			if (type == TokenType::Float)
+			{
+				static const X64Arithmetic operations[] = { X64Arithmetic::AddFloat, X64Arithmetic::SubtractFloat,
+					X64Arithmetic::MultiplyFloat, X64Arithmetic::DivideFloat };
+				X64Arithmetic operation = operations[operant == TokenType::Plus ? 0 : operant == TokenType::Minus ? 1 : operant == TokenType::Multiply ? 2 : 3];
+
+				assembler.LoadFloat(0, values, PayloadOffset(left));
+				assembler.FloatArithmetic(operation, 0, values, PayloadOffset(right));
+				assembler.StoreFloat(values, PayloadOffset(destination), 0);
+			}
+			else if (operant == TokenType::Divide)
+			{
+				// Division by zero and the overflow of INT_MIN / -1 would trap, the virtual machine executes them
+				assembler.Load32(rcx, values, PayloadOffset(right));
+				assembler.CompareImmediate8(rcx, 0);
+				jumps.emplace_back(assembler.JumpIf(X64Condition::Equal), index | Deoptimized);
+				assembler.CompareImmediate8(rcx, -1);
+				jumps.emplace_back(assembler.JumpIf(X64Condition::Equal), index | Deoptimized);
+				assembler.Load32(rax, values, PayloadOffset(left));
+				assembler.SignExtend();
+				assembler.Divide32(rcx);
+				assembler.Store32(values, PayloadOffset(destination), rax);
+			}
+			else
+			{
+				assembler.Load32(rax, values, PayloadOffset(left));
+				if (operant == TokenType::Multiply)
+				{
+					assembler.Multiply32(rax, values, PayloadOffset(right));
+				}
+				else
+				{
+					assembler.Arithmetic32(operant == TokenType::Plus ? X64Arithmetic::Add : X64Arithmetic::Subtract, rax, values, PayloadOffset(right));
+				}
+				assembler.Store32(values, PayloadOffset(destination), rax);
+			}
+
+			setType(destination, type);
+		};
+
+		switch (instruction.opCode)
+		{
+			case OpCode::LoadConstant:
+			{
+				const Value& constant = constants[instruction.GetBx()];
+				int32_t bits = 0;
+				if (constant.GetType() == TokenType::Int)
+				{
+					bits = constant.GetInt();
+				}
+				else if (constant.GetType() == TokenType::Float)
+				{
+					float value = constant.GetFloat();
+					std::memcpy(&bits, &value, sizeof(bits));
+				}
+				else
+				{
+					bits = constant.GetBool();
+				}
+
+				assembler.StoreImmediate32(values, PayloadOffset(a), bits);
+				setType(a, constant.GetType());
+				break;
+			}
+			case OpCode::Move:
+			case OpCode::Declare:
+			case OpCode::Assign:
+				assembler.Load32(rax, values, PayloadOffset(b));
+				assembler.Store32(values, PayloadOffset(a), rax);
+				setType(a, types[b]);
+				if (instruction.extra && a != b)
+				{
+					assembler.StoreImmediate8(values, TypeOffset(b), (uint8_t) TokenType::None);
+				}
+				break;
+			case OpCode::Add:
+			case OpCode::Subtract:
+			case OpCode::Multiply:
+			case OpCode::Divide:
+				arithmetic(GetArithmeticOperant(instruction), types[b], a, b, c);
+				break;
+			case OpCode::CompoundAssign:
+				arithmetic(GetArithmeticOperant(instruction), types[a], a, a, b);
+				break;
+			case OpCode::Compare:
+			{
+				TokenType operant = (TokenType) instruction.extra;
+				if (types[b] == TokenType::Int)
+				{
+					static const X64Condition conditions[] = { X64Condition::Equal, X64Condition::NotEqual, X64Condition::Less,
+						X64Condition::Greater, X64Condition::LessEqual, X64Condition::GreaterEqual };
+					X64Condition condition = operant == TokenType::Equals ? conditions[0] : operant == TokenType::NotEquals ? conditions[1]
+						: operant == TokenType::LessThan ? conditions[2] : operant == TokenType::GreaterThan ? conditions[3]
+						: operant == TokenType::LessEqualThan ? conditions[4] : conditions[5];
+
+					assembler.Load32(rax, values, PayloadOffset(b));
+					assembler.Arithmetic32(X64Arithmetic::Compare, rax, values, PayloadOffset(c));
+					assembler.SetCondition(condition, rax);
+				}
+				else if (operant == TokenType::Equals || operant == TokenType::NotEquals)
+				{
+					// Unordered (NaN) operands are not equal
+					bool equals = operant == TokenType::Equals;
+					assembler.LoadFloat(0, values, PayloadOffset(b));
+					assembler.CompareFloat(0, values, PayloadOffset(c));
+					assembler.SetCondition(equals ? X64Condition::Equal : X64Condition::NotEqual, rax);
+					assembler.SetCondition(equals ? X64Condition::NoParity : X64Condition::Parity, rcx);
+					if (equals)
+					{
+						assembler.And8(rax, rcx);
+					}
+					else
+					{
+						assembler.Or8(rax, rcx);
+					}
+				}
+				else
+				{
+					// Above and above or equal are false for unordered operands, less than compares swapped
+					bool swapped = operant == TokenType::LessThan || operant == TokenType::LessEqualThan;
+					bool orEqual = operant == TokenType::LessEqualThan || operant == TokenType::GreaterEqualThan;
+					assembler.LoadFloat(0, values, PayloadOffset(swapped ? c : b));
+					assembler.CompareFloat(0, values, PayloadOffset(swapped ? b : c));
+					assembler.SetCondition(orEqual ? X64Condition::AboveEqual : X64Condition::Above, rax);
+				}
+
+				assembler.Store8(values, PayloadOffset(a), rax);
+				setType(a, TokenType::Bool);
+				break;
+			}
+			case OpCode::Increment:
+				if (types[a] == TokenType::Int)
+				{
+					assembler.Load32(rax, values, PayloadOffset(a));
+					assembler.AddImmediate32(rax, (int16_t) b);
+					assembler.Store32(values, PayloadOffset(a), rax);
+				}
+				else
+				{
+					float value = (float) (int16_t) b;
+					int32_t bits;
+					std::memcpy(&bits, &value, sizeof(bits));
+
+					assembler.LoadFloat(0, values, PayloadOffset(a));
+					assembler.MoveImmediate32(rax, bits);
+					assembler.MoveToFloat(1, rax);
+					assembler.FloatArithmetic(X64Arithmetic::AddFloat, 0, 1);
+					assembler.StoreFloat(values, PayloadOffset(a), 0);
+				}
+				break;
+			case OpCode::Jump:
+				jumps.emplace_back(assembler.Jump(), instruction.GetBx());
+				break;
+			case OpCode::JumpIfFalse:
+				assembler.CompareMemoryImmediate8(values, PayloadOffset(a), 0);
+				jumps.emplace_back(assembler.JumpIf(X64Condition::Equal), instruction.GetBx());
+				break;
+			case OpCode::GetElement:
+			{
+				int32_t array = getArray(b, false);
+				assembler.Load32(rax, values, PayloadOffset(c));
+				assembler.Arithmetic32(X64Arithmetic::Compare, rax, arrays, array + arraySize);
+				jumps.emplace_back(assembler.JumpIf(X64Condition::AboveEqual), index | Deoptimized);
+				assembler.Load64(rcx, arrays, array);
+				assembler.LoadIndexed32(rdx, rcx, rax);
+				assembler.Store32(values, PayloadOffset(a), rdx);
+				setType(a, GetArrayElementType(types[b]));
+				break;
+			}
+			case OpCode::SetElement:
+			{
+				int32_t array = getArray(a, true);
+				assembler.Load32(rax, values, PayloadOffset(b));
+				assembler.Arithmetic32(X64Arithmetic::Compare, rax, arrays, array + arraySize);
+				jumps.emplace_back(assembler.JumpIf(X64Condition::AboveEqual), index | Deoptimized);
+				assembler.Load64(rcx, arrays, array);
+				assembler.Load32(rdx, values, PayloadOffset(c));
+				assembler.StoreIndexed32(rcx, rax, rdx);
+				break;
+			}
+			case OpCode::ForIPrepare:
+				assembler.Load32(rax, values, PayloadOffset(a));
+				assembler.Arithmetic32(X64Arithmetic::Compare, rax, values, PayloadOffset(a + 1));
+				jumps.emplace_back(assembler.JumpIf(X64Condition::GreaterEqual), instruction.GetBx());
+				assembler.Store32(values, PayloadOffset(a + 3), rax);
+				setType(a + 3, TokenType::Int);
+				break;
+			case OpCode::ForILoop:
+				assembler.Load32(rax, values, PayloadOffset(a));
+				assembler.Arithmetic32(X64Arithmetic::Add, rax, values, PayloadOffset(a + 2));
+				assembler.Store32(values, PayloadOffset(a), rax);
+				assembler.Arithmetic32(X64Arithmetic::Compare, rax, values, PayloadOffset(a + 1));
+				jumps.emplace_back(assembler.JumpIf(X64Condition::GreaterEqual), index + 1);
+				assembler.Store32(values, PayloadOffset(a + 3), rax);
+				setType(a + 3, TokenType::Int);
+				jumps.emplace_back(assembler.Jump(), instruction.GetBx());
+				break;
+			default:
+				break;
+		}
+	}
+
+	jumps.emplace_back(assembler.Jump(), backEdge + 1);
+
+	// Jumps out of the loop return the instruction the virtual machine continues with
+	std::map<uint32_t, size_t> exits;
+	for (const auto& [position, target] : jumps)
+	{
+		uint32_t instruction = target & ~Deoptimized;
+		if (target == instruction && instruction >= header && instruction <= backEdge)
+		{
+			assembler.Patch(position, labels[instruction - header]);
+			continue;
+		}
+
+		auto exit = exits.find(target);
+		if (exit == exits.end())
+		{
+			exit = exits.emplace(target, assembler.GetSize()).first;
+			assembler.MoveImmediate32(rax, (int32_t) target);
+			assembler.Return();
+		}
+
+		assembler.Patch(position, exit->second);
+	}
+
+	loop.function = Install(assembler.GetCode());
+	return loop.function != nullptr;
+}
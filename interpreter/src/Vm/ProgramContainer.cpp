@@ -0,0 +1,529 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "Vm/ProgramContainer.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <type_traits>
+#include "MappedFile.h"
+
+static constexpr char Magic[4] = { 'I', 'O', 'N', 'C' };
+// Needs to be increased with every change of the layout or of the instructions
+static constexpr uint32_t Version = 2;
+
+struct ContainerHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t instructionSize;
+	uint32_t fileName;
+	uint32_t stringCount;
+	uint32_t stringDataSize;
+	uint32_t constantCount;
+	uint32_t nameCount;
+	uint32_t globalCount;
+	uint32_t internalFunctionCount;
+	uint32_t functionCount;
+};
+
+// Numbers and bools are stored by their bits, strings by their index in the string table
+struct ContainerConstant
+{
+	uint32_t type;
+	uint32_t padding;
+	uint64_t value;
+};
+
+struct ContainerFunction
+{
+	uint32_t name;
+	uint16_t parameterCount;
+	uint16_t registerCount;
+	uint32_t codeCount;
+};
+
+static_assert(std::is_trivially_copyable<Instruction>::value && std::is_trivially_copyable<InstructionInfo>::value,
+	"Instructions are stored as they are in memory");
+
+static size_t Aligned(size_t size)
+{
+	return (size + 3) & ~(size_t) 3;
+}
+
+class StringTable
+{
+private:
+	std::map<std::string, uint32_t> indices;
+	std::vector<const std::string*> strings;
+public:
+	uint32_t Add(const std::string& value)
+	{
+		auto result = this->indices.emplace(value, (uint32_t) this->strings.size());
+		if (result.second)
+		{
+			this->strings.push_back(&result.first->first);
+		}
+
+		return result.first->second;
+	}
+
+	const std::vector<const std::string*>& GetStrings() const
+	{
+		return this->strings;
+	}
+};
+
+template<typename T>
+static void WriteItems(std::ostream& stream, const T* items, size_t count)
+{
+	static const char padding[4] = { };
+
+	stream.write(reinterpret_cast<const char*>(items), (std::streamsize) (sizeof(T) * count));
+	stream.write(padding, (std::streamsize) (Aligned(sizeof(T) * count) - sizeof(T) * count));
+}
+
+static std::vector<uint32_t> AddStrings(StringTable& strings, const std::vector<std::string>& values)
+{
+	std::vector<uint32_t> indices;
+	indices.reserve(values.size());
+	for (const auto& value : values)
+	{
+		indices.push_back(strings.Add(value));
+	}
+
+	return indices;
+}
+
+void ProgramContainer::Write(const BytecodeProgram& program, std::ostream& stream)
+{
+	StringTable strings;
+	uint32_t fileName = strings.Add(program.fileName);
+
+	std::vector<ContainerConstant> constants;
+	constants.reserve(program.constants.size());
+	for (const auto& value : program.constants)
+	{
+		ContainerConstant constant = { (uint32_t) value.GetType(), 0, 0 };
+		switch (value.GetType())
+		{
+			case TokenType::Int:
+				constant.value = (uint32_t) value.GetInt();
+				break;
+			case TokenType::Float:
+			{
+				float floatValue = value.GetFloat();
+				std::memcpy(&constant.value, &floatValue, sizeof(float));
+				break;
+			}
+			case TokenType::Long:
+				constant.value = (uint64_t) value.GetLong();
+				break;
+			case TokenType::Double:
+			{
+				double doubleValue = value.GetDouble();
+				std::memcpy(&constant.value, &doubleValue, sizeof(double));
+				break;
+			}
+			case TokenType::Bool:
+				constant.value = value.GetBool();
+				break;
+			case TokenType::String:
+				constant.value = strings.Add(value.GetString());
+				break;
+			default:
+				Exit(program.fileName, 0, "Constants of type %s can not be stored in a container", Helper::ToString(value.GetType()).c_str());
+		}
+		constants.push_back(constant);
+	}
+
+	std::vector<uint32_t> names = AddStrings(strings, program.names);
+	std::vector<uint32_t> globals = AddStrings(strings, program.globals);
+	std::vector<uint32_t> internalFunctions = AddStrings(strings, program.internalFunctions);
+
+	std::vector<ContainerFunction> functions;
+	functions.reserve(program.functions.size());
+	for (const auto& function : program.functions)
+	{
+		functions.push_back({ strings.Add(function.name), function.parameterCount, function.registerCount, (uint32_t) function.code.size() });
+	}
+
+	std::vector<uint32_t> stringOffsets = { 0 };
+	std::string stringData;
+	for (const auto* value : strings.GetStrings())
+	{
+		stringData.append(*value);
+		stringOffsets.push_back((uint32_t) stringData.size());
+	}
+
+	ContainerHeader header = { };
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	header.version = Version;
+	header.instructionSize = sizeof(Instruction);
+	header.fileName = fileName;
+	header.stringCount = (uint32_t) strings.GetStrings().size();
+	header.stringDataSize = (uint32_t) stringData.size();
+	header.constantCount = (uint32_t) constants.size();
+	header.nameCount = (uint32_t) names.size();
+	header.globalCount = (uint32_t) globals.size();
+	header.internalFunctionCount = (uint32_t) internalFunctions.size();
+	header.functionCount = (uint32_t) functions.size();
+
+	WriteItems(stream, &header, 1);
+	WriteItems(stream, stringOffsets.data(), stringOffsets.size());
+	WriteItems(stream, stringData.data(), stringData.size());
+	WriteItems(stream, constants.data(), constants.size());
+	WriteItems(stream, names.data(), names.size());
+	WriteItems(stream, globals.data(), globals.size());
+	WriteItems(stream, internalFunctions.data(), internalFunctions.size());
+	WriteItems(stream, functions.data(), functions.size());
+	for (const auto& function : program.functions)
+	{
+		WriteItems(stream, function.code.data(), function.code.size());
+		WriteItems(stream, function.infos.data(), function.infos.size());
+	}
+}
+
+// Reads the sections of a container in order, every read is checked against the size of the file
+class ContainerReader
+{
+private:
+	const std::string& fileName;
+	const char* data;
+	size_t size;
+	size_t offset = 0;
+public:
+	ContainerReader(const std::string& fileName, const char* data, size_t size)
+		: fileName(fileName), data(data), size(size)
+	{
+	}
+
+	template<typename T>
+	void Read(T* items, size_t count)
+	{
+		CheckRemaining<T>(count);
+
+		size_t bytes = sizeof(T) * count;
+		std::memcpy(items, this->data + this->offset, bytes);
+		this->offset = std::min(this->size, this->offset + Aligned(bytes));
+	}
+
+	// The count is checked before anything is allocated, so a corrupted count can not request a huge vector
+	template<typename T>
+	std::vector<T> Read(size_t count)
+	{
+		CheckRemaining<T>(count);
+
+		std::vector<T> items(count);
+		Read(items.data(), count);
+
+		return items;
+	}
+
+	template<typename T>
+	void CheckRemaining(size_t count) const
+	{
+		if (count > (this->size - this->offset) / sizeof(T))
+		{
+			Fail("is truncated");
+		}
+	}
+
+	void Fail(const char* reason) const
+	{
+		Exit(this->fileName, 0, "Program container %s", reason);
+	}
+};
+
+static std::vector<std::string> ResolveStrings(const ContainerReader& reader, const std::vector<std::string>& strings, const std::vector<uint32_t>& indices)
+{
+	std::vector<std::string> values;
+	values.reserve(indices.size());
+	for (uint32_t index : indices)
+	{
+		if (index >= strings.size())
+		{
+			reader.Fail("refers to a string which does not exist");
+		}
+		values.push_back(strings[index]);
+	}
+
+	return values;
+}
+
+// The virtual machine trusts the operands of the instructions, so every one of them is checked once
+// against the registers of its function and the tables of the program before anything is executed
+static void ValidateFunction(const ContainerReader& reader, const BytecodeProgram& program, const BytecodeFunction& function)
+{
+	const std::vector<Instruction>& code = function.code;
+	if (code.empty())
+	{
+		reader.Fail("has a function without instructions");
+	}
+
+	// Execution needs to leave a function before it runs past its last instruction
+	switch (code.back().opCode)
+	{
+		case OpCode::Jump:
+		case OpCode::TailCall:
+		case OpCode::Return:
+		case OpCode::ReturnNone:
+			break;
+		default:
+			reader.Fail("has a function which does not end with a return");
+	}
+
+	if (function.parameterCount > function.registerCount)
+	{
+		reader.Fail("has a function with more parameters than registers");
+	}
+
+	// Registers a to a + count - 1 need to be in the frame of the function
+	auto registers = [&](size_t a, size_t count = 1)
+	{
+		if (a + count > function.registerCount)
+		{
+			reader.Fail("has an instruction with a register out of range");
+		}
+	};
+	auto index = [&](size_t value, size_t count, const char* reason)
+	{
+		if (value >= count)
+		{
+			reader.Fail(reason);
+		}
+	};
+	auto arrayType = [&](uint8_t type)
+	{
+		if (!IsVariableArrayType((TokenType) type))
+		{
+			reader.Fail("has an instruction with an invalid array type");
+		}
+	};
+
+	static const char* jumpTarget = "has a jump to an instruction which does not exist";
+	static const char* global = "refers to a global variable which does not exist";
+
+	for (size_t i = 0; i < code.size(); i++)
+	{
+		const Instruction& instruction = code[i];
+		index(function.infos[i].name, program.names.size(), "refers to a name which does not exist");
+
+		switch (instruction.opCode)
+		{
+			case OpCode::LoadConstant:
+				registers(instruction.a);
+				index(instruction.GetBx(), program.constants.size(), "refers to a constant which does not exist");
+				break;
+			case OpCode::Move:
+			case OpCode::Declare:
+			case OpCode::Assign:
+			case OpCode::CompoundAssign:
+				registers(instruction.a);
+				registers(instruction.b);
+				break;
+			case OpCode::GetGlobal:
+			case OpCode::SetGlobal:
+			case OpCode::DeclareGlobal:
+			case OpCode::AssignGlobal:
+				registers(instruction.a);
+				index(instruction.GetBx(), program.globals.size(), global);
+				break;
+			case OpCode::Add:
+			case OpCode::Subtract:
+			case OpCode::Multiply:
+			case OpCode::Divide:
+			case OpCode::Compare:
+			case OpCode::GetElement:
+			case OpCode::SetElement:
+				registers(instruction.a);
+				registers(instruction.b);
+				registers(instruction.c);
+				break;
+			case OpCode::Increment:
+				registers(instruction.a);
+				break;
+			case OpCode::Jump:
+				index(instruction.GetBx(), code.size(), jumpTarget);
+				break;
+			case OpCode::JumpIfFalse:
+				registers(instruction.a);
+				// Index into the kinds of expressions reported by the virtual machine
+				index(instruction.extra, 4, "has a jump with an unknown kind of expression");
+				index(instruction.GetBx(), code.size(), jumpTarget);
+				break;
+			case OpCode::NewArray:
+				registers(instruction.a);
+				registers(instruction.b, instruction.c);
+				arrayType(instruction.extra);
+				break;
+			case OpCode::CheckElementType:
+				registers(instruction.a);
+				arrayType(instruction.extra);
+				break;
+			case OpCode::GetGlobalElement:
+				registers(instruction.a);
+				index(instruction.b, program.globals.size(), global);
+				registers(instruction.c);
+				break;
+			case OpCode::SetGlobalElement:
+				index(instruction.a, program.globals.size(), global);
+				registers(instruction.b);
+				registers(instruction.c);
+				break;
+			case OpCode::ForEachPrepare:
+			case OpCode::ForEachLoop:
+				registers(instruction.a, 3);
+				index(instruction.GetBx(), code.size(), jumpTarget);
+				break;
+			case OpCode::ForIPrepare:
+			case OpCode::ForILoop:
+				registers(instruction.a, 4);
+				index(instruction.GetBx(), code.size(), jumpTarget);
+				break;
+			case OpCode::Interpolate:
+				registers(instruction.a);
+				registers(instruction.b, instruction.c);
+				break;
+			case OpCode::Call:
+			case OpCode::TailCall:
+				// The result of a call is written to register a, even without arguments
+				registers(instruction.a);
+				registers(instruction.a, instruction.c);
+				index(instruction.b, program.functions.size(), "refers to a function which does not exist");
+				break;
+			case OpCode::CallInternal:
+				registers(instruction.a);
+				registers(instruction.a, instruction.c);
+				index(instruction.b, program.internalFunctions.size(), "refers to an internal function which does not exist");
+				break;
+			case OpCode::Return:
+				registers(instruction.a);
+				break;
+			case OpCode::ReturnNone:
+				break;
+			default:
+				reader.Fail("has an instruction with an unknown operation");
+		}
+	}
+}
+
+static Ref<BytecodeProgram> ReadProgram(const std::string& fileName, const char* data, size_t size)
+{
+	ContainerReader reader(fileName, data, size);
+
+	ContainerHeader header;
+	reader.Read(&header, 1);
+
+	if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+	{
+		reader.Fail("is not a compiled iona program");
+	}
+
+	if (header.version != Version || header.instructionSize != sizeof(Instruction))
+	{
+		reader.Fail("was compiled by a different version of iona, compile it again with ionac");
+	}
+
+	if (header.stringCount == std::numeric_limits<uint32_t>::max())
+	{
+		reader.Fail("has an invalid string table");
+	}
+
+	std::vector<uint32_t> stringOffsets = reader.Read<uint32_t>((size_t) header.stringCount + 1);
+	std::vector<char> stringData = reader.Read<char>(header.stringDataSize);
+
+	std::vector<std::string> strings;
+	strings.reserve(header.stringCount);
+	for (size_t i = 0; i < header.stringCount; i++)
+	{
+		if (stringOffsets[i] > stringOffsets[i + 1] || stringOffsets[i + 1] > stringData.size())
+		{
+			reader.Fail("has an invalid string table");
+		}
+		strings.emplace_back(stringData.data() + stringOffsets[i], stringOffsets[i + 1] - stringOffsets[i]);
+	}
+
+	Ref<BytecodeProgram> program = std::make_shared<BytecodeProgram>();
+	program->fileName = ResolveStrings(reader, strings, { header.fileName })[0];
+
+	program->constants.reserve(header.constantCount);
+	for (const auto& constant : reader.Read<ContainerConstant>(header.constantCount))
+	{
+		switch ((TokenType) constant.type)
+		{
+			case TokenType::Int:
+				program->constants.emplace_back((int) (uint32_t) constant.value);
+				break;
+			case TokenType::Float:
+			{
+				float value;
+				std::memcpy(&value, &constant.value, sizeof(float));
+				program->constants.emplace_back(value);
+				break;
+			}
+			case TokenType::Long:
+				program->constants.emplace_back((int64_t) constant.value);
+				break;
+			case TokenType::Double:
+			{
+				double value;
+				std::memcpy(&value, &constant.value, sizeof(double));
+				program->constants.emplace_back(value);
+				break;
+			}
+			case TokenType::Bool:
+				program->constants.emplace_back(constant.value != 0);
+				break;
+			case TokenType::String:
+				program->constants.emplace_back(ResolveStrings(reader, strings, { (uint32_t) constant.value })[0]);
+				break;
+			default:
+				reader.Fail("has a constant of an unknown type");
+		}
+	}
+
+	program->names = ResolveStrings(reader, strings, reader.Read<uint32_t>(header.nameCount));
+	program->globals = ResolveStrings(reader, strings, reader.Read<uint32_t>(header.globalCount));
+	program->internalFunctions = ResolveStrings(reader, strings, reader.Read<uint32_t>(header.internalFunctionCount));
+
+	std::vector<ContainerFunction> functions = reader.Read<ContainerFunction>(header.functionCount);
+	if (functions.empty())
+	{
+		reader.Fail("has no functions");
+	}
+
+	program->functions.resize(functions.size());
+	for (size_t i = 0; i < functions.size(); i++)
+	{
+		BytecodeFunction& function = program->functions[i];
+		function.name = ResolveStrings(reader, strings, { functions[i].name })[0];
+		function.parameterCount = functions[i].parameterCount;
+		function.registerCount = functions[i].registerCount;
+		function.code = reader.Read<Instruction>(functions[i].codeCount);
+		function.infos = reader.Read<InstructionInfo>(functions[i].codeCount);
+	}
+
+	for (const auto& function : program->functions)
+	{
+		ValidateFunction(reader, *program, function);
+	}
+
+	return program;
+}
+
+Ref<BytecodeProgram> ProgramContainer::Load(const std::string& fileName)
+{
+	MappedFile file(fileName);
+	if (!file.IsValid())
+	{
+		Exit(fileName, 0, "Program container could not be read");
+	}
+
+	return ReadProgram(fileName, file.GetContent().data(), file.GetContent().size());
+}
@@ -0,0 +1,595 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "Vm/VirtualMachine.h"
+#include "Standard.h"
+#include <chrono>
+
+VirtualMachine::VirtualMachine(const std::vector<std::string>& args, const Ref<BytecodeProgram>& program)
+	: program(program)
+{
+	for (const auto& name : program->internalFunctions)
+	{
+		const FunctionEntry* entry = FunctionRegistry::Internal().Find(name);
+		if (entry == nullptr)
+		{
+			Exit(program->fileName, 0, "Internal function '%s' does not exist", name.c_str());
+		}
+
+		this->resolvedInternalFunctions.push_back(entry);
+	}
+
+	this->globals.resize(program->globals.size());
+
+	std::vector<Value> argsValues;
+	argsValues.reserve(args.size());
+	for (auto& arg : args)
+	{
+		argsValues.emplace_back(arg);
+	}
+	this->globals.at(0) = Value(TokenType::StringArray, std::move(argsValues));
+
+	this->stack.resize(1024);
+}
+
+void VirtualMachine::SetJit(bool enabled)
+{
+	this->jit = enabled && Jit::IsSupported() ? std::make_shared<Jit>(this->program) : nullptr;
+}
+
+void VirtualMachine::Run()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	Execute();
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	IONA_LOG("\n\nInterpreting took %llims (%llius)\n",
+		(long long) std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(),
+		(long long) std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+}
+
+const std::string& VirtualMachine::GetName(const Instruction& instruction) const
+{
+	const BytecodeFunction& function = *this->frames.back().function;
+	return this->program->names[function.infos[&instruction - function.code.data()].name];
+}
+
+Value VirtualMachine::Arithmetic(const Instruction& instruction, TokenType operant, const Value& left, const Value& right)
+{
+	if (left.GetType() == TokenType::String && right.GetType() == TokenType::String)
+	{
+		if (operant != TokenType::Plus)
+		{
+			Fail(instruction, "Invalid arithmetic string operator '%s'", Helper::ToString(operant).c_str());
+		}
+
+		return Value(left.GetString() + right.GetString());
+	}
+
+	// Mixed types do not have a result
+	return left.Arithmetic(operant, right);
+}
+
+void VirtualMachine::CompoundAssign(const Instruction& instruction, Value& variable, const Value& value)
+{
+	// We only need to check for same type, because the variable needs to be declared
+	// so it was already checked that it's a valid variable type
+	if (value.GetType() != variable.GetType())
+	{
+		Fail(instruction, "New value of variable '%s' needs to be of type '%s', but is '%s'",
+			GetName(instruction).c_str(), Helper::ToString(variable.GetType()).c_str(), Helper::ToString(value.GetType()).c_str());
+	}
+
+	if (!IsNumberType(variable.GetType()))
+	{
+		Fail(instruction, "Variable increment assignments are only supported with int, float, long and double type, but got %s",
+			Helper::ToString(variable.GetType()).c_str());
+	}
+
+	variable = Arithmetic(instruction, (TokenType) instruction.extra, variable, value);
+}
+
+void VirtualMachine::Execute()
+{
+	const BytecodeFunction* function = &this->program->functions[0];
+	const Value* constants = this->program->constants.data();
+	Jit* jit = this->jit.get();
+
+	this->frames.push_back({ function, nullptr, 0 });
+
+	if (this->stack.size() < function->registerCount)
+	{
+		this->stack.resize(function->registerCount);
+	}
+
+	Value* registers = this->stack.data();
+	const Instruction* code = function->code.data();
+	const Instruction* pc = code;
+
+	while (true)
+	{
+		const Instruction& instruction = *pc++;
+
+		switch (instruction.opCode)
+		{
+			case OpCode::LoadConstant:
+				registers[instruction.a] = constants[instruction.GetBx()];
+				break;
+			case OpCode::Move:
+				if (instruction.extra)
+				{
+					registers[instruction.a] = std::move(registers[instruction.b]);
+				}
+				else
+				{
+					registers[instruction.a] = registers[instruction.b];
+				}
+				break;
+			case OpCode::Declare:
+			{
+				Value& value = registers[instruction.b];
+				if (!IsVariableType(value.GetType()))
+				{
+					Fail(instruction, "Type '%s' of variable '%s' is not a valid variable type",
+						Helper::ToString(value.GetType()).c_str(), GetName(instruction).c_str());
+				}
+
+				if (instruction.extra)
+				{
+					registers[instruction.a] = std::move(value);
+				}
+				else
+				{
+					registers[instruction.a] = value;
+				}
+				break;
+			}
+			case OpCode::Assign:
+			{
+				Value& variable = registers[instruction.a];
+				Value& value = registers[instruction.b];
+				if (value.GetType() != variable.GetType())
+				{
+					Fail(instruction, "New value of variable '%s' needs to be of type '%s', but is '%s'",
+						GetName(instruction).c_str(), Helper::ToString(variable.GetType()).c_str(), Helper::ToString(value.GetType()).c_str());
+				}
+
+				if (instruction.extra)
+				{
+					variable = std::move(value);
+				}
+				else
+				{
+					variable = value;
+				}
+				break;
+			}
+			case OpCode::GetGlobal:
+				registers[instruction.a] = this->globals[instruction.GetBx()];
+				break;
+			case OpCode::SetGlobal:
+				if (instruction.extra)
+				{
+					this->globals[instruction.GetBx()] = std::move(registers[instruction.a]);
+				}
+				else
+				{
+					this->globals[instruction.GetBx()] = registers[instruction.a];
+				}
+				break;
+			case OpCode::DeclareGlobal:
+			{
+				Value& value = registers[instruction.a];
+				if (!IsVariableType(value.GetType()))
+				{
+					Fail(instruction, "Type '%s' of variable '%s' is not a valid variable type",
+						Helper::ToString(value.GetType()).c_str(), GetName(instruction).c_str());
+				}
+
+				if (instruction.extra)
+				{
+					this->globals[instruction.GetBx()] = std::move(value);
+				}
+				else
+				{
+					this->globals[instruction.GetBx()] = value;
+				}
+				break;
+			}
+			case OpCode::AssignGlobal:
+			{
+				Value& variable = this->globals[instruction.GetBx()];
+				Value& value = registers[instruction.a];
+				if (value.GetType() != variable.GetType())
+				{
+					Fail(instruction, "New value of variable '%s' needs to be of type '%s', but is '%s'",
+						GetName(instruction).c_str(), Helper::ToString(variable.GetType()).c_str(), Helper::ToString(value.GetType()).c_str());
+				}
+
+				if (instruction.extra)
+				{
+					variable = std::move(value);
+				}
+				else
+				{
+					variable = value;
+				}
+				break;
+			}
+			case OpCode::Add:
+			{
+				const Value& left = registers[instruction.b];
+				const Value& right = registers[instruction.c];
+				if (left.GetType() == TokenType::Int && right.GetType() == TokenType::Int)
+				{
+					registers[instruction.a] = Value(WrappingPlus<int>()(left.GetInt(), right.GetInt()));
+				}
+				else
+				{
+					registers[instruction.a] = Arithmetic(instruction, TokenType::Plus, left, right);
+				}
+				break;
+			}
+			case OpCode::Subtract:
+			{
+				const Value& left = registers[instruction.b];
+				const Value& right = registers[instruction.c];
+				if (left.GetType() == TokenType::Int && right.GetType() == TokenType::Int)
+				{
+					registers[instruction.a] = Value(WrappingMinus<int>()(left.GetInt(), right.GetInt()));
+				}
+				else
+				{
+					registers[instruction.a] = Arithmetic(instruction, TokenType::Minus, left, right);
+				}
+				break;
+			}
+			case OpCode::Multiply:
+			{
+				const Value& left = registers[instruction.b];
+				const Value& right = registers[instruction.c];
+				if (left.GetType() == TokenType::Int && right.GetType() == TokenType::Int)
+				{
+					registers[instruction.a] = Value(WrappingMultiplies<int>()(left.GetInt(), right.GetInt()));
+				}
+				else
+				{
+					registers[instruction.a] = Arithmetic(instruction, TokenType::Multiply, left, right);
+				}
+				break;
+			}
+			case OpCode::Divide:
+				registers[instruction.a] = Arithmetic(instruction, TokenType::Divide, registers[instruction.b], registers[instruction.c]);
+				break;
+			case OpCode::Compare:
+			{
+				const Value& left = registers[instruction.b];
+				const Value& right = registers[instruction.c];
+				if (left.GetType() == TokenType::Int && right.GetType() == TokenType::Int && instruction.extra == TokenType::LessThan)
+				{
+					registers[instruction.a] = Value(left.GetInt() < right.GetInt());
+				}
+				else
+				{
+					registers[instruction.a] = Value(left.Compare((TokenType) instruction.extra, right));
+				}
+				break;
+			}
+			case OpCode::Increment:
+			{
+				Value& variable = registers[instruction.a];
+				if (variable.GetType() == TokenType::Int)
+				{
+					variable = Value(WrappingPlus<int>()(variable.GetInt(), (int16_t) instruction.b));
+				}
+				else if (variable.GetType() == TokenType::Float)
+				{
+					variable = Value(variable.GetFloat() + (float) (int16_t) instruction.b);
+				}
+				else if (variable.GetType() == TokenType::Long)
+				{
+					variable = Value(WrappingPlus<int64_t>()(variable.GetLong(), (int16_t) instruction.b));
+				}
+				else if (variable.GetType() == TokenType::Double)
+				{
+					variable = Value(variable.GetDouble() + (int16_t) instruction.b);
+				}
+				else
+				{
+					Fail(instruction, "Variable increments are only supported with int, float, long and double type, but got %s",
+						Helper::ToString(variable.GetType()).c_str());
+				}
+				break;
+			}
+			case OpCode::CompoundAssign:
+				CompoundAssign(instruction, registers[instruction.a], registers[instruction.b]);
+				break;
+			case OpCode::Jump:
+				pc = code + instruction.GetBx();
+
+				// Jumping backwards closes a while loop, the jit may run it to its end
+				if (jit != nullptr && pc <= &instruction)
+				{
+					pc = code + jit->BackEdge(GetFunctionIndex(function), instruction.GetBx(), (uint32_t) (&instruction - code), registers);
+				}
+				break;
+			case OpCode::JumpIfFalse:
+			{
+				const Value& condition = registers[instruction.a];
+				if (condition.GetType() != TokenType::Bool && instruction.extra != 0)
+				{
+					static const char* expressions[] = { "", "an if", "a while", "a do while" };
+					Fail(instruction, "Expression from %s needs to be a boolean result", expressions[instruction.extra]);
+				}
+
+				if (!condition.GetBool())
+				{
+					pc = code + instruction.GetBx();
+				}
+				break;
+			}
+			case OpCode::NewArray:
+			{
+				std::vector<Value> values;
+				values.reserve(instruction.c);
+				for (uint16_t i = 0; i < instruction.c; i++)
+				{
+					values.push_back(std::move(registers[instruction.b + i]));
+				}
+
+				registers[instruction.a] = Value((TokenType) instruction.extra, std::move(values));
+				break;
+			}
+			case OpCode::CheckElementType:
+			{
+				TokenType elementType = GetArrayElementType((TokenType) instruction.extra);
+				if (registers[instruction.a].GetType() != elementType)
+				{
+					Fail(instruction, "Values of array variable '%s' need to be of type '%s', but one is '%s'",
+						GetName(instruction).c_str(), Helper::ToString(elementType).c_str(), Helper::ToString(registers[instruction.a].GetType()).c_str());
+				}
+				break;
+			}
+			case OpCode::GetElement:
+			case OpCode::GetGlobalElement:
+			{
+				const Value& array = instruction.opCode == OpCode::GetElement ? registers[instruction.b] : this->globals[instruction.b];
+				unsigned int index = (unsigned int) registers[instruction.c].GetInt();
+				if (index >= array.GetArraySize())
+				{
+					Fail(instruction, "Array index %i is higher than the max array index of %i", index, array.GetArraySize() - 1);
+				}
+
+				registers[instruction.a] = array.GetArrayElement(index);
+				break;
+			}
+			case OpCode::SetElement:
+			case OpCode::SetGlobalElement:
+			{
+				Value& array = instruction.opCode == OpCode::SetElement ? registers[instruction.a] : this->globals[instruction.a];
+				unsigned int index = (unsigned int) registers[instruction.b].GetInt();
+				const Value& value = registers[instruction.c];
+
+				if (value.GetType() != GetArrayElementType(array.GetType()))
+				{
+					Fail(instruction, "New value of array variable '%s' needs to be of type '%s', but is '%s'",
+						GetName(instruction).c_str(), Helper::ToString(array.GetType()).c_str(), Helper::ToString(value.GetType()).c_str());
+				}
+
+				if (index >= array.GetArraySize())
+				{
+					Fail(instruction, "Array index %i is higher than the max array index of %i", index, array.GetArraySize() - 1);
+				}
+
+				array.SetArrayElement(index, value);
+				break;
+			}
+			case OpCode::ForEachPrepare:
+			{
+				const Value& array = registers[instruction.a];
+				if (!IsVariableArrayType(array.GetType()))
+				{
+					Fail(instruction, "For loop can only loop over arrays, but in type is '%s'", Helper::ToString(array.GetType()).c_str());
+				}
+
+				if (array.GetArraySize() == 0)
+				{
+					pc = code + instruction.GetBx();
+					break;
+				}
+
+				registers[instruction.a + 1] = Value(1);
+				registers[instruction.a + 2] = array.GetArrayElement(0);
+				break;
+			}
+			case OpCode::ForEachLoop:
+			{
+				const Value& array = registers[instruction.a];
+				int index = registers[instruction.a + 1].GetInt();
+				if ((size_t) index < array.GetArraySize())
+				{
+					registers[instruction.a + 1] = Value(index + 1);
+					registers[instruction.a + 2] = array.GetArrayElement(index);
+					pc = code + instruction.GetBx();
+				}
+				break;
+			}
+			case OpCode::ForIPrepare:
+				if (registers[instruction.a].GetInt() < registers[instruction.a + 1].GetInt())
+				{
+					registers[instruction.a + 3] = registers[instruction.a];
+				}
+				else
+				{
+					pc = code + instruction.GetBx();
+				}
+				break;
+			case OpCode::ForILoop:
+			{
+				int i = WrappingPlus<int>()(registers[instruction.a].GetInt(), registers[instruction.a + 2].GetInt());
+				registers[instruction.a] = Value(i);
+				if (i < registers[instruction.a + 1].GetInt())
+				{
+					registers[instruction.a + 3] = Value(i);
+					pc = code + instruction.GetBx();
+
+					if (jit != nullptr)
+					{
+						pc = code + jit->BackEdge(GetFunctionIndex(function), instruction.GetBx(), (uint32_t) (&instruction - code), registers);
+					}
+				}
+				break;
+			}
+			case OpCode::Interpolate:
+			{
+				std::string value = registers[instruction.a].GetString();
+				for (uint16_t i = 0; i < instruction.c; i++)
+				{
+					size_t index = value.find("$R$");
+					value.replace(index, 3, Iona::ToStringInternal(registers[instruction.b + i]));
+				}
+
+				registers[instruction.a] = Value(std::move(value));
+				break;
+			}
+			case OpCode::Call:
+			{
+				const BytecodeFunction* callee = &this->program->functions[instruction.b];
+				if (instruction.c != callee->parameterCount)
+				{
+					Fail(instruction, "Function call parameter count (%i) is not matching expected parameter count (%i) of function '%s'",
+						instruction.c, callee->parameterCount, callee->name.c_str());
+				}
+
+				// The first frame executes the global variables, the others are iona functions
+				if (this->frames.size() > this->maxCallDepth)
+				{
+					Fail(instruction, "Maximum call depth of %zu exceeded by a call of function '%s'", this->maxCallDepth, callee->name.c_str());
+				}
+
+				if (jit != nullptr)
+				{
+					jit->Invoke(instruction.b);
+				}
+
+				this->frames.back().pc = pc;
+
+				// The arguments are already in place as the first registers of the called function
+				size_t base = this->frames.back().base + instruction.a;
+				if (this->stack.size() < base + callee->registerCount)
+				{
+					this->stack.resize(std::max(this->stack.size() * 2, base + callee->registerCount));
+				}
+
+				this->frames.push_back({ callee, nullptr, base });
+
+				function = callee;
+				registers = this->stack.data() + base;
+				code = function->code.data();
+				pc = code;
+				break;
+			}
+			case OpCode::TailCall:
+			{
+				const BytecodeFunction* callee = &this->program->functions[instruction.b];
+				if (instruction.c != callee->parameterCount)
+				{
+					Fail(instruction, "Function call parameter count (%i) is not matching expected parameter count (%i) of function '%s'",
+						instruction.c, callee->parameterCount, callee->name.c_str());
+				}
+
+				// The arguments become the first registers of the frame, the rest of it is released
+				for (uint16_t i = 0; i < instruction.c && instruction.a != 0; i++)
+				{
+					registers[i] = std::move(registers[instruction.a + i]);
+				}
+
+				for (uint16_t i = instruction.c; i < function->registerCount; i++)
+				{
+					registers[i] = Value();
+				}
+
+				CallFrame& frame = this->frames.back();
+				if (this->stack.size() < frame.base + callee->registerCount)
+				{
+					this->stack.resize(std::max(this->stack.size() * 2, frame.base + callee->registerCount));
+				}
+
+				frame.function = callee;
+
+				if (jit != nullptr)
+				{
+					jit->Invoke(instruction.b);
+				}
+
+				function = callee;
+				registers = this->stack.data() + frame.base;
+				code = function->code.data();
+				pc = code;
+				break;
+			}
+			case OpCode::CallInternal:
+			{
+				// The argument registers are temporary, so they can be moved
+				for (uint16_t i = 0; i < instruction.c; i++)
+				{
+					this->arguments.push_back(std::move(registers[instruction.a + i]));
+				}
+
+				Value out;
+				const FunctionEntry& entry = *this->resolvedInternalFunctions[instruction.b];
+
+				if (instruction.extra)
+				{
+					entry.function(this->arguments, out);
+				}
+				else
+				{
+					FunctionRegistry::Call(this->program->fileName, function->infos[&instruction - code].line,
+						this->program->internalFunctions[instruction.b], entry, this->arguments, out);
+				}
+
+				this->arguments.clear();
+				registers[instruction.a] = std::move(out);
+				break;
+			}
+			case OpCode::Return:
+			case OpCode::ReturnNone:
+			{
+				Value result;
+				if (instruction.opCode == OpCode::Return)
+				{
+					result = std::move(registers[instruction.a]);
+				}
+
+				// Release the values of the frame, so strings and arrays are not kept alive
+				for (uint16_t i = 0; i < function->registerCount; i++)
+				{
+					registers[i] = Value();
+				}
+
+				this->frames.pop_back();
+				if (this->frames.empty())
+				{
+					return;
+				}
+
+				// The result is written to the register the function was called with
+				registers[0] = std::move(result);
+
+				const CallFrame& frame = this->frames.back();
+				function = frame.function;
+				registers = this->stack.data() + frame.base;
+				code = function->code.data();
+				pc = frame.pc;
+				break;
+			}
+		}
+	}
+}
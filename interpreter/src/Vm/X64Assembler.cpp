@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2020 Philip "zixoan" and individual contributors.
+ * Subject to the GNU GPLv3 license. See LICENSE file for more information.
+ *
+ * SPDX-License-Identifier:	GPL-3.0-only
+ */
+
+#include "Vm/X64Assembler.h"
+#include <cstring>
+
+void X64Assembler::Byte(uint8_t value)
+{
+	this->code.push_back(value);
+}
+
+void X64Assembler::Int32(int32_t value)
+{
+	uint8_t bytes[4];
+	std::memcpy(bytes, &value, sizeof(bytes));
+	this->code.insert(this->code.end(), bytes, bytes + sizeof(bytes));
+}
+
+void X64Assembler::Memory(uint8_t reg, X64Register base, int32_t displacement)
+{
+	// ModRM with mod 10: [base + disp32]
+	Byte(0x80 | (reg << 3) | (uint8_t) base);
+	Int32(displacement);
+}
+
+void X64Assembler::Load32(X64Register destination, X64Register base, int32_t displacement)
+{
+	Byte(0x8B);
+	Memory((uint8_t) destination, base, displacement);
+}
+
+void X64Assembler::Load64(X64Register destination, X64Register base, int32_t displacement)
+{
+	Byte(0x48);
+	Byte(0x8B);
+	Memory((uint8_t) destination, base, displacement);
+}
+
+void X64Assembler::Store32(X64Register base, int32_t displacement, X64Register source)
+{
+	Byte(0x89);
+	Memory((uint8_t) source, base, displacement);
+}
+
+void X64Assembler::Store8(X64Register base, int32_t displacement, X64Register source)
+{
+	Byte(0x88);
+	Memory((uint8_t) source, base, displacement);
+}
+
+void X64Assembler::StoreImmediate32(X64Register base, int32_t displacement, int32_t value)
+{
+	Byte(0xC7);
+	Memory(0, base, displacement);
+	Int32(value);
+}
+
+void X64Assembler::StoreImmediate8(X64Register base, int32_t displacement, uint8_t value)
+{
+	Byte(0xC6);
+	Memory(0, base, displacement);
+	Byte(value);
+}
+
+void X64Assembler::LoadIndexed32(X64Register destination, X64Register base, X64Register index)
+{
+	// ModRM with a SIB byte, scale 4
+	Byte(0x8B);
+	Byte(((uint8_t) destination << 3) | 0x04);
+	Byte(0x80 | ((uint8_t) index << 3) | (uint8_t) base);
+}
+
+void X64Assembler::StoreIndexed32(X64Register base, X64Register index, X64Register source)
+{
+	Byte(0x89);
+	Byte(((uint8_t) source << 3) | 0x04);
+	Byte(0x80 | ((uint8_t) index << 3) | (uint8_t) base);
+}
+
+void X64Assembler::MoveImmediate32(X64Register destination, int32_t value)
+{
+	Byte(0xB8 + (uint8_t) destination);
+	Int32(value);
+}
+
+void X64Assembler::Arithmetic32(X64Arithmetic operation, X64Register destination, X64Register base, int32_t displacement)
+{
+	Byte((uint8_t) operation);
+	Memory((uint8_t) destination, base, displacement);
+}
+
+void X64Assembler::Multiply32(X64Register destination, X64Register base, int32_t displacement)
+{
+	Byte(0x0F);
+	Byte(0xAF);
+	Memory((uint8_t) destination, base, displacement);
+}
+
+void X64Assembler::AddImmediate32(X64Register destination, int32_t value)
+{
+	Byte(0x81);
+	Byte(0xC0 | (uint8_t) destination);
+	Int32(value);
+}
+
+void X64Assembler::CompareImmediate8(X64Register left, int8_t value)
+{
+	Byte(0x83);
+	Byte(0xF8 | (uint8_t) left);
+	Byte((uint8_t) value);
+}
+
+void X64Assembler::CompareMemoryImmediate8(X64Register base, int32_t displacement, uint8_t value)
+{
+	Byte(0x80);
+	Memory(7, base, displacement);
+	Byte(value);
+}
+
+void X64Assembler::SignExtend()
+{
+	Byte(0x99);
+}
+
+void X64Assembler::Divide32(X64Register divisor)
+{
+	Byte(0xF7);
+	Byte(0xF8 | (uint8_t) divisor);
+}
+
+void X64Assembler::SetCondition(X64Condition condition, X64Register destination)
+{
+	Byte(0x0F);
+	Byte(0x90 | (uint8_t) condition);
+	Byte(0xC0 | (uint8_t) destination);
+}
+
+void X64Assembler::And8(X64Register destination, X64Register source)
+{
+	Byte(0x20);
+	Byte(0xC0 | ((uint8_t) source << 3) | (uint8_t) destination);
+}
+
+void X64Assembler::Or8(X64Register destination, X64Register source)
+{
+	Byte(0x08);
+	Byte(0xC0 | ((uint8_t) source << 3) | (uint8_t) destination);
+}
+
+void X64Assembler::LoadFloat(uint8_t destination, X64Register base, int32_t displacement)
+{
+	Byte(0xF3);
+	Byte(0x0F);
+	Byte(0x10);
+	Memory(destination, base, displacement);
+}
+
+void X64Assembler::StoreFloat(X64Register base, int32_t displacement, uint8_t source)
+{
+	Byte(0xF3);
+	Byte(0x0F);
+	Byte(0x11);
+	Memory(source, base, displacement);
+}
+
+void X64Assembler::FloatArithmetic(X64Arithmetic operation, uint8_t destination, X64Register base, int32_t displacement)
+{
+	Byte(0xF3);
+	Byte(0x0F);
+	Byte((uint8_t) operation);
+	Memory(destination, base, displacement);
+}
+
+void X64Assembler::FloatArithmetic(X64Arithmetic operation, uint8_t destination, uint8_t source)
+{
+	Byte(0xF3);
+	Byte(0x0F);
+	Byte((uint8_t) operation);
+	Byte(0xC0 | (destination << 3) | source);
+}
+
+void X64Assembler::CompareFloat(uint8_t left, X64Register base, int32_t displacement)
+{
+	// ucomiss
+	Byte(0x0F);
+	Byte(0x2E);
+	Memory(left, base, displacement);
+}
+
+void X64Assembler::MoveToFloat(uint8_t destination, X64Register source)
+{
+	Byte(0x66);
+	Byte(0x0F);
+	Byte(0x6E);
+	Byte(0xC0 | (destination << 3) | (uint8_t) source);
+}
+
+size_t X64Assembler::Jump()
+{
+	Byte(0xE9);
+	Int32(0);
+	return this->code.size() - 4;
+}
+
+size_t X64Assembler::JumpIf(X64Condition condition)
+{
+	Byte(0x0F);
+	Byte(0x80 | (uint8_t) condition);
+	Int32(0);
+	return this->code.size() - 4;
+}
+
+void X64Assembler::Patch(size_t position, size_t target)
+{
+	// Relative to the end of the rel32 operand
+	int32_t relative = (int32_t) (target - (position + 4));
+	std::memcpy(this->code.data() + position, &relative, sizeof(relative));
+}
+
+void X64Assembler::Return()
+{
+	Byte(0xC3);
+}
@@ -8,44 +8,159 @@
 #include <fstream>
 #include <filesystem>
 #include <SemanticAnalyzer.h>
+#include "FileTable.h"
+#include "FunctionLoader.h"
 #include "Lexer.h"
+#include "MappedFile.h"
 #include "Parser.h"
 #include "Interpreter.h"
+#include "Optimizer.h"
+#include "AstPrinter.h"
 #include "Standard.h"
+#include "Vm/BytecodeCompiler.h"
+#include "Vm/VirtualMachine.h"
+#include "Vm/ProgramContainer.h"
 
 int main(int argc, char const* argv[])
 {
-	if (argc > 1)
+	// Options are given before the source file, eg. 'ionai --engine=vm -O0 Main.ion'
+	int fileIndex = 1;
+	// The tree walker runs source files by default, compiled programs always run on the virtual machine
+	std::string engine;
+	bool optimize = true;
+	bool dumpAst = false;
+	bool stats = false;
+	// The tree walker parses function bodies on their first call, eager parses and analyzes all of them before
+	// running, so errors in functions which are not called are reported as well
+	bool eager = false;
+	// The virtual machine compiles hot loops, disabling it helps to compare results
+	bool jit = true;
+	// Zero keeps the default of the engine
+	int maxCallDepth = 0;
+	for (; fileIndex < argc && Helper::StartsWith(argv[fileIndex], "-"); fileIndex++)
 	{
-		if (!Helper::EndsWith(argv[1], ".ion") && !Helper::EndsWith(argv[1], ".iona"))
+		std::string option = argv[fileIndex];
+
+		if (option == "--engine=tree" || option == "--engine=vm")
+		{
+			engine = option.substr(9);
+		}
+		else if (option == "-O0" || option == "-O1")
+		{
+			optimize = option == "-O1";
+		}
+		else if (option == "--dump-ast")
 		{
-			std::cout << "Source files for iona must end with '.ion' or '.iona' ('" << argv[1] << "')" << std::endl;
+			dumpAst = true;
+		}
+		else if (option == "--stats")
+		{
+			stats = true;
+		}
+		else if (option == "--eager")
+		{
+			eager = true;
+		}
+		else if (option == "--no-jit")
+		{
+			jit = false;
+		}
+		else if (Helper::StartsWith(option, "--max-call-depth="))
+		{
+			if (!ParsePositive(std::string_view(option).substr(17), maxCallDepth))
+			{
+				std::cout << "Maximum call depth needs to be a positive number ('" << option << "')" << std::endl;
+				return EXIT_FAILURE;
+			}
+		}
+		else
+		{
+			std::cout << "Unknown option '" << option << "', supported are '--engine=tree', '--engine=vm', '-O0', '-O1', '--dump-ast', '--stats', '--eager', '--no-jit' and '--max-call-depth=<n>'" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (argc > fileIndex)
+	{
+		const char* fileName = argv[fileIndex];
+
+		// Programs compiled by ionac are loaded without lexing, parsing and analyzing them
+		bool container = Helper::EndsWith(fileName, ProgramContainer::Extension);
+
+		if (!container && !Helper::EndsWith(fileName, ".ion") && !Helper::EndsWith(fileName, ".iona"))
+		{
+			std::cout << "Source files for iona must end with '.ion', '.iona' or '" << ProgramContainer::Extension << "' ('" << fileName << "')" << std::endl;
 			return EXIT_SUCCESS;
 		}
 
-		if (!std::filesystem::exists(argv[1]))
+		// Only the virtual machine keeps its call frames on the heap
+		if (!container && engine != "vm" && maxCallDepth > Interpreter::MaxCallDepth)
+		{
+			std::cout << "Maximum call depth of the tree walking interpreter is " << Interpreter::MaxCallDepth
+				<< ", deeper recursion needs '--engine=vm' ('--max-call-depth=" << maxCallDepth << "')" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		if (!std::filesystem::exists(fileName))
 		{
-			std::cout << "Source file '" << argv[1] << "' does not exist" << std::endl;
+			std::cout << "Source file '" << fileName << "' does not exist" << std::endl;
 			return EXIT_SUCCESS;
 		}
 
 		std::vector<std::string> args;
 		args.reserve(argc);
-		for (size_t i = 1; i < argc; i++)
+		for (int i = fileIndex; i < argc; i++)
 		{
 			args.emplace_back(argv[i]);
 		}
 
-		std::ifstream in(argv[1]);
-		std::string source;
-		std::string line;
-		while (std::getline(in, line))
+		if (container)
+		{
+			if (dumpAst || engine == "tree")
+			{
+				std::cout << "Compiled programs do not contain the ast, they can only be run with '--engine=vm' ('" << fileName << "')" << std::endl;
+				return EXIT_FAILURE;
+			}
+
+			try
+			{
+				VirtualMachine virtualMachine(args, ProgramContainer::Load(fileName));
+				if (maxCallDepth > 0)
+				{
+					virtualMachine.SetMaxCallDepth(maxCallDepth);
+				}
+				virtualMachine.SetJit(jit);
+				virtualMachine.Run();
+
+				if (stats && virtualMachine.GetJit() != nullptr)
+				{
+					const Jit& compiled = *virtualMachine.GetJit();
+					std::cout << "Jit: " << compiled.GetCompiledLoops() << " loops compiled, " << compiled.GetEntries() << " entries, "
+						<< compiled.GetDeoptimizations() << " deoptimizations" << std::endl;
+				}
+				return EXIT_SUCCESS;
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << e.what() << std::endl;
+
+				return EXIT_FAILURE;
+			}
+		}
+
+		// The lexer reads the mapped file directly, its tokens point into it
+		MappedFile source(fileName);
+		if (!source.IsValid())
 		{
-			source.append(line).append("\n");
+			std::cout << "Source file '" << fileName << "' could not be read" << std::endl;
+			return EXIT_FAILURE;
 		}
 
-		Lexer lexer(source, "Main.ion");
+		Lexer lexer(source.GetContent(), "Main.ion");
 		Parser parser(lexer);
+		// The virtual machine and the ast dump need every function body
+		bool lazyFunctions = !eager && !dumpAst && engine != "vm";
+		parser.SetLazyFunctions(lazyFunctions);
 
 		try
 		{
@@ -59,13 +174,74 @@ int main(int argc, char const* argv[])
                      std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(),
                      std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
 
-            Ref<SemanticAnalyzer> semanticAnalyzer = std::make_shared<SemanticAnalyzer>(args, astRoot);
+            Ref<SemanticAnalyzer> semanticAnalyzer = std::make_shared<SemanticAnalyzer>(astRoot);
 
             semanticAnalyzer->Analyze();
 
-            Ref<Interpreter> interpreter = std::make_shared<Interpreter>(args, astRoot);
+			// Folds constants and removes unreachable branches, -O0 executes the ast as it was parsed
+			if (optimize)
+			{
+				Optimizer optimizer(astRoot, parser.GetArena());
+				optimizer.Optimize();
+			}
 
-			interpreter->Interpret();
+			if (dumpAst)
+			{
+				AstPrinter printer(astRoot, std::cout);
+				printer.Print();
+
+				return EXIT_SUCCESS;
+			}
+
+			// The tree walking interpreter stays available to compare results with the virtual machine
+			if (engine == "vm")
+			{
+				Ref<BytecodeCompiler> compiler = std::make_shared<BytecodeCompiler>(astRoot);
+
+				VirtualMachine virtualMachine(args, compiler->Compile());
+				if (maxCallDepth > 0)
+				{
+					virtualMachine.SetMaxCallDepth(maxCallDepth);
+				}
+				virtualMachine.SetJit(jit);
+				virtualMachine.Run();
+
+				if (stats && virtualMachine.GetJit() != nullptr)
+				{
+					const Jit& compiled = *virtualMachine.GetJit();
+					std::cout << "Jit: " << compiled.GetCompiledLoops() << " loops compiled, " << compiled.GetEntries() << " entries, "
+						<< compiled.GetDeoptimizations() << " deoptimizations" << std::endl;
+				}
+			}
+			else
+			{
+				Ref<Interpreter> interpreter = std::make_shared<Interpreter>(args, astRoot);
+				if (maxCallDepth > 0)
+				{
+					interpreter->SetMaxCallDepth(maxCallDepth);
+				}
+
+				Ref<FunctionLoader> functionLoader;
+				if (lazyFunctions)
+				{
+					functionLoader = std::make_shared<FunctionLoader>(astRoot, parser.GetArena(), semanticAnalyzer, optimize);
+					interpreter->SetFunctionLoader(functionLoader);
+				}
+
+				interpreter->Interpret();
+
+				// Inline caches are only used by the tree walking interpreter
+				if (stats)
+				{
+					std::cout << "Inline caches: " << interpreter->GetInlineCacheHits() << " hits, "
+						<< interpreter->GetInlineCacheMisses() << " misses" << std::endl;
+
+					if (functionLoader != nullptr)
+					{
+						std::cout << "Lazy functions: " << functionLoader->GetLoadedFunctions() << " loaded" << std::endl;
+					}
+				}
+			}
 			return EXIT_SUCCESS;
 		}
 		catch (const std::exception& e)
@@ -75,14 +251,14 @@ int main(int argc, char const* argv[])
 			return EXIT_FAILURE;
 		}
 	}
-	else if (argc == 1)
+	else
 	{
 		std::cout << "Started iona in interactive mode" << std::endl;
 		std::cout << "Start typing code:" << std::endl;
 
 		std::vector<std::string> args;
 		args.reserve(argc);
-		for (size_t i = 1; i < argc; i++)
+		for (int i = fileIndex; i < argc; i++)
 		{
 			args.emplace_back(argv[i]);
 		}
@@ -90,6 +266,7 @@ int main(int argc, char const* argv[])
 
 		Ref<ScopedSymbolTable> globalSemanticAnalyzerScope = std::make_shared<ScopedSymbolTable>("global", 0, nullptr);
 		Ref<InterpreterScope> globalInterpreterScope = std::make_shared<InterpreterScope>();
+		uint32_t consoleFileId = FileTable::Intern("console");
 
 		while (true)
 		{
@@ -109,23 +286,26 @@ int main(int argc, char const* argv[])
 
 			try
 			{
-				Lexer lexer(line, "console");
+				Lexer lexer(line, consoleFileId);
 				Parser parser(lexer);
 
 				auto statement = parser.Statement();
 
-				Ref<SemanticAnalyzer> semanticAnalyzer = std::make_shared<SemanticAnalyzer>(args, statement, globalSemanticAnalyzerScope);
+				Ref<SemanticAnalyzer> semanticAnalyzer = std::make_shared<SemanticAnalyzer>(statement, globalSemanticAnalyzerScope);
 				semanticAnalyzer->Analyze();
 
+				// Variables of previous lines could have been declared without being assigned, because of an error
+				globalInterpreterScope->Resize(globalSemanticAnalyzerScope->GetFrameSize());
+
 				Ref<Interpreter> interpreter = std::make_shared<Interpreter>(args, statement, globalInterpreterScope);
 
-				statement->Accept(interpreter);
+				statement->Accept(*interpreter);
 
 				// Auto print variable statements
-				if (IsVariableType(interpreter->GetCurrentVariable().type))
+				if (IsVariableType(interpreter->GetCurrentVariable().GetType()))
 				{
-					VariableType vt;
-					std::vector<VariableType> inParams = { interpreter->GetCurrentVariable() };
+					Value vt;
+					std::vector<Value> inParams = { interpreter->GetCurrentVariable() };
 					Iona::Console::WriteLine(inParams, vt);
 				}
 				continue;